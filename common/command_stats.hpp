@@ -0,0 +1,201 @@
+#pragma once
+
+#include <libpldm/base.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <compare>
+#include <cstdint>
+#include <map>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+namespace stats
+{
+
+/** @class CommandStats
+ *
+ *  Request counters and latency histograms of PLDM commands, kept per
+ *  (PLDM type, PLDM command, MCTP EID). pldmd keeps one instance for the
+ *  commands it responds to and one for the commands it sends as a requester.
+ *  The latency is recorded in microseconds in log2 buckets, bucket 0 counts
+ *  the latencies below 1us and bucket N the latencies in [2^(N-1), 2^N) us,
+ *  the last bucket accumulates everything above.
+ *
+ *  The stats are not thread safe, they are updated and read on the PLDM
+ *  daemon's event loop.
+ */
+class CommandStats
+{
+  public:
+    /** @brief Number of latency histogram buckets, the last bucket starts at
+     *         2^22 us (~4s) which covers the request timeouts
+     */
+    static constexpr size_t latencyBuckets = 24;
+
+    /** @struct Key
+     *
+     *  The commands are accounted per PLDM type, PLDM command and EID.
+     */
+    struct Key
+    {
+        uint8_t type;    //!< PLDM type
+        uint8_t command; //!< PLDM command
+        uint8_t eid;     //!< MCTP endpoint ID
+
+        auto operator<=>(const Key&) const = default;
+    };
+
+    /** @struct Entry
+     *
+     *  Counters and latency histogram of a command.
+     */
+    struct Entry
+    {
+        uint64_t count = 0;          //!< number of commands, incl. timeouts
+        uint64_t errors = 0;         //!< responses with a non success cc
+        uint64_t timeouts = 0;       //!< requests without a response
+        uint64_t totalLatencyUs = 0; //!< sum of the latencies
+        uint64_t maxLatencyUs = 0;   //!< worst latency
+        std::array<uint64_t, latencyBuckets> histogram{}; //!< latencies
+    };
+
+    using Entries = std::map<Key, Entry>;
+
+    /** @brief Stats of the commands handled by the PLDM responder */
+    static CommandStats& getResponderStats()
+    {
+        static CommandStats stats;
+        return stats;
+    }
+
+    /** @brief Stats of the commands sent by the PLDM requester */
+    static CommandStats& getRequesterStats()
+    {
+        static CommandStats stats;
+        return stats;
+    }
+
+    /** @brief Account a completed command
+     *
+     *  @param[in] type - PLDM type
+     *  @param[in] command - PLDM command
+     *  @param[in] eid - MCTP endpoint ID
+     *  @param[in] completionCode - completion code of the response
+     *  @param[in] latency - time from the request to the response
+     */
+    void record(uint8_t type, uint8_t command, uint8_t eid,
+                uint8_t completionCode,
+                std::chrono::steady_clock::duration latency)
+    {
+        auto& entry = account(type, command, eid, latency);
+        if (completionCode != PLDM_SUCCESS)
+        {
+            ++entry.errors;
+        }
+    }
+
+    /** @brief Account a request that was not answered
+     *
+     *  @param[in] type - PLDM type
+     *  @param[in] command - PLDM command
+     *  @param[in] eid - MCTP endpoint ID
+     *  @param[in] latency - time from the request to giving up on it
+     */
+    void recordTimeout(uint8_t type, uint8_t command, uint8_t eid,
+                       std::chrono::steady_clock::duration latency)
+    {
+        ++account(type, command, eid, latency).timeouts;
+    }
+
+    /** @brief Get the accounted commands
+     *
+     *  @return const reference to the entries, ordered by key
+     */
+    const Entries& getEntries() const
+    {
+        return entries;
+    }
+
+    /** @brief Reset all the counters */
+    void clear()
+    {
+        entries.clear();
+    }
+
+    /** @brief Log the stats
+     *
+     *  @param[in] name - name of the stats in the log
+     */
+    void dump(const char* name) const
+    {
+        info("{NAME} command stats, {COUNT} commands", "NAME", name, "COUNT",
+             entries.size());
+        for (const auto& [key, entry] : entries)
+        {
+            info(
+                "{NAME}: TYPE={TYPE} COMMAND={CMD} EID={EID} COUNT={COUNT} ERRORS={ERRORS} TIMEOUTS={TIMEOUTS} AVG_US={AVG} MAX_US={MAX}",
+                "NAME", name, "TYPE", key.type, "CMD", key.command, "EID",
+                key.eid, "COUNT", entry.count, "ERRORS", entry.errors,
+                "TIMEOUTS", entry.timeouts, "AVG",
+                entry.count ? entry.totalLatencyUs / entry.count : 0, "MAX",
+                entry.maxLatencyUs);
+            for (size_t i = 0; i < latencyBuckets - 1; ++i)
+            {
+                if (entry.histogram[i])
+                {
+                    info("{NAME}: latency < {LIMIT}us: {COUNT}", "NAME", name,
+                         "LIMIT", (uint64_t{1} << i), "COUNT",
+                         entry.histogram[i]);
+                }
+            }
+            if (entry.histogram.back())
+            {
+                info("{NAME}: latency >= {LIMIT}us: {COUNT}", "NAME", name,
+                     "LIMIT", (uint64_t{1} << (latencyBuckets - 2)), "COUNT",
+                     entry.histogram.back());
+            }
+        }
+    }
+
+    /** @brief Get the histogram bucket of a latency
+     *
+     *  @param[in] latencyUs - latency in microseconds
+     *  @return index of the bucket
+     */
+    static size_t bucket(uint64_t latencyUs)
+    {
+        return std::min<size_t>(std::bit_width(latencyUs), latencyBuckets - 1);
+    }
+
+  private:
+    Entries entries; //!< stats per command
+
+    /** @brief Account the latency of a command
+     *
+     *  @return entry of the command
+     */
+    Entry& account(uint8_t type, uint8_t command, uint8_t eid,
+                   std::chrono::steady_clock::duration latency)
+    {
+        auto latencyUs = static_cast<uint64_t>(std::max<int64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(latency)
+                .count(),
+            0));
+        auto& entry = entries[Key{type, command, eid}];
+        ++entry.count;
+        entry.totalLatencyUs += latencyUs;
+        entry.maxLatencyUs = std::max(entry.maxLatencyUs, latencyUs);
+        ++entry.histogram[bucket(latencyUs)];
+        return entry;
+    }
+};
+
+} // namespace stats
+} // namespace pldm
@@ -0,0 +1,131 @@
+#include "config_blob.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+namespace config_blob
+{
+
+Reader::Reader(const fs::path& file)
+{
+    int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) == -1 ||
+        static_cast<size_t>(sb.st_size) < sizeof(Header))
+    {
+        close(fd);
+        return;
+    }
+    size_t blobSize = sb.st_size;
+    void* blob = mmap(nullptr, blobSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == blob)
+    {
+        error("mmap on compiled configuration failed, RC={RC}", "RC", -errno);
+        return;
+    }
+    data = static_cast<const uint8_t*>(blob);
+    size = blobSize;
+
+    // Check the whole blob once, find() then trusts the entries
+    std::memcpy(&header, data, sizeof(header));
+    bool valid = header.magic == blobMagic && header.version == blobVersion &&
+                 header.stringsOffset ==
+                     sizeof(Header) + header.entryCount * sizeof(Entry) &&
+                 header.stringsOffset <= size &&
+                 header.stringsSize <= size - header.stringsOffset;
+    for (size_t i = 0; valid && i < header.entryCount; ++i)
+    {
+        auto entry = getEntry(i);
+        valid = entry.pathOffset <= header.stringsSize &&
+                entry.pathSize <= header.stringsSize - entry.pathOffset &&
+                entry.dataOffset <= size &&
+                entry.dataSize <= size - entry.dataOffset &&
+                (i == 0 || getPath(getEntry(i - 1)) < getPath(entry));
+    }
+    if (!valid)
+    {
+        error("Compiled configuration {PATH} is not valid", "PATH",
+              file.string());
+        munmap(const_cast<uint8_t*>(data), size);
+        data = nullptr;
+        size = 0;
+    }
+}
+
+Reader::~Reader()
+{
+    if (data)
+    {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+}
+
+std::optional<std::span<const uint8_t>>
+    Reader::find(const fs::path& path, const Stamp& stamp) const
+{
+    if (empty())
+    {
+        return std::nullopt;
+    }
+
+    auto key = path.lexically_normal().string();
+    size_t first = 0;
+    size_t last = header.entryCount;
+    while (first < last)
+    {
+        auto middle = first + (last - first) / 2;
+        auto entry = getEntry(middle);
+        auto entryPath = getPath(entry);
+        if (entryPath < key)
+        {
+            first = middle + 1;
+        }
+        else if (key < entryPath)
+        {
+            last = middle;
+        }
+        else if (Stamp{entry.fileSize, entry.modified} != stamp)
+        {
+            // The JSON file changed since it was compiled
+            return std::nullopt;
+        }
+        else
+        {
+            return std::span<const uint8_t>(data + entry.dataOffset,
+                                            entry.dataSize);
+        }
+    }
+    return std::nullopt;
+}
+
+Entry Reader::getEntry(size_t index) const
+{
+    Entry entry;
+    std::memcpy(&entry, data + sizeof(Header) + index * sizeof(Entry),
+                sizeof(entry));
+    return entry;
+}
+
+std::string_view Reader::getPath(const Entry& entry) const
+{
+    return std::string_view(
+        reinterpret_cast<const char*>(data + header.stringsOffset +
+                                      entry.pathOffset),
+        entry.pathSize);
+}
+
+} // namespace config_blob
+} // namespace pldm
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pldm
+{
+namespace config_blob
+{
+namespace fs = std::filesystem;
+
+/** @brief "PLDMCFGB" */
+constexpr uint64_t blobMagic = 0x424746434d444c50;
+
+/** @brief Bumped whenever the layout of the blob changes */
+constexpr uint32_t blobVersion = 2;
+
+/** @struct Header
+ *
+ *  The header of the compiled configuration blob is followed by the entries
+ *  sorted by path, the path strings and the CBOR encodings of the JSON
+ *  files.
+ */
+struct Header
+{
+    uint64_t magic;         //!< blobMagic
+    uint32_t version;       //!< blobVersion
+    uint32_t entryCount;    //!< number of JSON files
+    uint64_t stringsOffset; //!< offset of the path strings in the blob
+    uint64_t stringsSize;   //!< size of the path strings in bytes
+};
+
+/** @struct Entry
+ *
+ *  A JSON file of the compiled configuration blob
+ */
+struct Entry
+{
+    uint64_t pathOffset; //!< offset of the installed path in the strings
+    uint64_t pathSize;   //!< size of the installed path in bytes
+    uint64_t fileSize;   //!< size of the JSON file it was compiled from
+    int64_t modified;    //!< modification time of that file, in seconds
+    uint64_t dataOffset; //!< offset of the CBOR encoding in the blob
+    uint64_t dataSize;   //!< size of the CBOR encoding in bytes
+};
+
+/** @struct Stamp
+ *
+ *  The size and modification time of a JSON file, telling whether the JSON
+ *  file installed is the one the blob was compiled from without reading it
+ */
+struct Stamp
+{
+    uint64_t fileSize; //!< size of the JSON file in bytes
+    int64_t modified;  //!< modification time of the JSON file, in seconds
+
+    bool operator==(const Stamp&) const = default;
+};
+
+/** @brief Get the stamp of a JSON file
+ *
+ *  @param[in] file - the JSON file
+ *
+ *  @return the stamp, std::nullopt if the file is missing
+ */
+inline std::optional<Stamp> getStamp(const fs::path& file)
+{
+    struct stat sb;
+    if (stat(file.c_str(), &sb) == -1)
+    {
+        return std::nullopt;
+    }
+    return Stamp{static_cast<uint64_t>(sb.st_size),
+                 static_cast<int64_t>(sb.st_mtime)};
+}
+
+/** @brief A compiled JSON file: the stamp of its source and its CBOR
+ *         encoding
+ */
+using CompiledJson = std::pair<Stamp, std::vector<uint8_t>>;
+
+/** @brief Lay out the compiled configuration blob
+ *
+ *  @param[in] jsons - compiled JSON files by installed path
+ *
+ *  @return the blob
+ */
+inline std::vector<uint8_t>
+    build(const std::map<std::string, CompiledJson>& jsons)
+{
+    Header header{};
+    header.magic = blobMagic;
+    header.version = blobVersion;
+    header.entryCount = jsons.size();
+    header.stringsOffset = sizeof(Header) + jsons.size() * sizeof(Entry);
+
+    std::string strings;
+    std::vector<Entry> entries;
+    entries.reserve(jsons.size());
+    for (const auto& [path, json] : jsons)
+    {
+        Entry entry{};
+        entry.pathOffset = strings.size();
+        entry.pathSize = path.size();
+        entry.fileSize = json.first.fileSize;
+        entry.modified = json.first.modified;
+        entry.dataSize = json.second.size();
+        strings += path;
+        entries.emplace_back(entry);
+    }
+    header.stringsSize = strings.size();
+
+    uint64_t dataOffset = header.stringsOffset + header.stringsSize;
+    for (auto& entry : entries)
+    {
+        entry.dataOffset = dataOffset;
+        dataOffset += entry.dataSize;
+    }
+
+    std::vector<uint8_t> blob(dataOffset);
+    std::memcpy(blob.data(), &header, sizeof(header));
+    if (!entries.empty())
+    {
+        std::memcpy(blob.data() + sizeof(header), entries.data(),
+                    entries.size() * sizeof(Entry));
+    }
+    std::memcpy(blob.data() + header.stringsOffset, strings.data(),
+                strings.size());
+    auto entry = entries.begin();
+    for (const auto& [path, json] : jsons)
+    {
+        std::memcpy(blob.data() + entry->dataOffset, json.second.data(),
+                    json.second.size());
+        ++entry;
+    }
+    return blob;
+}
+
+/** @class Reader
+ *
+ *  Memory-mapped compiled configuration blob, built from the configuration
+ *  JSONs by pldm-config-compiler
+ */
+class Reader
+{
+  public:
+    Reader() = delete;
+    Reader(const Reader&) = delete;
+    Reader(Reader&&) = delete;
+    Reader& operator=(const Reader&) = delete;
+    Reader& operator=(Reader&&) = delete;
+
+    /** @brief Constructor, the reader is empty if the blob is missing or
+     *         not valid
+     *
+     *  @param[in] file - the blob
+     */
+    explicit Reader(const fs::path& file);
+
+    ~Reader();
+
+    /** @brief Find the CBOR encoding of a JSON file
+     *
+     *  @param[in] path - installed path of the JSON file
+     *  @param[in] stamp - getStamp of the JSON file as installed
+     *
+     *  @return the CBOR encoding, std::nullopt if the JSON file is not in
+     *          the blob or was compiled from a file with another stamp
+     */
+    std::optional<std::span<const uint8_t>> find(const fs::path& path,
+                                                 const Stamp& stamp) const;
+
+    /** @brief Check whether a blob is mapped
+     *
+     *  @return true if there is no blob
+     */
+    bool empty() const
+    {
+        return data == nullptr;
+    }
+
+  private:
+    const uint8_t* data = nullptr; //!< the mapped blob
+    size_t size = 0;               //!< size of the blob in bytes
+    Header header{};               //!< header of the blob
+
+    /** @brief Get an entry of the blob
+     *
+     *  @param[in] index - index of the entry
+     *
+     *  @return the entry
+     */
+    Entry getEntry(size_t index) const;
+
+    /** @brief Get the installed path of an entry
+     *
+     *  @param[in] entry - the entry
+     *
+     *  @return the installed path
+     */
+    std::string_view getPath(const Entry& entry) const;
+};
+
+} // namespace config_blob
+} // namespace pldm
@@ -1,11 +1,16 @@
 #pragma once
 
-#include <common/utils.hpp>
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
 #include <fstream>
-#include <iomanip>
-#include <iostream>
+#include <memory>
+#include <span>
 #include <vector>
 
 PHOSPHOR_LOG2_USING;
@@ -15,36 +20,92 @@ namespace pldm
 namespace flightrecorder
 {
 using ReqOrResponse = bool;
-using FlightRecorderData = std::vector<uint8_t>;
-using FlightRecorderTimeStamp = std::string;
-using FlightRecorderRecord =
-    std::tuple<FlightRecorderTimeStamp, ReqOrResponse, FlightRecorderData>;
-using FlightRecorderCassette = std::vector<FlightRecorderRecord>;
 static constexpr auto flightRecorderDumpPath = "/tmp/pldm_flight_recorder";
 
+/** @brief Magic at the start of the flight recorder dump file */
+static constexpr char dumpMagic[8] = {'P', 'L', 'D', 'M', 'F', 'R', 'E', 'C'};
+
+/** @brief Version of the flight recorder dump file format */
+static constexpr uint32_t dumpVersion = 1;
+
+/** @struct DumpHeader
+ *
+ *  Header of the flight recorder dump file, it is followed by numRecords
+ *  records, each a DumpRecord followed by its captured message bytes. All the
+ *  fields are in host byte order.
+ */
+struct DumpHeader
+{
+    char magic[8];            //!< dumpMagic
+    uint32_t version;         //!< dumpVersion
+    uint32_t slotSize;        //!< max number of bytes captured per message
+    uint64_t numRecords;      //!< number of records in the file
+    uint64_t dropped;         //!< messages not recorded due to contention
+    int64_t realtimeOffsetNs; //!< CLOCK_REALTIME - CLOCK_MONOTONIC at dump
+} __attribute__((packed));
+
+/** @struct DumpRecord
+ *
+ *  Header of a recorded message in the dump file, oldest record first.
+ */
+struct DumpRecord
+{
+    uint64_t timestampNs; //!< CLOCK_MONOTONIC time the message was recorded
+    uint32_t length;      //!< length of the message
+    uint16_t captured;    //!< number of message bytes that follow
+    uint8_t isTx;         //!< 1 for a sent message, 0 for a received one
+    uint8_t reserved;
+} __attribute__((packed));
+
 /** @class FlightRecorder
  *
- *  The class for implementing the PLDM flight recorder logic. This class
- *  handles the insertion of the data into the recorder and also provides
- *  API's to dump the flight recorder into a file.
+ *  The class for implementing the PLDM flight recorder logic. The messages are
+ *  recorded in a preallocated ring of fixed size slots, capturing up to
+ *  FLIGHT_RECORDER_SLOT_SIZE bytes of each message with a CLOCK_MONOTONIC
+ *  timestamp, so recording does not allocate or format anything. Recording is
+ *  lock-free and safe from multiple threads, a writer claims a slot with an
+ *  atomic ticket and publishes it with a per slot sequence number, the slot
+ *  contents are relaxed atomics so a dump racing a writer reads them without
+ *  a data race and discards them if the sequence number changed. The
+ *  recorder is dumped into a file in a compact binary format, see DumpHeader
+ *  and DumpRecord.
  */
 
 class FlightRecorder
 {
   private:
-    FlightRecorder() : index(0)
+    FlightRecorder() :
+        FlightRecorder(FLIGHT_RECORDER_MAX_ENTRIES, FLIGHT_RECORDER_SLOT_SIZE)
+    {}
+
+    /** @struct Slot
+     *
+     *  A recorded message, the captured bytes are kept in the data array.
+     */
+    struct Slot
     {
-        flightRecorderPolicy = FLIGHT_RECORDER_MAX_ENTRIES ? true : false;
-        if (flightRecorderPolicy)
-        {
-            tapeRecorder = FlightRecorderCassette(FLIGHT_RECORDER_MAX_ENTRIES);
-        }
-    }
+        /** @brief 0 while never written, 2 * ticket + 1 while the writer of
+         *         ticket fills the slot and 2 * (ticket + 1) once the record
+         *         of ticket is complete
+         */
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> timestampNs{0};
+        std::atomic<uint32_t> length{0};
+        std::atomic<uint16_t> captured{0};
+        std::atomic<bool> isTx{false};
+    };
+
+    /** @brief Word the captured bytes are copied by */
+    using Word = std::atomic<uint64_t>;
 
   protected:
-    int index;
-    FlightRecorderCassette tapeRecorder;
-    bool flightRecorderPolicy;
+    size_t maxEntries;               //!< number of slots in the ring
+    size_t slotSize;                 //!< bytes captured per message
+    size_t slotWords;                //!< words of captured bytes per slot
+    std::unique_ptr<Slot[]> slots;   //!< ring of slots
+    std::unique_ptr<Word[]> data;    //!< captured bytes, slotWords per slot
+    std::atomic<uint64_t> head{0};    //!< next ticket to hand out
+    std::atomic<uint64_t> dropped{0}; //!< messages lost to a busy slot
 
   public:
     FlightRecorder(const FlightRecorder&) = delete;
@@ -53,6 +114,23 @@ class FlightRecorder
     FlightRecorder& operator=(FlightRecorder&&) = delete;
     ~FlightRecorder() = default;
 
+    /** @brief Constructor
+     *
+     *  @param[in] maxEntries - number of messages kept, 0 disables recording
+     *  @param[in] slotSize - max number of bytes captured per message
+     */
+    FlightRecorder(size_t maxEntries, size_t slotSize) :
+        maxEntries(maxEntries),
+        slotSize(std::min<size_t>(slotSize, UINT16_MAX)),
+        slotWords((this->slotSize + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+    {
+        if (maxEntries)
+        {
+            slots = std::make_unique<Slot[]>(maxEntries);
+            data = std::make_unique<Word[]>(maxEntries * slotWords);
+        }
+    }
+
     static FlightRecorder& GetInstance()
     {
         static FlightRecorder flightRecorder;
@@ -67,60 +145,163 @@ class FlightRecorder
      *
      *  @return void
      */
-    void saveRecord(const FlightRecorderData& buffer, ReqOrResponse isRequest)
+    void saveRecord(std::span<const uint8_t> buffer, ReqOrResponse isRequest)
     {
         // if the flight recorder policy is enabled, then only insert the
         // messages into the flight recorder, if not this function will be just
         // a no-op
-        if (flightRecorderPolicy)
+        if (!maxEntries)
+        {
+            return;
+        }
+
+        auto ticket = head.fetch_add(1, std::memory_order_relaxed);
+        auto& slot = slots[ticket % maxEntries];
+
+        // Another writer may still be filling the slot after wrapping around
+        // the whole ring, or a writer with a newer ticket already took it
+        // while this one was delayed, drop the message rather than wait for
+        // the slot or overwrite a newer record with it
+        auto sequence = slot.sequence.load(std::memory_order_relaxed);
+        if ((sequence & 1) || sequence > 2 * ticket ||
+            !slot.sequence.compare_exchange_strong(sequence, 2 * ticket + 1,
+                                                   std::memory_order_relaxed))
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // Keeps the stores below after the odd sequence number
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto captured = std::min(buffer.size(), slotSize);
+        slot.timestampNs.store(monotonicNs(), std::memory_order_relaxed);
+        slot.length.store(
+            static_cast<uint32_t>(std::min<size_t>(buffer.size(), UINT32_MAX)),
+            std::memory_order_relaxed);
+        slot.captured.store(static_cast<uint16_t>(captured),
+                            std::memory_order_relaxed);
+        slot.isTx.store(isRequest, std::memory_order_relaxed);
+        auto words = data.get() + (ticket % maxEntries) * slotWords;
+        for (size_t offset = 0; offset < captured; offset += sizeof(uint64_t))
         {
-            int currentIndex = index++;
-            tapeRecorder[currentIndex] = std::make_tuple(
-                pldm::utils::getCurrentSystemTime(), isRequest, buffer);
-            index = (currentIndex == FLIGHT_RECORDER_MAX_ENTRIES - 1) ? 0
-                                                                      : index;
+            uint64_t word = 0;
+            std::memcpy(&word, buffer.data() + offset,
+                        std::min(captured - offset, sizeof(word)));
+            words[offset / sizeof(word)].store(word,
+                                               std::memory_order_relaxed);
         }
+
+        slot.sequence.store(2 * (ticket + 1), std::memory_order_release);
     }
 
     /** @brief play flight recorder
+     *
+     *  @param[in] path - file to dump the recorder into
      *
      *  @return void
      */
 
-    void playRecorder()
+    void playRecorder(
+        const std::filesystem::path& path = flightRecorderDumpPath)
     {
-        if (flightRecorderPolicy)
+        if (!maxEntries)
         {
-            std::ofstream recorderOutputFile(flightRecorderDumpPath);
-            info("Dumping the flight recorder into : {FLIGHT_REC_DUMP}",
-                 "FLIGHT_REC_DUMP", flightRecorderDumpPath);
+            error("Fight recorder policy is disabled");
+            return;
+        }
 
-            for (const auto& message : tapeRecorder)
+        info("Dumping the flight recorder into : {FLIGHT_REC_DUMP}",
+             "FLIGHT_REC_DUMP", path.string());
+
+        std::vector<uint8_t> records;
+        uint64_t numRecords = 0;
+        std::vector<uint8_t> captured(slotWords * sizeof(uint64_t));
+        auto end = head.load(std::memory_order_acquire);
+        auto start = end > maxEntries ? end - maxEntries : 0;
+        for (auto ticket = start; ticket < end; ++ticket)
+        {
+            const auto& slot = slots[ticket % maxEntries];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * (ticket + 1))
             {
-                recorderOutputFile << std::get<FlightRecorderTimeStamp>(message)
-                                   << " : ";
-                if (std::get<ReqOrResponse>(message))
-                {
-                    recorderOutputFile << "Tx : \n";
-                }
-                else
-                {
-                    recorderOutputFile << "Rx : \n";
-                }
-                for (const auto& word : std::get<FlightRecorderData>(message))
-                {
-                    recorderOutputFile << std::setfill('0') << std::setw(2)
-                                       << std::hex << (unsigned)word << " ";
-                }
-                recorderOutputFile << std::endl;
+                // Still being written or already overwritten
+                continue;
             }
-            recorderOutputFile.close();
+
+            DumpRecord record{};
+            record.timestampNs =
+                slot.timestampNs.load(std::memory_order_relaxed);
+            record.length = slot.length.load(std::memory_order_relaxed);
+            record.captured = std::min<uint16_t>(
+                slot.captured.load(std::memory_order_relaxed), slotSize);
+            record.isTx = slot.isTx.load(std::memory_order_relaxed);
+            auto words = data.get() + (ticket % maxEntries) * slotWords;
+            for (size_t i = 0; i * sizeof(uint64_t) < record.captured; ++i)
+            {
+                auto word = words[i].load(std::memory_order_relaxed);
+                std::memcpy(captured.data() + i * sizeof(word), &word,
+                            sizeof(word));
+            }
+
+            // Keeps the loads above before the sequence number is checked
+            // again
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+            {
+                continue;
+            }
+
+            auto bytes = reinterpret_cast<const uint8_t*>(&record);
+            records.insert(records.end(), bytes, bytes + sizeof(record));
+            records.insert(records.end(), captured.begin(),
+                           captured.begin() + record.captured);
+            ++numRecords;
         }
-        else
+
+        DumpHeader header{};
+        std::memcpy(header.magic, dumpMagic, sizeof(header.magic));
+        header.version = dumpVersion;
+        header.slotSize = static_cast<uint32_t>(slotSize);
+        header.numRecords = numRecords;
+        header.dropped = dropped.load(std::memory_order_relaxed);
+        header.realtimeOffsetNs = realtimeOffsetNs();
+
+        std::ofstream recorderOutputFile(path, std::ios::binary);
+        recorderOutputFile.write(reinterpret_cast<const char*>(&header),
+                                 sizeof(header));
+        recorderOutputFile.write(reinterpret_cast<const char*>(records.data()),
+                                 records.size());
+        if (!recorderOutputFile)
         {
-            error("Fight recorder policy is disabled");
+            error("Failed to write the flight recorder dump {PATH}", "PATH",
+                  path.string());
         }
     }
+
+  private:
+    /** @brief Get the CLOCK_MONOTONIC time
+     *
+     *  @return time in nanoseconds
+     */
+    static uint64_t monotonicNs()
+    {
+        struct timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    /** @brief Get the offset to convert CLOCK_MONOTONIC times to wall clock
+     *
+     *  @return CLOCK_REALTIME - CLOCK_MONOTONIC in nanoseconds
+     */
+    static int64_t realtimeOffsetNs()
+    {
+        struct timespec ts{};
+        clock_gettime(CLOCK_REALTIME, &ts);
+        auto realtime = static_cast<int64_t>(ts.tv_sec) * 1000000000 +
+                        ts.tv_nsec;
+        return realtime - static_cast<int64_t>(monotonicNs());
+    }
 };
 
 } // namespace flightrecorder
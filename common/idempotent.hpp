@@ -0,0 +1,45 @@
+#pragma once
+
+#include <libpldm/base.h>
+#include <libpldm/bios.h>
+#include <libpldm/fru.h>
+#include <libpldm/platform.h>
+
+#include <cstdint>
+
+namespace pldm
+{
+
+/** @brief Check if a PLDM command only reads state, so that running it once
+ *         or several times with the same request yields the same response
+ *
+ *  @param[in] type - PLDM type
+ *  @param[in] command - PLDM command
+ *  @return true if the command is idempotent
+ */
+inline bool isIdempotent(uint8_t type, uint8_t command)
+{
+    switch (type)
+    {
+        case PLDM_BASE:
+            return command == PLDM_GET_TID ||
+                   command == PLDM_GET_PLDM_VERSION ||
+                   command == PLDM_GET_PLDM_TYPES ||
+                   command == PLDM_GET_PLDM_COMMANDS;
+        case PLDM_PLATFORM:
+            return command == PLDM_GET_PDR ||
+                   command == PLDM_GET_STATE_SENSOR_READINGS ||
+                   command == PLDM_GET_NUMERIC_EFFECTER_VALUE;
+        case PLDM_BIOS:
+            return command == PLDM_GET_BIOS_TABLE ||
+                   command == PLDM_GET_BIOS_ATTRIBUTE_CURRENT_VALUE_BY_HANDLE;
+        case PLDM_FRU:
+            return command == PLDM_GET_FRU_RECORD_TABLE_METADATA ||
+                   command == PLDM_GET_FRU_RECORD_TABLE ||
+                   command == PLDM_GET_FRU_RECORD_BY_OPTION;
+        default:
+            return false;
+    }
+}
+
+} // namespace pldm
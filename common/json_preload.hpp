@@ -0,0 +1,222 @@
+#pragma once
+
+#include "common/config_blob.hpp"
+#include "common/utils.hpp"
+#include "common/worker_pool.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+namespace utils
+{
+
+/** @struct JsonPreload
+ *
+ *  Parsing of a JSON file on a worker thread, and its completion handing the
+ *  parsed JSON file over to parseJsonFile on the event loop
+ */
+struct JsonPreload
+{
+    WorkerPool::Work work;
+    WorkerPool::Completion done;
+};
+
+/** @brief Create the parsing of a JSON file ahead of time
+ *
+ *  A JSON file found in the compiled configuration blob with the same size
+ *  and modification time is decoded from its CBOR encoding, without reading
+ *  its text. A file that fails to parse is left for its handler to parse
+ *  and report.
+ *
+ *  @param[in] file - the JSON file
+ *  @param[in] blob - compiled configuration blob, if any
+ *  @param[in] loaded - invoked on the event loop once the file is parsed,
+ *                      with whether it was decoded from the blob
+ *
+ *  @return the work and its completion
+ */
+inline JsonPreload
+    makeJsonPreload(const fs::path& file,
+                    const std::shared_ptr<const config_blob::Reader>& blob,
+                    std::function<void(bool compiled)> loaded = {})
+{
+    auto json = std::make_shared<Json>();
+    auto elapsed = std::make_shared<std::chrono::microseconds>();
+    auto compiled = std::make_shared<bool>(false);
+    auto work = [file, json, elapsed, compiled, blob]() {
+        auto begin = std::chrono::steady_clock::now();
+        auto stamp = blob ? config_blob::getStamp(file) : std::nullopt;
+        auto cbor = stamp ? blob->find(file, *stamp) : std::nullopt;
+        if (cbor)
+        {
+            *json = Json::from_cbor(cbor->begin(), cbor->end(), true, false);
+            *compiled = !json->is_discarded();
+        }
+        if (!*compiled)
+        {
+            std::ifstream jsonFile(file);
+            *json = Json::parse(jsonFile, nullptr, false);
+        }
+        *elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin);
+    };
+    auto done = [file, json, elapsed, compiled, loaded]() {
+        debug(
+            "Loaded JSON file {PATH} in {DURATION_US} us, COMPILED={COMPILED}",
+            "PATH", file.string(), "DURATION_US", elapsed->count(), "COMPILED",
+            *compiled);
+        if (!json->is_discarded())
+        {
+            addPreloadedJson(file, std::move(*json));
+        }
+        if (loaded)
+        {
+            loaded(*compiled);
+        }
+    };
+    return {std::move(work), std::move(done)};
+}
+
+/** @brief Open the compiled configuration blob
+ *
+ *  @param[in] configBlob - compiled configuration blob
+ *
+ *  @return the blob, nullptr if the path is empty
+ */
+inline std::shared_ptr<const config_blob::Reader>
+    openConfigBlob(const fs::path& configBlob)
+{
+    if (configBlob.empty())
+    {
+        return nullptr;
+    }
+    return std::make_shared<const config_blob::Reader>(configBlob);
+}
+
+/** @brief Parse the configuration JSON files on the worker pool
+ *
+ *  The JSON files are parsed concurrently on the worker threads and handed
+ *  over to parseJsonFile on the event loop, the handlers then consume them
+ *  in their own order. Returns once all the files are parsed, before the
+ *  daemon starts serving requests. The JSON files the handlers did not take
+ *  are dropped with clearPreloadedJsons once they are constructed.
+ *
+ *  @param[in] workerPool - pool the JSON files are parsed on
+ *  @param[in] event - event loop the parsed JSON files are handed over on
+ *  @param[in] paths - JSON files, and directories whose JSON files are
+ *                     parsed, not recursively
+ *  @param[in] configBlob - compiled configuration blob, the JSON files are
+ *                          all parsed if empty or missing
+ */
+inline void preloadJsons(WorkerPool& workerPool, sdeventplus::Event& event,
+                         const std::vector<fs::path>& paths,
+                         const fs::path& configBlob = {})
+{
+    auto blob = openConfigBlob(configBlob);
+
+    std::vector<fs::path> files;
+    for (const auto& path : paths)
+    {
+        std::error_code ec;
+        if (fs::is_regular_file(path, ec))
+        {
+            files.emplace_back(path);
+            continue;
+        }
+        for (const auto& dirEntry : fs::directory_iterator(path, ec))
+        {
+            if (dirEntry.is_regular_file(ec))
+            {
+                files.emplace_back(dirEntry.path());
+            }
+        }
+    }
+
+    size_t compiledCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& file : files)
+    {
+        auto [work, done] = makeJsonPreload(
+            file, blob,
+            [&compiledCount](bool compiled) { compiledCount += compiled; });
+        while (!workerPool.submit(WorkerPool::Work(work),
+                                  WorkerPool::Completion(done)))
+        {
+            if (workerPool.pending() == 0)
+            {
+                // The pool does not take work at all
+                work();
+                done();
+                break;
+            }
+            event.run(std::nullopt);
+        }
+    }
+    while (workerPool.pending() > 0)
+    {
+        event.run(std::nullopt);
+    }
+
+    info(
+        "Loaded {COUNT} configuration JSON files in {DURATION_MS} ms, COMPILED={COMPILED}",
+        "COUNT", files.size(), "DURATION_MS",
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count(),
+        "COMPILED", compiledCount);
+}
+
+/** @brief Parse JSON files on the worker pool without waiting for them
+ *
+ *  Unlike preloadJsons, this returns right away and can be called from an
+ *  event loop callback. A file the pool has no room for is left for its
+ *  handler to parse.
+ *
+ *  @param[in] workerPool - pool the JSON files are parsed on
+ *  @param[in] files - the JSON files
+ *  @param[in] done - invoked on the event loop once the files are parsed
+ *  @param[in] configBlob - compiled configuration blob, the JSON files are
+ *                          all parsed if empty or missing
+ */
+inline void preloadJsonsAsync(WorkerPool& workerPool,
+                              const std::vector<fs::path>& files,
+                              std::function<void()> done,
+                              const fs::path& configBlob = {})
+{
+    auto blob = openConfigBlob(configBlob);
+
+    // Completes the preloading once the last file is parsed
+    auto pending = std::make_shared<size_t>(1);
+    auto loaded = [pending, done](bool) {
+        if (!--*pending)
+        {
+            done();
+        }
+    };
+    for (const auto& file : files)
+    {
+        auto preload = makeJsonPreload(file, blob, loaded);
+        if (workerPool.submit(std::move(preload.work),
+                              std::move(preload.done)))
+        {
+            ++*pending;
+        }
+    }
+    loaded(false);
+}
+
+} // namespace utils
+} // namespace pldm
@@ -0,0 +1,356 @@
+#pragma once
+
+#include "common/utils.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+
+namespace pldm
+{
+namespace tracer
+{
+
+/** @class PacketTracer
+ *
+ *  Asynchronous tracing of the PLDM messages sent and received by pldmd. The
+ *  messages are copied into a bounded lock-free queue and a writer thread
+ *  running with the SCHED_IDLE policy hex encodes them and writes them to
+ *  stdout in batches, so tracing does not block the event loop on journald.
+ *  Messages are dropped and counted when the queue is full or when more than
+ *  TRACE_RATE_LIMIT messages per second are traced. The messages traced can
+ *  be restricted to a set of EIDs and PLDM types.
+ */
+class PacketTracer
+{
+  public:
+    /** @brief Number of messages the queue holds */
+    static constexpr size_t queueSize = 512;
+
+    /** @brief Number of bytes traced per message, the rest is elided */
+    static constexpr size_t maxTraceBytes = 256;
+
+    PacketTracer(const PacketTracer&) = delete;
+    PacketTracer(PacketTracer&&) = delete;
+    PacketTracer& operator=(const PacketTracer&) = delete;
+    PacketTracer& operator=(PacketTracer&&) = delete;
+
+    /** @brief Constructor
+     *
+     *  @param[in] rateLimit - max number of messages traced per second
+     */
+    explicit PacketTracer(uint64_t rateLimit = TRACE_RATE_LIMIT) :
+        rateLimit(rateLimit)
+    {
+        allowAll();
+    }
+
+    ~PacketTracer()
+    {
+        if (writer.joinable())
+        {
+            stopping = true;
+            writer.join();
+        }
+    }
+
+    static PacketTracer& getInstance()
+    {
+        static PacketTracer tracer;
+        return tracer;
+    }
+
+    /** @brief Enable or disable tracing, the queue and the writer thread are
+     *         created the first time tracing is enabled
+     *
+     *  @param[in] enable - true to trace the messages
+     */
+    void enable(bool enable)
+    {
+        if (enable)
+        {
+            std::lock_guard<std::mutex> guard(startLock);
+            if (!cells)
+            {
+                cells = std::make_unique<Cell[]>(queueSize);
+                for (size_t i = 0; i < queueSize; ++i)
+                {
+                    cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+                writer = std::thread(&PacketTracer::run, this);
+            }
+        }
+        enabled.store(enable, std::memory_order_release);
+    }
+
+    /** @brief Check if tracing is enabled
+     *
+     *  @return true if the messages are traced
+     */
+    bool isEnabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Trace the messages of all the EIDs and PLDM types */
+    void allowAll()
+    {
+        for (auto& word : eidFilter)
+        {
+            word.store(~uint64_t{0}, std::memory_order_relaxed);
+        }
+        typeFilter.store(~uint64_t{0}, std::memory_order_relaxed);
+    }
+
+    /** @brief Restrict the messages traced
+     *
+     *  @param[in] eids - EIDs to trace, all the EIDs if empty
+     *  @param[in] types - PLDM types to trace, all the types if empty
+     */
+    void setFilter(std::span<const uint8_t> eids,
+                   std::span<const uint8_t> types)
+    {
+        std::array<uint64_t, 4> eidBits{};
+        for (auto eid : eids)
+        {
+            eidBits[eid / 64] |= uint64_t{1} << (eid % 64);
+        }
+        for (size_t i = 0; i < eidBits.size(); ++i)
+        {
+            eidFilter[i].store(eids.empty() ? ~uint64_t{0} : eidBits[i],
+                               std::memory_order_relaxed);
+        }
+
+        uint64_t typeBits = 0;
+        for (auto type : types)
+        {
+            typeBits |= uint64_t{1} << (type % 64);
+        }
+        typeFilter.store(types.empty() ? ~uint64_t{0} : typeBits,
+                         std::memory_order_relaxed);
+    }
+
+    /** @brief Get the number of messages dropped by the rate limit or
+     *         because the queue was full
+     *
+     *  @return number of dropped messages
+     */
+    uint64_t getDropped() const
+    {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Trace a PLDM message, a no-op unless tracing is enabled
+     *
+     *  @param[in] isTx - true for an outgoing message, false for an incoming
+     *                    message
+     *  @param[in] eid - MCTP endpoint ID of the peer
+     *  @param[in] msg - PLDM message, starting at the PLDM header
+     */
+    void trace(bool isTx, uint8_t eid, std::span<const uint8_t> msg)
+    {
+        if (!enabled.load(std::memory_order_acquire) || msg.empty())
+        {
+            return;
+        }
+
+        // The PLDM type is in the low 6 bits of the second header byte
+        uint8_t type = msg.size() > 1 ? (msg[1] & 0x3F) : 0;
+        if (!(eidFilter[eid / 64].load(std::memory_order_relaxed) &
+              (uint64_t{1} << (eid % 64))) ||
+            !(typeFilter.load(std::memory_order_relaxed) &
+              (uint64_t{1} << type)))
+        {
+            return;
+        }
+
+        if (!acquireToken())
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Bounded multi producer, single consumer queue, a producer claims a
+        // cell whose sequence matches the tail position
+        auto pos = tail.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true)
+        {
+            cell = &cells[pos % queueSize];
+            auto sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<int64_t>(sequence - pos);
+            if (diff == 0)
+            {
+                if (tail.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // Queue is full
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            else
+            {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->isTx = isTx;
+        cell->eid = eid;
+        cell->length = static_cast<uint32_t>(msg.size());
+        cell->captured =
+            static_cast<uint16_t>(std::min(msg.size(), maxTraceBytes));
+        std::memcpy(cell->data.data(), msg.data(), cell->captured);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+  private:
+    /** @struct Cell
+     *
+     *  A traced message in the queue.
+     */
+    struct Cell
+    {
+        std::atomic<uint64_t> sequence{0}; //!< queue position of the cell
+        bool isTx = false;                 //!< outgoing message
+        uint8_t eid = 0;                   //!< EID of the peer
+        uint16_t captured = 0;             //!< number of bytes in data
+        uint32_t length = 0;               //!< length of the message
+        std::array<uint8_t, maxTraceBytes> data{}; //!< message bytes
+    };
+
+    /** @brief Interval the writer sleeps for when the queue is empty */
+    static constexpr auto writerInterval = std::chrono::milliseconds(20);
+
+    uint64_t rateLimit;                   //!< messages per second
+    std::atomic<bool> enabled{false};     //!< tracing enabled
+    std::atomic<bool> stopping{false};    //!< writer thread to exit
+    std::array<std::atomic<uint64_t>, 4> eidFilter; //!< one bit per EID
+    std::atomic<uint64_t> typeFilter;     //!< one bit per PLDM type
+    std::atomic<uint64_t> dropped{0};     //!< messages not traced
+    std::atomic<uint64_t> windowStart{0}; //!< second of the rate window
+    std::atomic<uint64_t> windowCount{0}; //!< messages in the rate window
+    std::unique_ptr<Cell[]> cells;        //!< queue of traced messages
+    std::atomic<uint64_t> tail{0};        //!< next position to produce
+    uint64_t head = 0;                    //!< next position to consume
+    std::mutex startLock;                 //!< serializes the writer start
+    std::thread writer;                   //!< writer thread
+
+    /** @brief Take a token from the per second rate limit
+     *
+     *  @return true if the message can be traced
+     */
+    bool acquireToken()
+    {
+        auto now = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+        auto start = windowStart.load(std::memory_order_relaxed);
+        if (now != start &&
+            windowStart.compare_exchange_strong(start, now,
+                                                std::memory_order_relaxed))
+        {
+            windowCount.store(0, std::memory_order_relaxed);
+        }
+        return windowCount.fetch_add(1, std::memory_order_relaxed) <
+               rateLimit;
+    }
+
+    /** @brief Writer thread, drains the queue and writes the traces */
+    void run()
+    {
+        sched_param param{};
+        pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+
+        std::string out;
+        uint64_t reportedDrops = 0;
+        while (true)
+        {
+            // Traces queued before the tracer is destroyed are still written
+            auto stop = stopping.load(std::memory_order_relaxed);
+            out.clear();
+            while (true)
+            {
+                auto& cell = cells[head % queueSize];
+                if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+                {
+                    break;
+                }
+
+                out.append(cell.isTx ? "Tx EID " : "Rx EID ");
+                out.append(std::to_string(cell.eid));
+                out.append(": ");
+                pldm::utils::appendHex(
+                    out, std::span<const uint8_t>(cell.data.data(),
+                                                  cell.captured));
+                if (cell.captured < cell.length)
+                {
+                    out.append("... (");
+                    out.append(std::to_string(cell.length));
+                    out.append(" bytes)");
+                }
+                out.push_back('\n');
+
+                cell.sequence.store(head + queueSize,
+                                    std::memory_order_release);
+                ++head;
+            }
+
+            auto drops = dropped.load(std::memory_order_relaxed);
+            if (drops != reportedDrops)
+            {
+                out.append("Dropped ");
+                out.append(std::to_string(drops - reportedDrops));
+                out.append(" PLDM message traces\n");
+                reportedDrops = drops;
+            }
+
+            if (out.empty())
+            {
+                if (stop)
+                {
+                    return;
+                }
+                std::this_thread::sleep_for(writerInterval);
+                continue;
+            }
+
+            size_t written = 0;
+            while (written < out.size())
+            {
+                auto rc = ::write(STDOUT_FILENO, out.data() + written,
+                                  out.size() - written);
+                if (rc <= 0)
+                {
+                    break;
+                }
+                written += rc;
+            }
+
+            if (stop)
+            {
+                return;
+            }
+        }
+    }
+};
+
+} // namespace tracer
+} // namespace pldm
@@ -0,0 +1,45 @@
+#include "common/command_stats.hpp"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::stats;
+using namespace std::chrono;
+
+TEST(CommandStats, testBucket)
+{
+    EXPECT_EQ(CommandStats::bucket(0), 0);
+    EXPECT_EQ(CommandStats::bucket(1), 1);
+    EXPECT_EQ(CommandStats::bucket(3), 2);
+    EXPECT_EQ(CommandStats::bucket(1000), 10);
+    EXPECT_EQ(CommandStats::bucket(UINT64_MAX),
+              CommandStats::latencyBuckets - 1);
+}
+
+TEST(CommandStats, testRecord)
+{
+    CommandStats stats;
+    stats.record(PLDM_PLATFORM, 0x51, 9, PLDM_SUCCESS, microseconds(100));
+    stats.record(PLDM_PLATFORM, 0x51, 9, PLDM_ERROR, microseconds(300));
+    stats.recordTimeout(PLDM_PLATFORM, 0x51, 9, seconds(5));
+    stats.record(PLDM_BIOS, 0x01, 9, PLDM_SUCCESS, microseconds(10));
+
+    const auto& entries = stats.getEntries();
+    ASSERT_EQ(entries.size(), 2);
+
+    // Entries are ordered by type first
+    EXPECT_EQ(entries.begin()->first.type, PLDM_PLATFORM);
+    const auto& entry = entries.at(CommandStats::Key{PLDM_PLATFORM, 0x51, 9});
+    EXPECT_EQ(entry.count, 3);
+    EXPECT_EQ(entry.errors, 1);
+    EXPECT_EQ(entry.timeouts, 1);
+    EXPECT_EQ(entry.maxLatencyUs, 5000000);
+    EXPECT_EQ(entry.totalLatencyUs, 5000400);
+    EXPECT_EQ(entry.histogram[CommandStats::bucket(100)], 1);
+    EXPECT_EQ(entry.histogram[CommandStats::bucket(300)], 1);
+    EXPECT_EQ(entry.histogram[CommandStats::latencyBuckets - 1], 1);
+
+    stats.clear();
+    EXPECT_TRUE(stats.getEntries().empty());
+}
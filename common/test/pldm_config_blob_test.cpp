@@ -0,0 +1,101 @@
+#include "common/config_blob.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::config_blob;
+
+class ConfigBlobTest : public testing::Test
+{
+  protected:
+    ConfigBlobTest()
+    {
+        char tmpDir[] = "/tmp/config_blob.XXXXXX";
+        dir = mkdtemp(tmpDir);
+    }
+
+    ~ConfigBlobTest()
+    {
+        fs::remove_all(dir);
+    }
+
+    /** @brief Write a blob to a file
+     *
+     *  @param[in] blob - the blob
+     *
+     *  @return the file
+     */
+    fs::path write(const std::vector<uint8_t>& blob)
+    {
+        auto file = dir / "config.blob";
+        std::ofstream os(file, std::ios::binary | std::ios::trunc);
+        os.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+        return file;
+    }
+
+    fs::path dir;
+};
+
+TEST_F(ConfigBlobTest, testFind)
+{
+    std::map<std::string, CompiledJson> jsons;
+    jsons["/usr/share/pldm/pdr/4.json"] = {{2, 100}, {0xa0}};
+    jsons["/usr/share/pldm/fru_master.json"] = {{3, 100}, {1, 2, 3}};
+    Reader reader(write(build(jsons)));
+    ASSERT_FALSE(reader.empty());
+
+    auto cbor = reader.find("/usr/share/pldm/fru_master.json", {3, 100});
+    ASSERT_TRUE(cbor.has_value());
+    EXPECT_EQ(std::vector<uint8_t>(cbor->begin(), cbor->end()),
+              std::vector<uint8_t>({1, 2, 3}));
+
+    cbor = reader.find("/usr/share/pldm/pdr/../pdr/4.json", {2, 100});
+    ASSERT_TRUE(cbor.has_value());
+    EXPECT_EQ(cbor->size(), 1);
+
+    // Changed since it was compiled
+    EXPECT_FALSE(
+        reader.find("/usr/share/pldm/pdr/4.json", {3, 100}).has_value());
+    EXPECT_FALSE(
+        reader.find("/usr/share/pldm/pdr/4.json", {2, 101}).has_value());
+    EXPECT_FALSE(
+        reader.find("/usr/share/pldm/pdr/11.json", {2, 100}).has_value());
+}
+
+TEST_F(ConfigBlobTest, testGetStamp)
+{
+    auto file = dir / "a.json";
+    std::ofstream(file) << "{}";
+    fs::last_write_time(file, fs::file_time_type::clock::now());
+
+    auto stamp = getStamp(file);
+    ASSERT_TRUE(stamp.has_value());
+    EXPECT_EQ(stamp->fileSize, 2);
+
+    std::ofstream(file, std::ios::app) << " ";
+    EXPECT_NE(getStamp(file), stamp);
+    EXPECT_FALSE(getStamp(dir / "missing.json").has_value());
+}
+
+TEST_F(ConfigBlobTest, testNotValid)
+{
+    EXPECT_TRUE(Reader(dir / "missing.blob").empty());
+
+    std::map<std::string, CompiledJson> jsons;
+    jsons["/usr/share/pldm/pdr/4.json"] = {{2, 100}, {0xa0}};
+    auto blob = build(jsons);
+    blob.back() = 0;
+    EXPECT_FALSE(Reader(write(blob)).empty());
+
+    // Truncated
+    blob.resize(blob.size() - 1);
+    EXPECT_TRUE(Reader(write(blob)).empty());
+
+    // Another format
+    blob = build(jsons);
+    blob[sizeof(uint64_t)] += 1;
+    EXPECT_TRUE(Reader(write(blob)).empty());
+}
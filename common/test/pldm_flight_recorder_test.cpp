@@ -0,0 +1,188 @@
+#include "common/flight_recorder.hpp"
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::flightrecorder;
+
+class FlightRecorderTest : public testing::Test
+{
+  protected:
+    FlightRecorderTest() :
+        dumpPath(std::filesystem::temp_directory_path() /
+                 ("pldm_flight_recorder_test_" + std::to_string(getpid())))
+    {}
+
+    ~FlightRecorderTest()
+    {
+        std::filesystem::remove(dumpPath);
+    }
+
+    /** @brief Dump the recorder and read back the dump file */
+    std::vector<uint8_t> dump(FlightRecorder& recorder)
+    {
+        recorder.playRecorder(dumpPath);
+        std::ifstream file(dumpPath, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>()};
+    }
+
+    std::filesystem::path dumpPath;
+};
+
+TEST_F(FlightRecorderTest, testDumpFormat)
+{
+    FlightRecorder recorder(4, 16);
+    std::vector<uint8_t> rx{8, 1, 0x80, 0x02, 0x11};
+    std::vector<uint8_t> tx(20, 0xAA);
+    recorder.saveRecord(rx, false);
+    recorder.saveRecord(tx, true);
+
+    auto file = dump(recorder);
+    ASSERT_GE(file.size(), sizeof(DumpHeader));
+    DumpHeader header{};
+    std::memcpy(&header, file.data(), sizeof(header));
+    EXPECT_EQ(std::memcmp(header.magic, dumpMagic, sizeof(dumpMagic)), 0);
+    EXPECT_EQ(header.version, dumpVersion);
+    EXPECT_EQ(header.slotSize, 16);
+    EXPECT_EQ(header.numRecords, 2);
+    EXPECT_EQ(header.dropped, 0);
+    ASSERT_EQ(file.size(), sizeof(DumpHeader) + 2 * sizeof(DumpRecord) +
+                               rx.size() + 16);
+
+    auto offset = sizeof(DumpHeader);
+    DumpRecord first{};
+    std::memcpy(&first, file.data() + offset, sizeof(first));
+    offset += sizeof(first);
+    EXPECT_EQ(first.isTx, 0);
+    EXPECT_EQ(first.length, rx.size());
+    ASSERT_EQ(first.captured, rx.size());
+    EXPECT_TRUE(std::equal(rx.begin(), rx.end(), file.begin() + offset));
+    offset += first.captured;
+
+    DumpRecord second{};
+    std::memcpy(&second, file.data() + offset, sizeof(second));
+    EXPECT_EQ(second.isTx, 1);
+    EXPECT_EQ(second.length, tx.size());
+    // Truncated to the slot size
+    EXPECT_EQ(second.captured, 16);
+    EXPECT_GE(second.timestampNs, first.timestampNs);
+}
+
+TEST_F(FlightRecorderTest, testWrapAround)
+{
+    FlightRecorder recorder(3, 16);
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        std::vector<uint8_t> msg{i};
+        recorder.saveRecord(msg, true);
+    }
+
+    auto file = dump(recorder);
+    DumpHeader header{};
+    std::memcpy(&header, file.data(), sizeof(header));
+    ASSERT_EQ(header.numRecords, 3);
+
+    // Oldest surviving record first
+    auto offset = sizeof(DumpHeader);
+    for (uint8_t i = 2; i < 5; ++i)
+    {
+        offset += sizeof(DumpRecord);
+        EXPECT_EQ(file[offset], i);
+        offset += 1;
+    }
+}
+
+TEST_F(FlightRecorderTest, testConcurrentWriters)
+{
+    constexpr size_t numThreads = 4;
+    constexpr size_t perThread = 1000;
+    FlightRecorder recorder(numThreads * perThread, 16);
+
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        writers.emplace_back([&recorder, t]() {
+            std::vector<uint8_t> msg(8, static_cast<uint8_t>(t));
+            for (size_t i = 0; i < perThread; ++i)
+            {
+                recorder.saveRecord(msg, true);
+            }
+        });
+    }
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+
+    auto file = dump(recorder);
+    DumpHeader header{};
+    std::memcpy(&header, file.data(), sizeof(header));
+    EXPECT_EQ(header.numRecords + header.dropped, numThreads * perThread);
+    EXPECT_EQ(header.dropped, 0);
+}
+
+/** @brief Recorder letting a writer take a given ticket, as if it was
+ *         delayed after taking it
+ */
+class DelayedWriterRecorder : public FlightRecorder
+{
+  public:
+    using FlightRecorder::FlightRecorder;
+
+    void saveDelayedRecord(uint64_t ticket, std::span<const uint8_t> buffer)
+    {
+        auto next = head.exchange(ticket);
+        saveRecord(buffer, true);
+        head.store(next);
+    }
+};
+
+TEST_F(FlightRecorderTest, testDelayedWriter)
+{
+    DelayedWriterRecorder recorder(2, 16);
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+        std::vector<uint8_t> msg(4, i);
+        recorder.saveRecord(msg, true);
+    }
+
+    // Ticket 0 shares its slot with ticket 2, which is newer
+    std::vector<uint8_t> stale(4, 0xFF);
+    recorder.saveDelayedRecord(0, stale);
+
+    auto file = dump(recorder);
+    DumpHeader header{};
+    std::memcpy(&header, file.data(), sizeof(header));
+    EXPECT_EQ(header.numRecords, 2);
+    EXPECT_EQ(header.dropped, 1);
+
+    size_t offset = sizeof(header);
+    for (uint8_t i = 1; i < 3; ++i)
+    {
+        DumpRecord record{};
+        std::memcpy(&record, file.data() + offset, sizeof(record));
+        offset += sizeof(record);
+        ASSERT_EQ(record.captured, 4);
+        EXPECT_EQ(std::vector<uint8_t>(file.data() + offset,
+                                       file.data() + offset + record.captured),
+                  std::vector<uint8_t>(4, i));
+        offset += record.captured;
+    }
+}
+
+TEST_F(FlightRecorderTest, testDisabled)
+{
+    FlightRecorder recorder(0, 16);
+    std::vector<uint8_t> msg{1, 2, 3};
+    recorder.saveRecord(msg, true);
+    recorder.playRecorder(dumpPath);
+    EXPECT_FALSE(std::filesystem::exists(dumpPath));
+}
@@ -0,0 +1,156 @@
+#include "common/json_preload.hpp"
+#include "common/worker_pool.hpp"
+
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+class JsonPreloadTest : public testing::Test
+{
+  protected:
+    JsonPreloadTest() : event(sdeventplus::Event::get_default())
+    {
+        char tmpDir[] = "/tmp/json_preload.XXXXXX";
+        dir = mkdtemp(tmpDir);
+    }
+
+    ~JsonPreloadTest()
+    {
+        pldm::utils::clearPreloadedJsons();
+        fs::remove_all(dir);
+    }
+
+    sdeventplus::Event event;
+    fs::path dir;
+
+    /** @brief Run the event loop until there are no events for the timeout
+     *
+     *  @param[in] timeout - maximum time to wait for an event
+     */
+    void waitEventExpiry(milliseconds timeout)
+    {
+        while (1)
+        {
+            auto sleepTime = duration_cast<microseconds>(timeout);
+            // Returns 0 on timeout
+            if (!sd_event_run(event.get(), sleepTime.count()))
+            {
+                break;
+            }
+        }
+    }
+};
+
+TEST_F(JsonPreloadTest, testPreloadJsons)
+{
+    fs::create_directory(dir / "system");
+    std::ofstream(dir / "a.json") << R"({"entries": [1, 2]})";
+    std::ofstream(dir / "system" / "b.json") << R"({"entries": []})";
+    std::ofstream(dir / "bad.json") << "{";
+
+    // Fewer in-flight items than files
+    WorkerPool pool(event, 2, 1);
+    pldm::utils::preloadJsons(pool, event, {dir});
+    EXPECT_EQ(pool.pending(), 0);
+
+    auto a = pldm::utils::takePreloadedJson(dir / "a.json");
+    ASSERT_TRUE(a.has_value());
+    EXPECT_EQ(a->at("entries").size(), 2);
+    // Taken only once, later reads parse the file
+    EXPECT_FALSE(pldm::utils::takePreloadedJson(dir / "a.json").has_value());
+    EXPECT_EQ(pldm::utils::parseJsonFile(dir / "a.json"), *a);
+
+    // The directories are not searched recursively
+    EXPECT_FALSE(
+        pldm::utils::takePreloadedJson(dir / "system/b.json").has_value());
+
+    // Left for the handler to report
+    EXPECT_FALSE(pldm::utils::takePreloadedJson(dir / "bad.json").has_value());
+    EXPECT_TRUE(
+        pldm::utils::parseJsonFile(dir / "bad.json", false).is_discarded());
+}
+
+TEST_F(JsonPreloadTest, testPreloadSystemTypeDir)
+{
+    fs::create_directory(dir / "system");
+    std::ofstream(dir / "system" / "b.json") << R"({"entries": []})";
+
+    WorkerPool pool(event, 2);
+    pldm::utils::preloadJsons(pool, event, {dir / "system"});
+
+    EXPECT_TRUE(pldm::utils::takePreloadedJson(dir / "system/./b.json")
+                    .has_value());
+}
+
+TEST_F(JsonPreloadTest, testPreloadCompiledJsons)
+{
+    std::ofstream(dir / "compiled.json") << R"({"entries": [1, 2]})";
+    std::ofstream(dir / "changed.json") << R"({"entries": []})";
+
+    // The blob tells whether a JSON file was decoded from it or parsed
+    auto fromBlob = pldm::utils::Json::to_cbor({{"fromBlob", true}});
+    std::map<std::string, config_blob::CompiledJson> jsons;
+    jsons[(dir / "compiled.json").string()] = {
+        *config_blob::getStamp(dir / "compiled.json"), fromBlob};
+    auto changed = *config_blob::getStamp(dir / "changed.json");
+    changed.modified -= 1;
+    jsons[(dir / "changed.json").string()] = {changed, fromBlob};
+    auto blob = config_blob::build(jsons);
+    std::ofstream(dir / "config.blob", std::ios::binary)
+        .write(reinterpret_cast<const char*>(blob.data()), blob.size());
+
+    WorkerPool pool(event, 2);
+    pldm::utils::preloadJsons(pool, event, {dir / "compiled.json",
+                                            dir / "changed.json"},
+                              dir / "config.blob");
+
+    auto compiled = pldm::utils::takePreloadedJson(dir / "compiled.json");
+    ASSERT_TRUE(compiled.has_value());
+    EXPECT_TRUE(compiled->contains("fromBlob"));
+    auto parsed = pldm::utils::takePreloadedJson(dir / "changed.json");
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_FALSE(parsed->contains("fromBlob"));
+}
+
+TEST_F(JsonPreloadTest, testPreloadJsonsAsync)
+{
+    std::ofstream(dir / "a.json") << R"({"entries": [1, 2]})";
+    std::ofstream(dir / "b.json") << R"({"entries": []})";
+
+    WorkerPool pool(event, 2);
+    bool done = false;
+    pldm::utils::preloadJsonsAsync(pool, {dir / "a.json", dir / "b.json"},
+                                   [&done]() { done = true; });
+    EXPECT_FALSE(done);
+    waitEventExpiry(milliseconds(100));
+    EXPECT_TRUE(done);
+
+    EXPECT_TRUE(pldm::utils::takePreloadedJson(dir / "a.json").has_value());
+    EXPECT_TRUE(pldm::utils::takePreloadedJson(dir / "b.json").has_value());
+
+    // Nothing to parse
+    done = false;
+    pldm::utils::preloadJsonsAsync(pool, {}, [&done]() { done = true; });
+    EXPECT_TRUE(done);
+}
+
+TEST_F(JsonPreloadTest, testClearPreloadedJsons)
+{
+    std::ofstream(dir / "a.json") << R"({"entries": [1, 2]})";
+
+    WorkerPool pool(event, 2);
+    pldm::utils::preloadJsons(pool, event, {dir});
+    pldm::utils::clearPreloadedJsons();
+
+    EXPECT_FALSE(pldm::utils::takePreloadedJson(dir / "a.json").has_value());
+}
@@ -0,0 +1,69 @@
+#include "common/packet_tracer.hpp"
+#include "common/utils.hpp"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::tracer;
+
+TEST(AppendHex, testEncode)
+{
+    std::string out("Tx: ");
+    std::vector<uint8_t> buffer{0x00, 0x0a, 0x80, 0xff};
+    pldm::utils::appendHex(out, buffer);
+    EXPECT_EQ(out, "Tx: 00 0a 80 ff ");
+}
+
+TEST(PacketTracer, testDisabled)
+{
+    PacketTracer tracer(1);
+    std::vector<uint8_t> msg{0x80, 0x02, 0x11};
+    for (int i = 0; i < 4; ++i)
+    {
+        tracer.trace(true, 9, msg);
+    }
+    EXPECT_FALSE(tracer.isEnabled());
+    EXPECT_EQ(tracer.getDropped(), 0);
+}
+
+TEST(PacketTracer, testRateLimit)
+{
+    PacketTracer tracer(2);
+    tracer.enable(true);
+    std::vector<uint8_t> msg{0x80, 0x02, 0x11};
+    for (int i = 0; i < 5; ++i)
+    {
+        tracer.trace(true, 9, msg);
+    }
+    // Unless the second rolled over while tracing, 2 are traced
+    EXPECT_GE(tracer.getDropped(), 1);
+    EXPECT_LE(tracer.getDropped(), 3);
+}
+
+TEST(PacketTracer, testFilter)
+{
+    PacketTracer tracer(2);
+    tracer.enable(true);
+    std::vector<uint8_t> eids{9};
+    std::vector<uint8_t> types{PLDM_PLATFORM};
+    tracer.setFilter(eids, types);
+
+    // Filtered out messages neither consume the rate limit nor count as drops
+    std::vector<uint8_t> bios{0x80, PLDM_BIOS, 0x01};
+    std::vector<uint8_t> platform{0x80, PLDM_PLATFORM, 0x11};
+    for (int i = 0; i < 5; ++i)
+    {
+        tracer.trace(false, 9, bios);
+        tracer.trace(false, 8, platform);
+    }
+    EXPECT_EQ(tracer.getDropped(), 0);
+
+    tracer.allowAll();
+    for (int i = 0; i < 5; ++i)
+    {
+        tracer.trace(false, 8, bios);
+    }
+    EXPECT_GE(tracer.getDropped(), 1);
+}
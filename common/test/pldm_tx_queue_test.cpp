@@ -0,0 +1,128 @@
+#include "common/tx_queue.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <sdeventplus/event.hpp>
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace std::chrono;
+
+class TxQueueTest : public testing::Test
+{
+  protected:
+    TxQueueTest() : event(sdeventplus::Event::get_default())
+    {
+        EXPECT_EQ(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds), 0);
+        int sndbuf = 4096;
+        setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    }
+
+    ~TxQueueTest()
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    sdeventplus::Event event;
+    int fds[2] = {-1, -1};
+
+    /** @brief Run the event loop until there are no events for the timeout
+     *
+     *  @param[in] timeout - maximum time to wait for an event
+     */
+    void waitEventExpiry(milliseconds timeout)
+    {
+        while (1)
+        {
+            auto sleepTime = duration_cast<microseconds>(timeout);
+            // Returns 0 on timeout
+            if (!sd_event_run(event.get(), sleepTime.count()))
+            {
+                break;
+            }
+        }
+    }
+
+    /** @brief Receive a message from the peer end of the socket pair
+     *
+     *  @return received message, empty if there is none
+     */
+    std::vector<uint8_t> receive()
+    {
+        std::vector<uint8_t> msg(1024);
+        auto rc = recv(fds[1], msg.data(), msg.size(), MSG_DONTWAIT);
+        msg.resize(rc < 0 ? 0 : rc);
+        return msg;
+    }
+};
+
+TEST_F(TxQueueTest, testSendDirect)
+{
+    TxQueue txQueue(event, fds[0]);
+
+    std::array<uint8_t, 4> msg{0x80, 0x00, 0x02, 0x00};
+    EXPECT_EQ(txQueue.send(9, msg), PLDM_SUCCESS);
+    EXPECT_EQ(txQueue.depth(), 0);
+
+    auto received = receive();
+    std::vector<uint8_t> expected{9, 1, 0x80, 0x00, 0x02, 0x00};
+    EXPECT_EQ(received, expected);
+    EXPECT_EQ(txQueue.getStats().sent, 1);
+    EXPECT_EQ(txQueue.getStats().queued, 0);
+}
+
+TEST_F(TxQueueTest, testQueueFlushedInOrder)
+{
+    // High-water mark of a single message
+    TxQueue txQueue(event, fds[0], 64);
+
+    std::vector<uint8_t> msg(64);
+    size_t count = 0;
+    while (!txQueue.depth() && count < 10000)
+    {
+        msg[0] = count & 0xFF;
+        msg[1] = (count >> 8) & 0xFF;
+        ASSERT_EQ(txQueue.send(9, msg), PLDM_SUCCESS);
+        ++count;
+    }
+    ASSERT_GT(txQueue.depth(), 0);
+    EXPECT_TRUE(txQueue.congested());
+
+    // More messages keep their order behind the queued one
+    for (size_t i = 0; i < 4; ++i, ++count)
+    {
+        msg[0] = count & 0xFF;
+        msg[1] = (count >> 8) & 0xFF;
+        ASSERT_EQ(txQueue.send(9, msg), PLDM_SUCCESS);
+    }
+    EXPECT_EQ(txQueue.depth(), 5);
+
+    size_t next = 0;
+    while (next < count)
+    {
+        auto received = receive();
+        if (received.empty())
+        {
+            waitEventExpiry(milliseconds(10));
+            continue;
+        }
+        ASSERT_EQ(received.size(), msg.size() + 2);
+        EXPECT_EQ(received[2], next & 0xFF);
+        EXPECT_EQ(received[3], (next >> 8) & 0xFF);
+        ++next;
+    }
+    waitEventExpiry(milliseconds(10));
+
+    EXPECT_EQ(txQueue.depth(), 0);
+    EXPECT_FALSE(txQueue.congested());
+    EXPECT_EQ(txQueue.getStats().sent, count);
+    EXPECT_EQ(txQueue.getStats().queued, 5);
+    EXPECT_EQ(txQueue.getStats().maxDepth, 5);
+}
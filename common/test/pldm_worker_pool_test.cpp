@@ -0,0 +1,90 @@
+#include "common/worker_pool.hpp"
+
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace std::chrono;
+
+class WorkerPoolTest : public testing::Test
+{
+  protected:
+    WorkerPoolTest() : event(sdeventplus::Event::get_default()) {}
+
+    sdeventplus::Event event;
+
+    /** @brief Run the event loop until there are no events for the timeout
+     *
+     *  @param[in] timeout - maximum time to wait for an event
+     */
+    void waitEventExpiry(milliseconds timeout)
+    {
+        while (1)
+        {
+            auto sleepTime = duration_cast<microseconds>(timeout);
+            // Returns 0 on timeout
+            if (!sd_event_run(event.get(), sleepTime.count()))
+            {
+                break;
+            }
+        }
+    }
+};
+
+TEST_F(WorkerPoolTest, testCompletionOnEventLoop)
+{
+    WorkerPool pool(event, 2);
+    auto loopThread = std::this_thread::get_id();
+    std::thread::id workThread{};
+    std::thread::id doneThread{};
+    bool done = false;
+
+    ASSERT_TRUE(pool.submit(
+        [&workThread]() { workThread = std::this_thread::get_id(); },
+        [&]() {
+        doneThread = std::this_thread::get_id();
+        done = true;
+    }));
+    waitEventExpiry(milliseconds(100));
+
+    EXPECT_TRUE(done);
+    EXPECT_NE(workThread, loopThread);
+    EXPECT_EQ(doneThread, loopThread);
+    EXPECT_EQ(pool.pending(), 0);
+}
+
+TEST_F(WorkerPoolTest, testCompletionAfterException)
+{
+    WorkerPool pool(event, 1);
+    bool done = false;
+
+    ASSERT_TRUE(pool.submit([]() { throw std::runtime_error("failed"); },
+                            [&done]() { done = true; }));
+    waitEventExpiry(milliseconds(100));
+
+    EXPECT_TRUE(done);
+    EXPECT_EQ(pool.pending(), 0);
+}
+
+TEST_F(WorkerPoolTest, testSaturated)
+{
+    WorkerPool pool(event, 1, 2);
+    size_t completed = 0;
+
+    EXPECT_TRUE(pool.submit([]() {}, [&completed]() { ++completed; }));
+    EXPECT_TRUE(pool.submit([]() {}, [&completed]() { ++completed; }));
+    // Completions only run on the event loop, so the pool is still full
+    EXPECT_FALSE(pool.submit([]() {}, [&completed]() { ++completed; }));
+    waitEventExpiry(milliseconds(100));
+
+    EXPECT_EQ(completed, 2);
+    EXPECT_EQ(pool.pending(), 0);
+    EXPECT_TRUE(pool.submit([]() {}, [&completed]() { ++completed; }));
+    waitEventExpiry(milliseconds(100));
+    EXPECT_EQ(completed, 3);
+}
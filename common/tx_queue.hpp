@@ -0,0 +1,278 @@
+#pragma once
+
+#include "common/utils.hpp"
+
+#include <fcntl.h>
+#include <libpldm/base.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <span>
+#include <system_error>
+#include <vector>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+
+/** @class TxQueue
+ *
+ *  Non-blocking transmit path of an MCTP socket. A message is sent right away
+ *  with MSG_DONTWAIT when nothing is queued, otherwise, or when the socket
+ *  would block, it is appended to an ordered output queue that is flushed
+ *  when the socket reports EPOLLOUT. The socket send buffer is only grown when
+ *  a message does not fit in it.
+ *
+ *  Requesters are expected to back off from sending new requests while the
+ *  queued bytes are above the high-water mark, see congested(). Responses are
+ *  always queued.
+ */
+class TxQueue
+{
+  public:
+    /** @struct Stats
+     *
+     *  Transmit statistics.
+     */
+    struct Stats
+    {
+        uint64_t sent = 0;          //!< messages sent
+        uint64_t queued = 0;        //!< messages that had to be queued
+        uint64_t eagain = 0;        //!< sends that would have blocked
+        uint64_t errors = 0;        //!< messages dropped on a send error
+        uint64_t maxDepth = 0;      //!< max number of queued messages
+        uint64_t maxBytes = 0;      //!< max number of queued bytes
+        uint64_t sndbufGrowths = 0; //!< SO_SNDBUF increases
+    };
+
+    TxQueue() = delete;
+    TxQueue(const TxQueue&) = delete;
+    TxQueue(TxQueue&&) = delete;
+    TxQueue& operator=(const TxQueue&) = delete;
+    TxQueue& operator=(TxQueue&&) = delete;
+
+    /** @brief Constructor
+     *
+     *  @param[in] event - reference to PLDM daemon's main event loop
+     *  @param[in] fd - fd of the MCTP communications socket, not owned
+     *  @param[in] highWaterMark - queued bytes above which the queue is
+     *                             congested
+     *
+     *  @throw std::system_error if the socket cannot be watched
+     */
+    TxQueue(sdeventplus::Event& event, int fd,
+            size_t highWaterMark = TX_QUEUE_HIGH_WATER_MARK) :
+        fd(fd),
+        highWaterMark(highWaterMark), watchFd(dupFd(fd)),
+        io(event, watchFd(), EPOLLOUT,
+           std::bind_front(&TxQueue::flush, this))
+    {
+        io.set_enabled(sdeventplus::source::Enabled::Off);
+
+        socklen_t optlen = sizeof(sndbufSize);
+        if (getsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbufSize, &optlen) < 0)
+        {
+            sndbufSize = 0;
+        }
+    }
+
+    ~TxQueue() = default;
+
+    /** @brief Send a PLDM message, queueing it if the socket would block
+     *
+     *  @param[in] eid - MCTP endpoint ID of the destination
+     *  @param[in] msg - PLDM message, it is copied only if it has to be queued
+     *
+     *  @return PLDM_SUCCESS if the message was sent or queued, PLDM_ERROR if
+     *          sending it failed
+     */
+    int send(uint8_t eid, std::span<const uint8_t> msg)
+    {
+        if (queue.empty())
+        {
+            auto rc = trySend(eid, msg);
+            if (rc != -EAGAIN)
+            {
+                return rc ? PLDM_ERROR : PLDM_SUCCESS;
+            }
+        }
+
+        ++stats.queued;
+        queue.push_back({eid, std::vector<uint8_t>(msg.begin(), msg.end())});
+        queuedBytes += msg.size();
+        stats.maxDepth = std::max<uint64_t>(stats.maxDepth, queue.size());
+        stats.maxBytes = std::max<uint64_t>(stats.maxBytes, queuedBytes);
+        io.set_enabled(sdeventplus::source::Enabled::On);
+        return PLDM_SUCCESS;
+    }
+
+    /** @brief Check if requesters should hold off sending new requests
+     *
+     *  @return true if the queued bytes are at or above the high-water mark
+     */
+    bool congested() const
+    {
+        return queuedBytes >= highWaterMark;
+    }
+
+    /** @brief Get the number of queued messages
+     *
+     *  @return number of messages waiting to be sent
+     */
+    size_t depth() const
+    {
+        return queue.size();
+    }
+
+    /** @brief Get the transmit statistics
+     *
+     *  @return const reference to the statistics
+     */
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+    /** @brief Log the transmit statistics */
+    void logStats() const
+    {
+        info(
+            "MCTP transmit stats: SENT={SENT} QUEUED={QUEUED} EAGAIN={EAGAIN} ERRORS={ERRORS} DEPTH={DEPTH} MAX_DEPTH={MAX_DEPTH} MAX_BYTES={MAX_BYTES} SNDBUF_GROWTHS={GROWTHS}",
+            "SENT", stats.sent, "QUEUED", stats.queued, "EAGAIN", stats.eagain,
+            "ERRORS", stats.errors, "DEPTH", queue.size(), "MAX_DEPTH",
+            stats.maxDepth, "MAX_BYTES", stats.maxBytes, "GROWTHS",
+            stats.sndbufGrowths);
+    }
+
+  private:
+    /** @struct Pending
+     *
+     *  A message waiting in the output queue.
+     */
+    struct Pending
+    {
+        uint8_t eid;              //!< destination EID
+        std::vector<uint8_t> msg; //!< PLDM message
+    };
+
+    /** @brief MCTP message type of PLDM */
+    static constexpr uint8_t mctpMsgTypePldm = 1;
+
+    int fd;                        //!< MCTP communications socket
+    size_t highWaterMark;          //!< congestion threshold in bytes
+    pldm::utils::CustomFD watchFd; //!< dup of fd watched for EPOLLOUT
+    sdeventplus::source::IO io;    //!< EPOLLOUT event source, on when queued
+    std::deque<Pending> queue;     //!< messages waiting to be sent
+    size_t queuedBytes = 0;        //!< bytes waiting to be sent
+    int sndbufSize = 0;            //!< current SO_SNDBUF of the socket
+    Stats stats;                   //!< transmit statistics
+
+    /** @brief Duplicate the socket fd, so the EPOLLOUT watch can coexist with
+     *         the EPOLLIN watch of the receive path
+     *
+     *  @param[in] fd - fd of the socket
+     *  @return duplicated fd
+     */
+    static int dupFd(int fd)
+    {
+        int watch = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (watch < 0)
+        {
+            throw std::system_error(errno, std::generic_category(),
+                                    "Failed to duplicate the MCTP socket");
+        }
+        return watch;
+    }
+
+    /** @brief Send a message without blocking
+     *
+     *  @param[in] eid - MCTP endpoint ID of the destination
+     *  @param[in] msg - PLDM message
+     *
+     *  @return 0 on success, -EAGAIN if the socket would block, -errno on
+     *          any other failure
+     */
+    int trySend(uint8_t eid, std::span<const uint8_t> msg)
+    {
+        uint8_t prefix[] = {eid, mctpMsgTypePldm};
+        int size = static_cast<int>(sizeof(prefix) + msg.size());
+
+        // A SOCK_SEQPACKET message must fit in the send buffer
+        if (sndbufSize >= 0 && sndbufSize < size)
+        {
+            if (setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)) < 0)
+            {
+                error(
+                    "Failed to set the new send buffer size [bytes] : {CUR_BUFF_SIZE} from current size [bytes] : {OLD_BUFF_SIZE}, Error : {ERR}",
+                    "CUR_BUFF_SIZE", size, "OLD_BUFF_SIZE", sndbufSize, "ERR",
+                    strerror(errno));
+            }
+            else
+            {
+                sndbufSize = size;
+                ++stats.sndbufGrowths;
+            }
+        }
+
+        struct iovec iov[2]{};
+        iov[0].iov_base = prefix;
+        iov[0].iov_len = sizeof(prefix);
+        iov[1].iov_base = const_cast<uint8_t*>(msg.data());
+        iov[1].iov_len = msg.size();
+
+        struct msghdr hdr
+        {};
+        hdr.msg_iov = iov;
+        hdr.msg_iovlen = sizeof(iov) / sizeof(iov[0]);
+
+        if (sendmsg(fd, &hdr, MSG_DONTWAIT | MSG_NOSIGNAL) < 0)
+        {
+            int rc = -errno;
+            if (rc == -EAGAIN || rc == -EWOULDBLOCK)
+            {
+                ++stats.eagain;
+                return -EAGAIN;
+            }
+            ++stats.errors;
+            error("sendmsg system call failed, RC= {RC}", "RC", rc);
+            return rc;
+        }
+        ++stats.sent;
+        return 0;
+    }
+
+    /** @brief Send the queued messages in order while the socket accepts them
+     *
+     *  @param[in] source - EPOLLOUT event source
+     *  @param[in] fd - watched fd
+     *  @param[in] revents - returned events
+     */
+    void flush(sdeventplus::source::IO& /*source*/, int /*fd*/,
+               uint32_t /*revents*/)
+    {
+        while (!queue.empty())
+        {
+            auto& pending = queue.front();
+            if (trySend(pending.eid, pending.msg) == -EAGAIN)
+            {
+                return;
+            }
+            // Sent, or dropped after a send error that was logged
+            queuedBytes -= pending.msg.size();
+            queue.pop_front();
+        }
+        io.set_enabled(sdeventplus::source::Enabled::Off);
+    }
+};
+
+} // namespace pldm
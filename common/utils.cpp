@@ -12,9 +12,11 @@
 #include <array>
 #include <cctype>
 #include <ctime>
+#include <functional>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -317,13 +319,26 @@ void reportError(const char* errorMsg, const Severity& sev)
     }
 }
 
-void DBusHandler::setDbusProperty(const DBusMapping& dBusMap,
-                                  const PropertyValue& value) const
+namespace
+{
+
+/** @brief Create the method call setting a D-Bus property
+ *
+ *  @param[in] service - service implementing the D-Bus object
+ *  @param[in] dBusMap - Object path, property name, interface and property
+ *                       type for the D-Bus object
+ *  @param[in] value - The value to be set
+ *
+ *  @return the method call
+ *
+ *  @throw std::invalid_argument if the property type is not supported
+ */
+sdbusplus::message_t newSetDbusPropertyCall(const std::string& service,
+                                            const DBusMapping& dBusMap,
+                                            const PropertyValue& value)
 {
-    auto setDbusValue = [&dBusMap, this](const auto& variant) {
-        auto& bus = getBus();
-        auto service = getService(dBusMap.objectPath.c_str(),
-                                  dBusMap.interface.c_str());
+    auto setDbusValue = [&dBusMap, &service](const auto& variant) {
+        auto& bus = DBusHandler::getBus();
         if (service == "xyz.openbmc_project.Inventory.Manager")
         {
             ObjectValueTree objectValueTree;
@@ -342,7 +357,7 @@ void DBusHandler::setDbusProperty(const DBusMapping& dBusMap,
                 service.c_str(), "/xyz/openbmc_project/inventory",
                 "xyz.openbmc_project.Inventory.Manager", "Notify");
             method.append(std::move(objectValueTree));
-            bus.call_noreply(method, dbusTimeout);
+            return method;
         }
         else
         {
@@ -361,14 +376,14 @@ void DBusHandler::setDbusProperty(const DBusMapping& dBusMap,
             }
             method.append(dBusMap.interface.c_str(),
                           dBusMap.propertyName.c_str(), variant);
-            bus.call_noreply(method, dbusTimeout);
+            return method;
         }
     };
 
     if (dBusMap.propertyType == "uint8_t")
     {
         std::variant<uint8_t> v = std::get<uint8_t>(value);
-        setDbusValue(v);
+        return setDbusValue(v);
     }
     else if (dBusMap.propertyType == "bool")
     {
@@ -391,47 +406,47 @@ void DBusHandler::setDbusProperty(const DBusMapping& dBusMap,
             }
         }
 
-        setDbusValue(v);
+        return setDbusValue(v);
     }
     else if (dBusMap.propertyType == "int16_t")
     {
         std::variant<int16_t> v = std::get<int16_t>(value);
-        setDbusValue(v);
+        return setDbusValue(v);
     }
     else if (dBusMap.propertyType == "uint16_t")
     {
         std::variant<uint16_t> v = std::get<uint16_t>(value);
-        setDbusValue(v);
+        return setDbusValue(v);
     }
     else if (dBusMap.propertyType == "int32_t")
     {
         std::variant<int32_t> v = std::get<int32_t>(value);
-        setDbusValue(v);
+        return setDbusValue(v);
     }
     else if (dBusMap.propertyType == "uint32_t")
     {
         std::variant<uint32_t> v = std::get<uint32_t>(value);
-        setDbusValue(v);
+        return setDbusValue(v);
     }
     else if (dBusMap.propertyType == "int64_t")
     {
         std::variant<int64_t> v = std::get<int64_t>(value);
-        setDbusValue(v);
+        return setDbusValue(v);
     }
     else if (dBusMap.propertyType == "uint64_t")
     {
         std::variant<uint64_t> v = std::get<uint64_t>(value);
-        setDbusValue(v);
+        return setDbusValue(v);
     }
     else if (dBusMap.propertyType == "double")
     {
         std::variant<double> v = std::get<double>(value);
-        setDbusValue(v);
+        return setDbusValue(v);
     }
     else if (dBusMap.propertyType == "string")
     {
         std::variant<std::string> v = std::get<std::string>(value);
-        setDbusValue(v);
+        return setDbusValue(v);
     }
     else
     {
@@ -441,6 +456,228 @@ void DBusHandler::setDbusProperty(const DBusMapping& dBusMap,
     }
 }
 
+/** @brief Callback of an asynchronous D-Bus method call
+ *
+ *  Gets the reply of the method call, or nullptr when the call fails
+ */
+using ReplyCallback = std::function<void(sdbusplus::message_t* reply)>;
+
+/** @brief Send a D-Bus method call without waiting for its reply
+ *
+ *  @param[in] method - the method call
+ *  @param[in] callback - invoked from the event loop with the reply, which is
+ *                        an error if the call fails or times out
+ *
+ *  @throw sdbusplus::exception_t when the call cannot be sent
+ */
+void callAsync(sdbusplus::message_t& method,
+               std::function<void(sdbusplus::message_t& reply)>&& callback)
+{
+    using Callback = std::function<void(sdbusplus::message_t& reply)>;
+    auto handler = [](sd_bus_message* msg, void* userdata,
+                      sd_bus_error* /*retError*/) -> int {
+        std::unique_ptr<Callback> callback(static_cast<Callback*>(userdata));
+        // Exceptions must not unwind through sd-bus, which is C
+        try
+        {
+            sdbusplus::message_t reply(msg);
+            (*callback)(reply);
+        }
+        catch (const std::exception& e)
+        {
+            error("Failed to handle the D-Bus reply, ERROR={ERR_EXCEP}",
+                  "ERR_EXCEP", e.what());
+        }
+        return 0;
+    };
+
+    // The slot is floating, the bus owns it until the reply is handled
+    auto userdata = std::make_unique<Callback>(std::move(callback));
+    auto rc = sd_bus_call_async(DBusHandler::getBus().get(), nullptr,
+                                method.get(), handler, userdata.get(),
+                                dbusTimeout);
+    if (rc < 0)
+    {
+        throw sdbusplus::exception::SdBusError(-rc, "sd_bus_call_async");
+    }
+    userdata.release();
+}
+
+/** @brief Send a D-Bus method call to the service of a D-Bus object without
+ *         waiting for the mapper or the service
+ *
+ *  @param[in] objPath - The Dbus object path
+ *  @param[in] dbusInterface - The Dbus interface
+ *  @param[in] newCall - creates the method call for the service
+ *  @param[in] callback - invoked from the event loop with the reply
+ */
+void callServiceAsync(
+    const std::string& objPath, const std::string& dbusInterface,
+    std::function<sdbusplus::message_t(const std::string& service)>&& newCall,
+    const ReplyCallback& callback)
+{
+    auto failed = [objPath, dbusInterface,
+                   callback](const std::exception& e) {
+        error(
+            "Failed D-Bus call, PATH={DBUS_OBJ_PATH} INTERFACE={DBUS_INTF} ERROR={ERR_EXCEP}",
+            "DBUS_OBJ_PATH", objPath, "DBUS_INTF", dbusInterface, "ERR_EXCEP",
+            e.what());
+        callback(nullptr);
+    };
+    auto checkReply = [](sdbusplus::message_t& reply) {
+        if (reply.is_method_error())
+        {
+            throw sdbusplus::exception::SdBusError(reply.get_errno(),
+                                                   "D-Bus method call");
+        }
+    };
+
+    auto onService = [objPath, dbusInterface, newCall = std::move(newCall),
+                      callback, failed,
+                      checkReply](sdbusplus::message_t& reply) {
+        try
+        {
+            checkReply(reply);
+            std::map<std::string, std::vector<std::string>> mapperResponse;
+            reply.read(mapperResponse);
+            if (mapperResponse.empty())
+            {
+                throw std::runtime_error("No service for the object");
+            }
+            auto method = newCall(mapperResponse.begin()->first);
+            callAsync(method, [objPath, dbusInterface, callback, failed,
+                               checkReply](sdbusplus::message_t& reply) {
+                try
+                {
+                    checkReply(reply);
+                }
+                catch (const std::exception& e)
+                {
+                    failed(e);
+                    return;
+                }
+                try
+                {
+                    callback(&reply);
+                }
+                catch (const std::exception& e)
+                {
+                    error(
+                        "Failed to handle the D-Bus reply, PATH={DBUS_OBJ_PATH} INTERFACE={DBUS_INTF} ERROR={ERR_EXCEP}",
+                        "DBUS_OBJ_PATH", objPath, "DBUS_INTF", dbusInterface,
+                        "ERR_EXCEP", e.what());
+                }
+            });
+        }
+        catch (const std::exception& e)
+        {
+            failed(e);
+        }
+    };
+
+    try
+    {
+        auto& bus = DBusHandler::getBus();
+        auto mapper = bus.new_method_call(mapperBusName, mapperPath,
+                                          mapperInterface, "GetObject");
+        mapper.append(objPath, std::vector<std::string>({dbusInterface}));
+        callAsync(mapper, std::move(onService));
+    }
+    catch (const std::exception& e)
+    {
+        failed(e);
+    }
+}
+
+/** @brief Set the D-Bus properties from the given one on, one at a time
+ *
+ *  @param[in] properties - the D-Bus properties and their values
+ *  @param[in] index - the first property to set
+ *  @param[in] callback - invoked once the properties are set, or one fails
+ */
+void setDbusPropertiesFrom(
+    const std::shared_ptr<const std::vector<DBusProperty>>& properties,
+    size_t index, const std::function<void(bool set)>& callback)
+{
+    if (index == properties->size())
+    {
+        callback(true);
+        return;
+    }
+
+    const auto& dBusMap = (*properties)[index].first;
+    callServiceAsync(
+        dBusMap.objectPath, dBusMap.interface,
+        [properties, index](const std::string& service) {
+        const auto& [dBusMap, value] = (*properties)[index];
+        return newSetDbusPropertyCall(service, dBusMap, value);
+    },
+        [properties, index, callback](sdbusplus::message_t* reply) {
+        if (!reply)
+        {
+            callback(false);
+            return;
+        }
+        setDbusPropertiesFrom(properties, index + 1, callback);
+    });
+}
+
+} // namespace
+
+void DBusHandler::setDbusProperty(const DBusMapping& dBusMap,
+                                  const PropertyValue& value) const
+{
+    auto service = getService(dBusMap.objectPath.c_str(),
+                              dBusMap.interface.c_str());
+    auto method = newSetDbusPropertyCall(service, dBusMap, value);
+    getBus().call_noreply(method, dbusTimeout);
+}
+
+void DBusHandler::setDbusPropertiesAsync(
+    std::vector<DBusProperty> properties,
+    std::function<void(bool set)> callback) const
+{
+    setDbusPropertiesFrom(
+        std::make_shared<const std::vector<DBusProperty>>(
+            std::move(properties)),
+        0, callback);
+}
+
+void DBusHandler::getDbusPropertyVariantAsync(
+    const std::string& objPath, const std::string& dbusProp,
+    const std::string& dbusInterface,
+    std::function<void(std::optional<PropertyValue> value)> callback) const
+{
+    callServiceAsync(
+        objPath, dbusInterface,
+        [objPath, dbusProp, dbusInterface](const std::string& service) {
+        auto method = getBus().new_method_call(
+            service.c_str(), objPath.c_str(), dbusProperties, "Get");
+        method.append(dbusInterface, dbusProp);
+        return method;
+    },
+        [objPath, dbusProp, callback](sdbusplus::message_t* reply) {
+        std::optional<PropertyValue> value;
+        try
+        {
+            if (reply)
+            {
+                PropertyValue propertyValue{};
+                reply->read(propertyValue);
+                value = std::move(propertyValue);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(
+                "Failed to read the property, PATH={DBUS_OBJ_PATH} PROPERTY={DBUS_PROP} ERROR={ERR_EXCEP}",
+                "DBUS_OBJ_PATH", objPath, "DBUS_PROP", dbusProp, "ERR_EXCEP",
+                e.what());
+        }
+        callback(std::move(value));
+    });
+}
+
 PropertyValue DBusHandler::getDbusPropertyVariant(
     const char* objPath, const char* dbusProp, const char* dbusInterface) const
 {
@@ -617,25 +854,14 @@ uint16_t findStateSensorId(const pldm_pdr* pdrRepo, uint8_t tid,
     return PLDM_INVALID_EFFECTER_ID;
 }
 
-void printBuffer(bool isTx, const std::vector<uint8_t>& buffer)
+void printBuffer(bool isTx, std::span<const uint8_t> buffer)
 {
     if (!buffer.empty())
     {
-        if (isTx)
-        {
-            std::cout << "Tx: ";
-        }
-        else
-        {
-            std::cout << "Rx: ";
-        }
-        std::ostringstream tempStream;
-        for (int byte : buffer)
-        {
-            tempStream << std::setfill('0') << std::setw(2) << std::hex << byte
-                       << " ";
-        }
-        std::cout << tempStream.str() << std::endl;
+        std::string line(isTx ? "Tx: " : "Rx: ");
+        appendHex(line, buffer);
+        line.push_back('\n');
+        std::cout << line << std::flush;
     }
 }
 
@@ -962,5 +1188,53 @@ bool checkForFruPresence(const std::string& objPath)
     return isPresent;
 }
 
+namespace
+{
+
+/** @brief JSON files parsed ahead of time, by normalized path */
+std::map<std::string, Json>& getPreloadedJsons()
+{
+    static std::map<std::string, Json> preloadedJsons;
+    return preloadedJsons;
+}
+
+} // namespace
+
+void addPreloadedJson(const fs::path& path, Json&& json)
+{
+    getPreloadedJsons().insert_or_assign(path.lexically_normal().string(),
+                                         std::move(json));
+}
+
+std::optional<Json> takePreloadedJson(const fs::path& path)
+{
+    auto& preloadedJsons = getPreloadedJsons();
+    if (preloadedJsons.empty())
+    {
+        return std::nullopt;
+    }
+    auto node = preloadedJsons.extract(path.lexically_normal().string());
+    if (node.empty())
+    {
+        return std::nullopt;
+    }
+    return std::move(node.mapped());
+}
+
+void clearPreloadedJsons()
+{
+    getPreloadedJsons().clear();
+}
+
+Json parseJsonFile(const fs::path& path, bool allowExceptions)
+{
+    if (auto json = takePreloadedJson(path))
+    {
+        return std::move(*json);
+    }
+    std::ifstream jsonFile(path);
+    return Json::parse(jsonFile, nullptr, allowExceptions);
+}
+
 } // namespace utils
 } // namespace pldm
@@ -17,7 +17,10 @@
 
 #include <exception>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <optional>
+#include <span>
 #include <string>
 #include <variant>
 #include <vector>
@@ -169,6 +172,7 @@ using PropertyValue =
     std::variant<bool, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t,
                  uint64_t, double, std::string, std::vector<uint8_t>,
                  std::vector<std::string>>;
+using DBusProperty = std::pair<DBusMapping, PropertyValue>;
 using DbusProp = std::string;
 using DbusChangedProps = std::map<DbusProp, PropertyValue>;
 using DBusInterfaceAdded = std::vector<
@@ -304,6 +308,32 @@ class DBusHandler : public DBusHandlerInterface
     void setDbusProperty(const DBusMapping& dBusMap,
                          const PropertyValue& value) const override;
 
+    /** @brief Set Dbus properties without waiting for the replies
+     *
+     *  The properties are set one at a time, in order, and the setting stops
+     *  at the first one that fails.
+     *
+     *  @param[in] properties - D-Bus objects and the values to be set
+     *  @param[in] callback - invoked from the event loop once the properties
+     *                        are set, with false if one of them fails
+     */
+    void setDbusPropertiesAsync(std::vector<DBusProperty> properties,
+                                std::function<void(bool set)> callback) const;
+
+    /** @brief Get property(type: variant) from the requested dbus without
+     *         waiting for the reply
+     *
+     *  @param[in] objPath - The Dbus object path
+     *  @param[in] dbusProp - The property name to get
+     *  @param[in] dbusInterface - The Dbus interface
+     *  @param[in] callback - invoked from the event loop with the value of the
+     *                        property, std::nullopt if it fails
+     */
+    void getDbusPropertyVariantAsync(
+        const std::string& objPath, const std::string& dbusProp,
+        const std::string& dbusInterface,
+        std::function<void(std::optional<PropertyValue> value)> callback) const;
+
     /** @brief This function will returns all the objectspaths under the service
      * root path, with their interfaces and the properties under those
      * interfaces     *
@@ -425,6 +455,25 @@ int emitStateSensorEventSignal(uint8_t tid, uint16_t sensorId,
                                uint8_t sensorOffset, uint8_t eventState,
                                uint8_t previousEventState);
 
+/** @brief Append the hex encoding of a buffer to a string, as lower case
+ *         space separated bytes
+ *
+ *  @param[in,out] out - string to append to
+ *  @param[in] buffer - buffer to encode
+ */
+inline void appendHex(std::string& out, std::span<const uint8_t> buffer)
+{
+    static constexpr char digits[] = "0123456789abcdef";
+    auto pos = out.size();
+    out.resize(pos + buffer.size() * 3);
+    for (auto byte : buffer)
+    {
+        out[pos++] = digits[byte >> 4];
+        out[pos++] = digits[byte & 0x0F];
+        out[pos++] = ' ';
+    }
+}
+
 /** @brief Print the buffer
  *
  *  @param[in]  isTx - True if the buffer is an outgoing PLDM message, false if
@@ -433,7 +482,7 @@ int emitStateSensorEventSignal(uint8_t tid, uint16_t sensorId,
  *
  *  @return - None
  */
-void printBuffer(bool isTx, const std::vector<uint8_t>& buffer);
+void printBuffer(bool isTx, std::span<const uint8_t> buffer);
 
 /** @brief Convert the buffer to std::string
  *
@@ -543,5 +592,36 @@ std::vector<pldm::pdr::SensorID>
  */
 bool checkForFruPresence(const std::string& objPath);
 
+/** @brief Hand a JSON file parsed ahead of time over to parseJsonFile
+ *
+ *  The preloaded JSON files are only accessed on the event loop thread.
+ *
+ *  @param[in] path - path of the JSON file
+ *  @param[in] json - the parsed JSON file
+ */
+void addPreloadedJson(const fs::path& path, Json&& json);
+
+/** @brief Take the JSON file parsed ahead of time, if it was
+ *
+ *  @param[in] path - path of the JSON file
+ *
+ *  @return the parsed JSON file, std::nullopt if it was not preloaded or
+ *          was already taken
+ */
+std::optional<Json> takePreloadedJson(const fs::path& path);
+
+/** @brief Drop the JSON files parsed ahead of time that were not taken */
+void clearPreloadedJsons();
+
+/** @brief Parse a JSON file, or take it if it was parsed ahead of time
+ *
+ *  @param[in] path - path of the JSON file
+ *  @param[in] allowExceptions - throw on parse errors instead of returning
+ *                               a discarded value, as Json::parse does
+ *
+ *  @return the parsed JSON file
+ */
+Json parseJsonFile(const fs::path& path, bool allowExceptions = true);
+
 } // namespace utils
 } // namespace pldm
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "common/utils.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+
+/** @class WorkerPool
+ *
+ *  A bounded pool of worker threads for blocking work (file IO, DMA
+ *  transfers) that must not stall the PLDM daemon's event loop. The work runs
+ *  on a worker thread and its completion callback is marshalled back onto the
+ *  sdeventplus loop through an eventfd, so completions can safely touch
+ *  daemon state, send responses and make D-Bus calls.
+ *
+ *  Work submitted to the pool must only touch state that is safe to access
+ *  from another thread; in particular it must not use the D-Bus connection.
+ */
+class WorkerPool
+{
+  public:
+    /** @brief Blocking work, runs on a worker thread */
+    using Work = std::function<void()>;
+
+    /** @brief Completion of the work, runs on the event loop */
+    using Completion = std::function<void()>;
+
+    WorkerPool() = delete;
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    /** @brief Constructor
+     *
+     *  @param[in] event - reference to PLDM daemon's main event loop
+     *  @param[in] numThreads - number of worker threads
+     *  @param[in] maxInFlight - maximum number of submitted work items that
+     *                           have not completed yet
+     *
+     *  @throw std::system_error if the eventfd cannot be created
+     */
+    explicit WorkerPool(sdeventplus::Event& event,
+                        size_t numThreads = WORKER_THREADS,
+                        size_t maxInFlight = 64) :
+        maxInFlight(maxInFlight),
+        efd(createEventFd()),
+        io(event, efd(), EPOLLIN,
+           std::bind_front(&WorkerPool::dispatchCompletions, this))
+    {
+        workers.reserve(numThreads);
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            workers.emplace_back(&WorkerPool::run, this);
+        }
+    }
+
+    /** @brief Stops the workers, work that has not started yet and pending
+     *         completions are dropped.
+     */
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    /** @brief Submit blocking work to the pool
+     *
+     *  @param[in] work - work to run on a worker thread
+     *  @param[in] done - callback invoked on the event loop once the work has
+     *                    finished, it is invoked even if the work threw
+     *
+     *  @return true if the work was queued, false if the pool is saturated
+     *          and the caller should run the work inline or fail the request
+     */
+    bool submit(Work&& work, Completion&& done)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (stopping || inFlight >= maxInFlight)
+            {
+                return false;
+            }
+            ++inFlight;
+            jobs.emplace_back(std::move(work), std::move(done));
+        }
+        workAvailable.notify_one();
+        return true;
+    }
+
+    /** @brief Get the number of submitted work items not completed yet
+     *
+     *  @return number of in-flight work items
+     */
+    size_t pending()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return inFlight;
+    }
+
+  private:
+    /** @struct Job
+     *
+     *  Submitted work and the completion to run after it.
+     */
+    struct Job
+    {
+        Work work;
+        Completion done;
+    };
+
+    size_t maxInFlight;                    //!< bound on in-flight work items
+    size_t inFlight = 0;                   //!< work items not completed yet
+    bool stopping = false;                 //!< set when the pool is destroyed
+    std::mutex lock;                       //!< guards the queues and counters
+    std::condition_variable workAvailable; //!< signalled on submit and stop
+    std::deque<Job> jobs;                  //!< work waiting for a worker
+    std::deque<Completion> completions;    //!< completions for the event loop
+    pldm::utils::CustomFD efd;             //!< eventfd to wake up the loop
+    sdeventplus::source::IO io;            //!< event source for the eventfd
+    std::vector<std::thread> workers;      //!< worker threads
+
+    /** @brief Create the eventfd used to signal completions
+     *
+     *  @return eventfd
+     */
+    static int createEventFd()
+    {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(),
+                                    "Failed to create worker pool eventfd");
+        }
+        return fd;
+    }
+
+    /** @brief Worker thread main loop */
+    void run()
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                workAvailable.wait(
+                    guard, [this] { return stopping || !jobs.empty(); });
+                if (stopping)
+                {
+                    return;
+                }
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            try
+            {
+                job.work();
+            }
+            catch (const std::exception& e)
+            {
+                error("Worker pool job failed, ERROR={ERR_EXCEP}", "ERR_EXCEP",
+                      e.what());
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                completions.emplace_back(std::move(job.done));
+            }
+
+            uint64_t one = 1;
+            if (write(efd(), &one, sizeof(one)) < 0)
+            {
+                error("Failed to signal worker pool completion, RC={RC}", "RC",
+                      -errno);
+            }
+        }
+    }
+
+    /** @brief Run the completions of the finished work on the event loop
+     *
+     *  @param[in] source - eventfd event source
+     *  @param[in] fd - eventfd
+     *  @param[in] revents - returned events
+     */
+    void dispatchCompletions(sdeventplus::source::IO& /*source*/, int fd,
+                             uint32_t /*revents*/)
+    {
+        uint64_t count{};
+        if (read(fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+        {
+            error("Failed to read worker pool eventfd, RC={RC}", "RC", -errno);
+        }
+
+        std::deque<Completion> ready;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            ready.swap(completions);
+            inFlight -= ready.size();
+        }
+
+        for (auto& done : ready)
+        {
+            try
+            {
+                done();
+            }
+            catch (const std::exception& e)
+            {
+                error("Worker pool completion failed, ERROR={ERR_EXCEP}",
+                      "ERR_EXCEP", e.what());
+            }
+        }
+    }
+};
+
+} // namespace pldm
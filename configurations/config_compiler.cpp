@@ -0,0 +1,196 @@
+/** @file
+ *
+ *  Build-time compiler of the configuration JSONs into the compiled
+ *  configuration blob loaded by pldmd.
+ *
+ *  Usage: pldm-config-compiler OUTPUT DEPFILE INSTALLED=SOURCE...
+ *
+ *  SOURCE is a JSON file installed as INSTALLED, or a directory whose JSON
+ *  files are installed under the INSTALLED directory. A later SOURCE
+ *  replaces the JSON files of an earlier one installed to the same path.
+ *
+ *  The JSON files are installed with their size and modification time,
+ *  which pldmd checks to tell the blob still matches them. When
+ *  SOURCE_DATE_EPOCH is set, the modification times are clamped to it as
+ *  the packaging of a reproducible build does.
+ */
+
+#include "common/config_blob.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Json = nlohmann::json;
+using namespace pldm::config_blob;
+
+namespace
+{
+
+/** @brief Escape a path for a Makefile rule of the depfile
+ *
+ *  @param[in] path - the path
+ *
+ *  @return the escaped path
+ */
+std::string escape(const std::string& path)
+{
+    std::string escaped;
+    for (auto c : path)
+    {
+        if (c == ' ' || c == '#' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        else if (c == '$')
+        {
+            escaped += '$';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+/** @brief Compile a JSON file
+ *
+ *  @param[in] source - the JSON file
+ *  @param[in] sourceDateEpoch - latest modification time, if any
+ *
+ *  @return the stamp of the JSON file and its CBOR encoding
+ *
+ *  @throw std::exception if the JSON file is not valid
+ */
+CompiledJson compile(const fs::path& source,
+                     const std::optional<int64_t>& sourceDateEpoch)
+{
+    auto stamp = getStamp(source);
+    if (!stamp)
+    {
+        throw std::runtime_error("cannot stat the file");
+    }
+    if (sourceDateEpoch && stamp->modified > *sourceDateEpoch)
+    {
+        stamp->modified = *sourceDateEpoch;
+    }
+
+    std::ifstream jsonFile(source, std::ios::binary);
+    if (!jsonFile.is_open())
+    {
+        throw std::runtime_error("cannot open the file");
+    }
+    std::string text(std::istreambuf_iterator<char>(jsonFile), {});
+    auto json = Json::parse(text);
+    if (!json.is_object())
+    {
+        throw std::runtime_error("not a JSON object");
+    }
+    return {*stamp, Json::to_cbor(json)};
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " OUTPUT DEPFILE INSTALLED=SOURCE...\n";
+        return 1;
+    }
+    std::string output(argv[1]);
+    std::string depfile(argv[2]);
+
+    // Installed path to source path, a later source replaces an earlier one
+    std::map<std::string, fs::path> sources;
+    std::vector<fs::path> dirs;
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        auto pos = arg.find('=');
+        if (pos == std::string::npos)
+        {
+            std::cerr << "Missing '=' in " << arg << "\n";
+            return 1;
+        }
+        fs::path installed(arg.substr(0, pos));
+        fs::path source(arg.substr(pos + 1));
+
+        if (!fs::is_directory(source))
+        {
+            sources[installed.lexically_normal().string()] = source;
+            continue;
+        }
+        dirs.emplace_back(source);
+        for (const auto& dirEntry : fs::recursive_directory_iterator(source))
+        {
+            if (dirEntry.is_regular_file() &&
+                dirEntry.path().extension() == ".json")
+            {
+                auto path = installed /
+                            dirEntry.path().lexically_relative(source);
+                sources[path.lexically_normal().string()] = dirEntry.path();
+            }
+        }
+    }
+
+    std::optional<int64_t> sourceDateEpoch;
+    if (auto epoch = std::getenv("SOURCE_DATE_EPOCH"); epoch && *epoch)
+    {
+        sourceDateEpoch = std::strtoll(epoch, nullptr, 10);
+    }
+
+    std::map<std::string, CompiledJson> jsons;
+    for (const auto& [installed, source] : sources)
+    {
+        try
+        {
+            jsons.emplace(installed, compile(source, sourceDateEpoch));
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << source.string() << ": " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    auto blob = build(jsons);
+    std::ofstream os(output, std::ios::binary | std::ios::trunc);
+    os.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+    os.close();
+    if (!os)
+    {
+        std::cerr << "Failed to write " << output << "\n";
+        return 1;
+    }
+
+    // Rebuild the blob when a JSON file changes, or is added or removed
+    std::ofstream deps(depfile, std::ios::trunc);
+    deps << escape(output) << ":";
+    for (const auto& [installed, source] : sources)
+    {
+        deps << " " << escape(source.string());
+    }
+    for (const auto& dir : dirs)
+    {
+        deps << " " << escape(dir.string());
+    }
+    deps << "\n";
+    deps.close();
+    if (!deps)
+    {
+        std::cerr << "Failed to write " << depfile << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -38,8 +38,7 @@ void HostAssociationsParser::parseHostAssociations(const std::string& jsonPath)
         throw InternalFailure();
     }
 
-    std::ifstream jsonFile(jsonFilePath);
-    auto data = Json::parse(jsonFile, nullptr, false);
+    auto data = pldm::utils::parseJsonFile(jsonFilePath, false);
     if (data.is_discarded())
     {
         error("Parsing json file failed, FILE = {JSON_PATH}", "JSON_PATH",
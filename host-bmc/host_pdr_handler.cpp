@@ -118,8 +118,7 @@ HostPDRHandler::HostPDRHandler(
         // This will enable a merge of entity associations.
         try
         {
-            std::ifstream jsonFile(hostFruJson);
-            auto data = Json::parse(jsonFile, nullptr, false);
+            auto data = pldm::utils::parseJsonFile(hostFruJson, false);
             if (data.is_discarded())
             {
                 error("Parsing Host FRU json file failed");
@@ -183,6 +182,10 @@ HostPDRHandler::HostPDRHandler(
                 // state of all the dbus objects to false
                 this->setPresenceFrus();
                 pldm_pdr_remove_remote_pdrs(repo);
+                if (this->pdrRepoChangeHandler)
+                {
+                    this->pdrRepoChangeHandler();
+                }
                 pldm_entity_association_tree_destroy_root(entityTree);
                 pldm_entity_association_tree_copy_root(bmcEntityTree,
                                                        entityTree);
@@ -333,8 +336,8 @@ void HostPDRHandler::getHostPDR(uint32_t nextRecordHandle)
 {
     pdrFetchEvent.reset();
 
-    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
-                                    PLDM_GET_PDR_REQ_BYTES);
+    auto requestMsg = handler->allocRequest(sizeof(pldm_msg_hdr) +
+                                            PLDM_GET_PDR_REQ_BYTES);
     auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
     uint32_t recordHandle{};
     if (!nextRecordHandle && (!modifiedPDRRecordHandles.empty()) &&
@@ -967,6 +970,10 @@ void HostPDRHandler::processHostPDRs(mctp_eid_t /*eid*/,
             }
         }
     }
+    if (pdrRepoChangeHandler)
+    {
+        pdrRepoChangeHandler();
+    }
     if (!nextRecordHandle)
     {
         pldm_pdr_record* firstRecord = repo->first;
@@ -1464,18 +1471,17 @@ void HostPDRHandler::getPresentStateBySensorReadigs(
     pldm::pdr::StateSetId stateSetId)
 {
     auto mctpEid = getMctpEID(tid);
-    auto instanceId = requester.getInstanceId(mctpEid);
-    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
-                                    PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES);
+    auto requestMsg = handler->allocRequest(
+        sizeof(pldm_msg_hdr) + PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES);
 
+    // The instance ID is set by the request handler when the request is
+    // sent through the request window of the endpoint
     auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
     bitfield8_t bf;
     bf.byte = 0;
-    auto rc = encode_get_state_sensor_readings_req(instanceId, sensorId, bf, 0,
-                                                   request);
+    auto rc = encode_get_state_sensor_readings_req(0, sensorId, bf, 0, request);
     if (rc != PLDM_SUCCESS)
     {
-        requester.markFree(mctpEid, instanceId);
         error("Failed to encode_get_state_sensor_readings_req, rc = {RC}", "RC",
               rc);
         return;
@@ -1576,10 +1582,12 @@ void HostPDRHandler::getPresentStateBySensorReadigs(
         setOperationStatus();
     };
 
-    rc = handler->registerRequest(
-        mctpEid, instanceId, PLDM_PLATFORM, PLDM_GET_STATE_SENSOR_READINGS,
-        std::move(requestMsg),
-        std::move(getStateSensorReadingsResponseHandler));
+    // Sensor state polling is background work, let other requests to the
+    // endpoint go first
+    rc = handler->scheduleRequest(
+        mctpEid, std::move(requestMsg),
+        std::move(getStateSensorReadingsResponseHandler),
+        pldm::requester::RequestPriority::Low);
     if (rc != PLDM_SUCCESS)
     {
         error("Failed to get the State Sensor Readings request");
@@ -1988,6 +1996,10 @@ void HostPDRHandler::deletePDRFromRepo(PDRRecordHandles&& recordHandles)
         this->setRecordPresent(recordHandle);
         pldm_delete_by_record_handle(repo, recordHandle, true);
     }
+    if (pdrRepoChangeHandler)
+    {
+        pdrRepoChangeHandler();
+    }
 }
 
 void HostPDRHandler::updateObjectPathMaps(const std::string& path,
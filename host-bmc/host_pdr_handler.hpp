@@ -20,6 +20,7 @@
 
 #include <deque>
 #include <filesystem>
+#include <functional>
 #include <map>
 #include <memory>
 #include <vector>
@@ -114,6 +115,16 @@ class HostPDRHandler
 
     void deletePDRFromRepo(PDRRecordHandles&& recordHandles);
 
+    /** @brief Set the function called whenever host PDRs are added to or
+     *         removed from the BMC's primary PDR repo
+     *
+     *  @param[in] handler - the function
+     */
+    void setPdrRepoChangeHandler(std::function<void()> handler)
+    {
+        pdrRepoChangeHandler = std::move(handler);
+    }
+
     /** @brief Send a PLDM event to host firmware containing a list of record
      *  handles of PDRs that the host firmware has to fetch.
      *  @param[in] pdrTypes - list of PDR types that need to be looked up in the
@@ -437,6 +448,9 @@ class HostPDRHandler
     /** @OEM platform handler */
     pldm::responder::oem_platform::Handler* oemPlatformHandler;
 
+    /** @brief Called whenever host PDRs are added or removed */
+    std::function<void()> pdrRepoChangeHandler;
+
     /** @brief Object path and entity association and is only loaded once
      */
     bool objPathEntityAssociation;
@@ -242,8 +242,9 @@ Response Handler::getBIOSTable(const pldm_msg* request, size_t payloadLength)
         return ccOnlyResponse(request, PLDM_BIOS_TABLE_UNAVAILABLE);
     }
 
-    Response response(sizeof(pldm_msg_hdr) +
-                      PLDM_GET_BIOS_TABLE_MIN_RESP_BYTES + table->size());
+    auto response = allocResponse(sizeof(pldm_msg_hdr) +
+                                  PLDM_GET_BIOS_TABLE_MIN_RESP_BYTES +
+                                  table->size());
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
     rc = encode_get_bios_table_resp(
@@ -683,14 +683,12 @@ std::optional<Table> BIOSConfig::loadTable(const fs::path& path)
 
 void BIOSConfig::load(const fs::path& filePath, ParseHandler handler)
 {
-    std::ifstream file;
     Json jsonConf;
     if (fs::exists(filePath))
     {
         try
         {
-            file.open(filePath);
-            jsonConf = Json::parse(file);
+            jsonConf = pldm::utils::parseJsonFile(filePath);
             auto entries = jsonConf.at("entries");
             for (auto& entry : entries)
             {
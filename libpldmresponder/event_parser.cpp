@@ -36,9 +36,7 @@ StateSensorHandler::StateSensorHandler(const std::string& dirPath)
 
     for (auto& file : fs::directory_iterator(dirPath))
     {
-        std::ifstream jsonFile(file.path());
-
-        auto data = Json::parse(jsonFile, nullptr, false);
+        auto data = pldm::utils::parseJsonFile(file.path(), false);
         if (data.is_discarded())
         {
             error("Parsing Event state sensor JSON file failed, FILE={FILE}",
@@ -404,6 +404,7 @@ void FruImpl::removeIndividualFRU(const std::string& fruObjPath)
 
     auto deleteRecordHdl = pldm_pdr_remove_fru_record_set_by_rsi(pdrRepo, rsi,
                                                                  false);
+    invalidatePdrRepo();
 
     // sm00
     /* std::cout << "\nprinting the entityTree before deleting node\n";
@@ -447,6 +448,7 @@ void FruImpl::removeIndividualFRU(const std::string& fruObjPath)
     for (const auto& ids : effecterIDs)
     {
         auto delEffecterHdl = pldm_delete_by_effecter_id(pdrRepo, ids, false);
+        invalidatePdrRepo();
         effecterDbusObjMaps.erase(ids);
         if (delEffecterHdl != 0)
         {
@@ -460,6 +462,7 @@ void FruImpl::removeIndividualFRU(const std::string& fruObjPath)
     for (const auto& ids : sensorIDs)
     {
         auto delSensorHdl = pldm_delete_by_sensor_id(pdrRepo, ids, false);
+        invalidatePdrRepo();
         sensorDbusObjMaps.erase(ids);
         if (delSensorHdl != 0)
         {
@@ -653,6 +656,7 @@ void FruImpl::buildIndividualFRU(const std::string& fruInterface,
         pldm_entity_association_pdr_add_contained_entity(
             pdrRepo, entity, parentEntity, &hostEventDataOps, true,
             last_bmc_record_handle);
+    invalidatePdrRepo();
 
     // create the relevant state effecter and sensor PDRs for the new fru record
     std::vector<uint32_t> recordHdlList;
@@ -771,21 +775,26 @@ void FruImpl::reGenerateStatePDR(const std::string& fruObjectPath,
 void FruImpl::getFRUTable(Response& response)
 {
     auto hdrSize = response.size();
-    std::vector<uint8_t> tempTable;
+    size_t tableSize = 0;
 
     if (table.size())
     {
-        std::copy(table.begin(), table.end(), std::back_inserter(tempTable));
         padBytes = pldm::utils::getNumPadBytes(table.size());
-        tempTable.resize(tempTable.size() + padBytes, 0);
+        tableSize = table.size() + padBytes;
+    }
 
-        checksum = crc32(tempTable.data(), tempTable.size());
+    // Encode the padded table directly into the response buffer instead of
+    // staging it in a temporary copy.
+    response.resize(hdrSize + tableSize + sizeof(checksum), 0);
+    auto tableStart = response.begin() + hdrSize;
+    if (tableSize)
+    {
+        std::copy(table.begin(), table.end(), tableStart);
+        checksum = crc32(response.data() + hdrSize, tableSize);
     }
-    response.resize(hdrSize + tempTable.size() + sizeof(checksum), 0);
-    std::copy(tempTable.begin(), tempTable.end(), response.begin() + hdrSize);
 
     // Copy the checksum to response data
-    auto iter = response.begin() + hdrSize + tempTable.size();
+    auto iter = tableStart + tableSize;
     std::copy_n(reinterpret_cast<const uint8_t*>(&checksum), sizeof(checksum),
                 iter);
 }
@@ -1457,9 +1466,11 @@ uint32_t
     lastHandle = lastLocalRecord->record_handle;
 #endif
     pdrEntry.handle.recordHandle = lastHandle + 1;
-    return pldm_pdr_add_hotplug_record(pdrRepo, pdrEntry.data, pdrEntry.size,
-                                       pdrEntry.handle.recordHandle, false,
-                                       lastHandle, TERMINUS_HANDLE);
+    auto recordHandle = pldm_pdr_add_hotplug_record(
+        pdrRepo, pdrEntry.data, pdrEntry.size, pdrEntry.handle.recordHandle,
+        false, lastHandle, TERMINUS_HANDLE);
+    invalidatePdrRepo();
+    return recordHandle;
 }
 
 namespace fru
@@ -1504,8 +1515,8 @@ Response Handler::getFRURecordTable(const pldm_msg* request,
         return ccOnlyResponse(request, PLDM_ERROR_INVALID_LENGTH);
     }
 
-    Response response(
-        sizeof(pldm_msg_hdr) + PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES, 0);
+    auto response = allocResponse(sizeof(pldm_msg_hdr) +
+                                  PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
     auto rc = encode_get_fru_record_table_resp(request->hdr.instance_id,
@@ -1557,7 +1568,7 @@ Response Handler::getFRURecordByOption(const pldm_msg* request,
 
     auto respPayloadLength = PLDM_GET_FRU_RECORD_BY_OPTION_MIN_RESP_BYTES +
                              fruData.size();
-    Response response(sizeof(pldm_msg_hdr) + respPayloadLength, 0);
+    auto response = allocResponse(sizeof(pldm_msg_hdr) + respPayloadLength);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
     rc = encode_get_fru_record_by_option_resp(
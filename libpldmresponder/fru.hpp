@@ -218,6 +218,16 @@ class FruImpl
      */
     int setFRUTable(const std::vector<uint8_t>& fruData);
 
+    /** @brief Set the wrapper of the PDR repository whose PDR lists are
+     *         dropped when the FRU PDRs are added or removed
+     *
+     *  @param[in] repo - the wrapper of the PDR repository
+     */
+    void setPdrRepo(pldm::responder::pdr_utils::Repo* repo)
+    {
+        indexedRepo = repo;
+    }
+
     /* @brief Send a PLDM event to host firmware containing a list of record
      *        handles of PDRs that the host firmware has to fetch.
      * @param[in] pdrRecordHandles - list of PDR record handles
@@ -257,6 +267,7 @@ class FruImpl
 
     fru_parser::FruParser parser;
     pldm_pdr* pdrRepo;
+    pldm::responder::pdr_utils::Repo* indexedRepo = nullptr;
     pldm_entity_association_tree* entityTree;
     pldm_entity_association_tree* bmcEntityTree;
     pldm::responder::oem_fru::Handler* oemFruHandler;
@@ -344,6 +355,17 @@ class FruImpl
 
     uint32_t addHotPlugRecord(pldm::responder::pdr_utils::PdrEntry pdrEntry);
 
+    /** @brief Drop the PDR lists of the PDR repository wrapper once the PDRs
+     *         were changed directly
+     */
+    void invalidatePdrRepo()
+    {
+        if (indexedRepo)
+        {
+            indexedRepo->invalidate();
+        }
+    }
+
     /** @brief Associate sensor/effecter to FRU entity
      */
     dbus::AssociatedEntityMap associatedEntityMap;
@@ -426,6 +448,16 @@ class Handler : public CmdHandler
         impl.buildFRUTable();
     }
 
+    /** @brief Set the wrapper of the PDR repository whose PDR lists are
+     *         dropped when the FRU PDRs are added or removed
+     *
+     *  @param[in] repo - the wrapper of the PDR repository
+     */
+    void setPdrRepo(pldm::responder::pdr_utils::Repo* repo)
+    {
+        impl.setPdrRepo(repo);
+    }
+
     /** @brief Get std::map associated with the entity
      *         key: object path
      *         value: pldm_entity
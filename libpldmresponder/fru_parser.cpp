@@ -1,5 +1,7 @@
 #include "fru_parser.hpp"
 
+#include "common/utils.hpp"
+
 #include <nlohmann/json.hpp>
 #include <phosphor-logging/lg2.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
@@ -46,8 +48,7 @@ void FruParser::setupDefaultDBusLookup(const fs::path& masterJsonPath)
 {
     constexpr auto service = "xyz.openbmc_project.Inventory.Manager";
     constexpr auto rootPath = "/xyz/openbmc_project/inventory";
-    std::ifstream jsonFile(masterJsonPath);
-    auto data = Json::parse(jsonFile, nullptr, false);
+    auto data = pldm::utils::parseJsonFile(masterJsonPath, false);
     if (data.is_discarded())
     {
         error(
@@ -116,8 +117,7 @@ void FruParser::setupFruRecordMap(const std::string& dirPath)
     for (auto& file : fs::directory_iterator(dirPath))
     {
         auto fileName = file.path().filename().string();
-        std::ifstream jsonFile(file.path());
-        auto data = Json::parse(jsonFile, nullptr, false);
+        auto data = pldm::utils::parseJsonFile(file.path(), false);
         if (data.is_discarded())
         {
             error("Parsing FRU config file failed, FILE={FILE}", "FILE",
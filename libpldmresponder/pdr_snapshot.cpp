@@ -0,0 +1,311 @@
+#include "pdr_snapshot.hpp"
+
+#include "common/utils.hpp"
+
+#include <fcntl.h>
+#include <libpldm/pdr.h>
+#include <libpldm/platform.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/tuple.hpp>
+#include <cereal/types/variant.hpp>
+#include <cereal/types/vector.hpp>
+#include <phosphor-logging/lg2.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+namespace utils
+{
+
+template <class Archive>
+void serialize(Archive& archive, DBusMapping& dbusMapping)
+{
+    archive(dbusMapping.objectPath, dbusMapping.interface,
+            dbusMapping.propertyName, dbusMapping.propertyType);
+}
+
+} // namespace utils
+
+namespace responder
+{
+namespace pdr_snapshot
+{
+namespace
+{
+
+/** @brief "PLDMPDRS" */
+constexpr uint64_t snapshotMagic = 0x53524450444d4c50;
+
+/** @brief Bumped whenever the layout of the snapshot changes */
+constexpr uint32_t snapshotVersion = 1;
+
+/** @struct Header
+ *
+ *  The header of the snapshot is followed by the PDRs, each prefixed with
+ *  its size as an uint32_t, and by the D-Bus mappings of the sensors and
+ *  effecters in a cereal binary archive.
+ */
+struct Header
+{
+    uint64_t magic;          //!< snapshotMagic
+    uint32_t version;        //!< snapshotVersion
+    uint32_t recordCount;    //!< number of PDRs
+    uint64_t key;            //!< key of the snapshot
+    uint64_t recordsSize;    //!< size of the PDRs and their sizes in bytes
+    uint16_t nextSensorId;   //!< last sensor ID assigned
+    uint16_t nextEffecterId; //!< last effecter ID assigned
+};
+
+/** @class Hash
+ *
+ *  64-bit FNV-1a, the key of a snapshot must not change from one run of
+ *  pldmd to the next
+ */
+class Hash
+{
+  public:
+    void update(const void* data, size_t size)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            value ^= bytes[i];
+            value *= 0x100000001b3;
+        }
+    }
+
+    template <typename T>
+    void update(const T& data)
+    {
+        update(&data, sizeof(data));
+    }
+
+    void update(const std::string& data)
+    {
+        update(data.size());
+        update(data.data(), data.size());
+    }
+
+    uint64_t value = 0xcbf29ce484222325;
+};
+
+/** @class MappedBuf
+ *
+ *  Stream buffer reading from the memory-mapped snapshot
+ */
+class MappedBuf : public std::streambuf
+{
+  public:
+    MappedBuf(const uint8_t* begin, const uint8_t* end)
+    {
+        auto data = reinterpret_cast<char*>(const_cast<uint8_t*>(begin));
+        setg(data, data, data + (end - begin));
+    }
+};
+
+} // namespace
+
+uint64_t getKey(const std::vector<fs::path>& dirs, uint16_t nextSensorId,
+                uint16_t nextEffecterId)
+{
+    Hash hash;
+    hash.update(snapshotVersion);
+
+    // A new pldmd may generate the PDRs differently
+    struct stat sb;
+    if (stat("/proc/self/exe", &sb) == 0)
+    {
+        hash.update(sb.st_dev);
+        hash.update(sb.st_ino);
+        hash.update(sb.st_size);
+        hash.update(sb.st_mtim.tv_sec);
+        hash.update(sb.st_mtim.tv_nsec);
+    }
+
+    hash.update(nextSensorId);
+    hash.update(nextEffecterId);
+    hash.update(static_cast<uint16_t>(TERMINUS_HANDLE));
+
+    // The PDR JSON files in the order the PDRs are generated from them
+    for (const auto& dir : dirs)
+    {
+        hash.update(dir.string());
+        std::error_code ec;
+        for (const auto& dirEntry : fs::directory_iterator(dir, ec))
+        {
+            if (!fs::is_regular_file(dirEntry.path()))
+            {
+                continue;
+            }
+            std::ifstream jsonFile(dirEntry.path(), std::ios::binary);
+            std::string json(std::istreambuf_iterator<char>(jsonFile), {});
+            hash.update(dirEntry.path().filename().string());
+            hash.update(json);
+        }
+    }
+
+    return hash.value;
+}
+
+bool load(const fs::path& file, uint64_t key, pdr_utils::Repo& repo,
+          Contents& contents)
+{
+    int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return false;
+    }
+    pldm::utils::CustomFD snapshotFd(fd);
+    struct stat sb;
+    if (fstat(fd, &sb) == -1 ||
+        static_cast<size_t>(sb.st_size) < sizeof(Header))
+    {
+        return false;
+    }
+    size_t size = sb.st_size;
+
+    auto snapshotCleanup = [size](void* snapshot) { munmap(snapshot, size); };
+    void* snapshot = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == snapshot)
+    {
+        error("mmap on PDR snapshot failed, RC={RC}", "RC", -errno);
+        return false;
+    }
+    std::unique_ptr<void, decltype(snapshotCleanup)> snapshotPtr(
+        snapshot, snapshotCleanup);
+    auto data = static_cast<const uint8_t*>(snapshot);
+
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != snapshotMagic || header.version != snapshotVersion ||
+        header.key != key || header.recordsSize > size - sizeof(header))
+    {
+        info("PDR snapshot {PATH} is out of date", "PATH", file.string());
+        return false;
+    }
+
+    // Check all the PDRs before adding any to the repository
+    std::vector<pdr_utils::PdrEntry> records;
+    records.reserve(header.recordCount);
+    size_t offset = sizeof(header);
+    size_t recordsEnd = offset + header.recordsSize;
+    for (uint32_t i = 0; i < header.recordCount; ++i)
+    {
+        uint32_t recordSize{};
+        if (recordsEnd - offset < sizeof(recordSize))
+        {
+            break;
+        }
+        std::memcpy(&recordSize, data + offset, sizeof(recordSize));
+        offset += sizeof(recordSize);
+        if (recordSize < sizeof(pldm_pdr_hdr) ||
+            recordsEnd - offset < recordSize)
+        {
+            break;
+        }
+
+        pdr_utils::PdrEntry pdrEntry{};
+        pdrEntry.data = const_cast<uint8_t*>(data + offset);
+        pdrEntry.size = recordSize;
+        records.emplace_back(pdrEntry);
+        offset += recordSize;
+    }
+    if (records.size() != header.recordCount || offset != recordsEnd)
+    {
+        error("PDR snapshot {PATH} is corrupted", "PATH", file.string());
+        return false;
+    }
+
+    try
+    {
+        MappedBuf buf(data + recordsEnd, data + size);
+        std::istream stream(&buf);
+        cereal::BinaryInputArchive archive(stream);
+        archive(contents.sensorDbusObjMaps, contents.effecterDbusObjMaps);
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to read PDR snapshot {PATH}, ERROR={ERR_EXCEP}", "PATH",
+              file.string(), "ERR_EXCEP", e.what());
+        return false;
+    }
+    contents.nextSensorId = header.nextSensorId;
+    contents.nextEffecterId = header.nextEffecterId;
+
+    for (const auto& pdrEntry : records)
+    {
+        repo.addRecord(pdrEntry);
+    }
+    return true;
+}
+
+void save(const fs::path& file, uint64_t key,
+          const std::vector<pdr_utils::PdrEntry>& records,
+          const Contents& contents)
+{
+    Header header{};
+    header.magic = snapshotMagic;
+    header.version = snapshotVersion;
+    header.recordCount = records.size();
+    header.key = key;
+    for (const auto& pdrEntry : records)
+    {
+        header.recordsSize += sizeof(uint32_t) + pdrEntry.size;
+    }
+    header.nextSensorId = contents.nextSensorId;
+    header.nextEffecterId = contents.nextEffecterId;
+
+    // Write a new file and rename it over the snapshot, so that a crash
+    // never leaves a partial snapshot behind
+    auto tmpFile = file;
+    tmpFile += ".tmp";
+    try
+    {
+        if (file.has_parent_path())
+        {
+            fs::create_directories(file.parent_path());
+        }
+        std::ofstream os(tmpFile, std::ios::binary | std::ios::trunc);
+        os.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& pdrEntry : records)
+        {
+            uint32_t recordSize = pdrEntry.size;
+            os.write(reinterpret_cast<const char*>(&recordSize),
+                     sizeof(recordSize));
+            os.write(reinterpret_cast<const char*>(pdrEntry.data),
+                     pdrEntry.size);
+        }
+        {
+            cereal::BinaryOutputArchive archive(os);
+            archive(contents.sensorDbusObjMaps, contents.effecterDbusObjMaps);
+        }
+        os.close();
+        fs::rename(tmpFile, file);
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to save PDR snapshot {PATH}, ERROR={ERR_EXCEP}", "PATH",
+              file.string(), "ERR_EXCEP", e.what());
+        std::error_code ec;
+        fs::remove(tmpFile, ec);
+    }
+}
+
+} // namespace pdr_snapshot
+} // namespace responder
+} // namespace pldm
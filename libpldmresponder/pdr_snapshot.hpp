@@ -0,0 +1,76 @@
+#pragma once
+
+#include "pdr_utils.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace pldm
+{
+namespace responder
+{
+namespace pdr_snapshot
+{
+namespace fs = std::filesystem;
+
+/** @struct Contents
+ *
+ *  What generating the PDRs from the PDR JSONs leaves in the platform
+ *  handler, besides the PDRs
+ */
+struct Contents
+{
+    uint16_t nextSensorId;                      //!< last sensor ID assigned
+    uint16_t nextEffecterId;                    //!< last effecter ID assigned
+    pdr_utils::DbusObjMaps sensorDbusObjMaps;   //!< sensor D-Bus mappings
+    pdr_utils::DbusObjMaps effecterDbusObjMaps; //!< effecter D-Bus mappings
+};
+
+/** @brief Compute the key of the snapshot of the PDRs generated from the PDR
+ *         JSONs
+ *
+ *  The key covers the format of the snapshot, the pldmd executable, the
+ *  names and the contents of the PDR JSON files, and the sensor and
+ *  effecter IDs the generation starts from.
+ *
+ *  @param[in] dirs - directories housing the PDR JSON files
+ *  @param[in] nextSensorId - last sensor ID assigned before the generation
+ *  @param[in] nextEffecterId - last effecter ID assigned before the
+ *                              generation
+ *
+ *  @return the key of the snapshot
+ */
+uint64_t getKey(const std::vector<fs::path>& dirs, uint16_t nextSensorId,
+                uint16_t nextEffecterId);
+
+/** @brief Load the PDRs of a snapshot into the PDR repository
+ *
+ *  The snapshot file is memory-mapped and its PDRs are added to the
+ *  repository straight from the mapping.
+ *
+ *  @param[in] file - snapshot file
+ *  @param[in] key - key the snapshot must have been saved with
+ *  @param[out] repo - PDR repository the PDRs are added to
+ *  @param[out] contents - the rest of the snapshot
+ *
+ *  @return true if the snapshot was loaded, false if there is no snapshot
+ *          with the key and nothing was added to the repository
+ */
+bool load(const fs::path& file, uint64_t key, pdr_utils::Repo& repo,
+          Contents& contents);
+
+/** @brief Save a snapshot of the PDRs generated from the PDR JSONs
+ *
+ *  @param[in] file - snapshot file, replaced atomically
+ *  @param[in] key - key of the snapshot
+ *  @param[in] records - the PDRs, in the order they were added
+ *  @param[in] contents - the rest of the snapshot
+ */
+void save(const fs::path& file, uint64_t key,
+          const std::vector<pdr_utils::PdrEntry>& records,
+          const Contents& contents);
+
+} // namespace pdr_snapshot
+} // namespace responder
+} // namespace pldm
@@ -9,6 +9,7 @@
 
 #include <bitset>
 #include <climits>
+#include <cstddef>
 
 PHOSPHOR_LOG2_USING;
 
@@ -20,6 +21,17 @@ namespace responder
 {
 namespace pdr_utils
 {
+namespace
+{
+
+/** @brief Key of a sensor or effecter PDR in the ID indexes of Repo */
+constexpr uint32_t idKey(Type pdrType, uint16_t id)
+{
+    return (static_cast<uint32_t>(pdrType) << 16) | id;
+}
+
+} // namespace
+
 pldm_pdr* Repo::getPdr() const
 {
     return repo;
@@ -35,9 +47,118 @@ RecordHandle Repo::addRecord(const PdrEntry& pdrEntry)
         // pldm_pdr_add() assert()ed on failure to add PDR
         throw std::runtime_error("Failed to add PDR");
     }
+    if (changeHandler)
+    {
+        changeHandler();
+    }
+
+    if (!indexed)
+    {
+        // Listed along with the rest of the repository on the next lookup
+        return handle;
+    }
+
+    // The record is appended, after the last one added here and the ones
+    // added to the repository directly since
+    PdrEntry entry{};
+    uint8_t* pdrData = nullptr;
+    auto record = lastRecord
+                      ? pldm_pdr_get_next_record(repo, lastRecord, &pdrData,
+                                                 &entry.size,
+                                                 &entry.handle.nextRecordHandle)
+                      : pldm_pdr_find_record(repo, 0, &pdrData, &entry.size,
+                                             &entry.handle.nextRecordHandle);
+    while (record && pldm_pdr_get_record_handle(repo, record) != handle)
+    {
+        record = pldm_pdr_get_next_record(repo, record, &pdrData, &entry.size,
+                                          &entry.handle.nextRecordHandle);
+    }
+    if (record)
+    {
+        lastRecord = record;
+        entry.data = pdrData;
+        entry.handle.recordHandle = handle;
+        index(entry);
+    }
     return handle;
 }
 
+void Repo::index(const PdrEntry& entry) const
+{
+    auto hdr = reinterpret_cast<const pldm_pdr_hdr*>(entry.data);
+    recordsByType[hdr->type].emplace_back(entry);
+
+    // The first PDR with an ID wins, as it did for a walk of the PDRs
+    switch (hdr->type)
+    {
+        case PLDM_STATE_SENSOR_PDR:
+            if (entry.size >=
+                offsetof(pldm_state_sensor_pdr, sensor_id) + sizeof(uint16_t))
+            {
+                auto pdr =
+                    reinterpret_cast<const pldm_state_sensor_pdr*>(entry.data);
+                sensorRecords.try_emplace(idKey(hdr->type, pdr->sensor_id),
+                                          entry);
+            }
+            break;
+        case PLDM_STATE_EFFECTER_PDR:
+            if (entry.size >= offsetof(pldm_state_effecter_pdr, effecter_id) +
+                                  sizeof(uint16_t))
+            {
+                auto pdr = reinterpret_cast<const pldm_state_effecter_pdr*>(
+                    entry.data);
+                effecterRecords.try_emplace(idKey(hdr->type, pdr->effecter_id),
+                                            entry);
+            }
+            break;
+        case PLDM_NUMERIC_EFFECTER_PDR:
+            if (entry.size >=
+                offsetof(pldm_numeric_effecter_value_pdr, effecter_id) +
+                    sizeof(uint16_t))
+            {
+                auto pdr =
+                    reinterpret_cast<const pldm_numeric_effecter_value_pdr*>(
+                        entry.data);
+                effecterRecords.try_emplace(idKey(hdr->type, pdr->effecter_id),
+                                            entry);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void Repo::rebuild() const
+{
+    if (indexed)
+    {
+        return;
+    }
+    indexed = true;
+
+    PdrEntry entry{};
+    uint8_t* pdrData = nullptr;
+    auto record = pldm_pdr_find_record(repo, 0, &pdrData, &entry.size,
+                                       &entry.handle.nextRecordHandle);
+    while (record)
+    {
+        auto hdr = reinterpret_cast<const pldm_pdr_hdr*>(pdrData);
+        // The entity association and FRU record set PDRs are updated in
+        // place by the FRU code, they are not looked up here
+        if (!pldm_pdr_record_is_remote(record) &&
+            hdr->type != PLDM_PDR_ENTITY_ASSOCIATION &&
+            hdr->type != PLDM_PDR_FRU_RECORD_SET)
+        {
+            entry.data = pdrData;
+            entry.handle.recordHandle = pldm_pdr_get_record_handle(repo,
+                                                                   record);
+            index(entry);
+        }
+        record = pldm_pdr_get_next_record(repo, record, &pdrData, &entry.size,
+                                          &entry.handle.nextRecordHandle);
+    }
+}
+
 const pldm_pdr_record* Repo::getFirstRecord(PdrEntry& pdrEntry)
 {
     constexpr uint32_t firstNum = 0;
@@ -83,6 +204,57 @@ bool Repo::empty()
     return !getRecordCount();
 }
 
+const std::vector<PdrEntry>& Repo::getRecordsByType(Type pdrType) const
+{
+    static const std::vector<PdrEntry> none;
+    rebuild();
+    auto it = recordsByType.find(pdrType);
+    return it == recordsByType.end() ? none : it->second;
+}
+
+const PdrEntry* Repo::getRecordBySensorId(Type pdrType,
+                                          uint16_t sensorId) const
+{
+    rebuild();
+    auto it = sensorRecords.find(idKey(pdrType, sensorId));
+    return it == sensorRecords.end() ? nullptr : &it->second;
+}
+
+const PdrEntry* Repo::getRecordByEffecterId(Type pdrType,
+                                            uint16_t effecterId) const
+{
+    rebuild();
+    auto it = effecterRecords.find(idKey(pdrType, effecterId));
+    return it == effecterRecords.end() ? nullptr : &it->second;
+}
+
+void Repo::removeRecordsByTerminusHandle(uint16_t terminusHandle)
+{
+    pldm_pdr_remove_pdrs_by_terminus_handle(repo, terminusHandle);
+    if (terminusHandle == TERMINUS_HANDLE)
+    {
+        invalidate();
+    }
+    else if (changeHandler)
+    {
+        changeHandler();
+    }
+}
+
+void Repo::invalidate()
+{
+    recordsByType.clear();
+    sensorRecords.clear();
+    effecterRecords.clear();
+    lastRecord = nullptr;
+    indexed = false;
+    ++invalidations;
+    if (changeHandler)
+    {
+        changeHandler();
+    }
+}
+
 StatestoDbusVal populateMapping(const std::string& type, const Json& dBusValues,
                                 const PossibleValues& pv)
 {
@@ -15,7 +15,10 @@
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 PHOSPHOR_LOG2_USING;
 
@@ -98,6 +101,11 @@ inline Json readJson(const std::string& path)
         throw InternalFailure();
     }
 
+    if (auto json = pldm::utils::takePreloadedJson(path))
+    {
+        return std::move(*json);
+    }
+
     std::ifstream jsonFile(path);
     if (!jsonFile.is_open())
     {
@@ -198,7 +206,13 @@ class RepoInterface
  *
  *  Wrapper class to handle the PDR APIs
  *
- *  This class wraps operations used to handle PDR APIs.
+ *  This class wraps operations used to handle PDR APIs. The local PDRs are
+ *  also listed per PDR type, and the sensor and effecter PDRs are indexed
+ *  by their ID, so that the command handlers look them up in place instead
+ *  of copying them to a new repository. The PDRs added through it are
+ *  listed as they are added. Code changing the local PDRs of the
+ *  repository directly must call invalidate(), the lists are then rebuilt
+ *  from the repository on the next lookup.
  */
 class Repo : public RepoInterface
 {
@@ -219,6 +233,97 @@ class Repo : public RepoInterface
     uint32_t getRecordCount() override;
 
     bool empty() override;
+
+    /** @brief Get the local PDRs of a type, in the order of the repository
+     *
+     *  @param[in] pdrType - the type of PDRs
+     *
+     *  @return PDR entries (data, size, recordHandle), the data refers to the
+     *          records of the PDR repository
+     */
+    const std::vector<PdrEntry>& getRecordsByType(Type pdrType) const;
+
+    /** @brief Get the local sensor PDR of a type
+     *
+     *  @param[in] pdrType - the type of the sensor PDR
+     *  @param[in] sensorId - sensor ID
+     *
+     *  @return the PDR entry, nullptr if there is no such sensor PDR
+     */
+    const PdrEntry* getRecordBySensorId(Type pdrType, uint16_t sensorId) const;
+
+    /** @brief Get the local effecter PDR of a type
+     *
+     *  @param[in] pdrType - the type of the effecter PDR
+     *  @param[in] effecterId - effecter ID
+     *
+     *  @return the PDR entry, nullptr if there is no such effecter PDR
+     */
+    const PdrEntry* getRecordByEffecterId(Type pdrType,
+                                          uint16_t effecterId) const;
+
+    /** @brief Remove the PDRs of a terminus from the PDR repository
+     *
+     *  @param[in] terminusHandle - terminus handle of the PDRs
+     */
+    void removeRecordsByTerminusHandle(uint16_t terminusHandle);
+
+    /** @brief Drop the PDR lists after the local PDRs of the repository were
+     *         added or removed without this class
+     */
+    void invalidate();
+
+    /** @brief Get the number of times the PDR lists were dropped
+     *
+     *  @return the count, PDR lists taken at the same count still hold the
+     *          same entries
+     */
+    uint64_t getInvalidations() const
+    {
+        return invalidations;
+    }
+
+    /** @brief Set the function called whenever PDRs are added or removed
+     *
+     *  @param[in] handler - the function
+     */
+    void setChangeHandler(std::function<void()> handler)
+    {
+        changeHandler = std::move(handler);
+    }
+
+  private:
+    /** @brief Add a local PDR to the PDR lists
+     *
+     *  @param[in] entry - the PDR entry
+     */
+    void index(const PdrEntry& entry) const;
+
+    /** @brief Rebuild the PDR lists from the repository once invalidated */
+    void rebuild() const;
+
+    /** @brief Local PDRs per PDR type */
+    mutable std::map<Type, std::vector<PdrEntry>> recordsByType;
+
+    /** @brief Local sensor and effecter PDRs, keyed by PDR type and
+     *         sensor/effecter ID
+     */
+    mutable std::unordered_map<uint32_t, PdrEntry> sensorRecords;
+    mutable std::unordered_map<uint32_t, PdrEntry> effecterRecords;
+
+    /** @brief Last PDR added through this repository, the next one is
+     *         looked up from it
+     */
+    const pldm_pdr_record* lastRecord = nullptr;
+
+    /** @brief Whether the PDR lists reflect the repository */
+    mutable bool indexed = true;
+
+    /** @brief Number of times the PDR lists were dropped */
+    uint64_t invalidations = 0;
+
+    /** @brief Called whenever PDRs are added or removed */
+    std::function<void()> changeHandler;
 };
 
 /** @brief Parse the State Sensor PDR and return the parsed sensor info which
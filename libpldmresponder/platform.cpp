@@ -11,6 +11,7 @@
 #include "host-bmc/dbus/serialize.hpp"
 #include "pdr.hpp"
 #include "pdr_numeric_effecter.hpp"
+#include "pdr_snapshot.hpp"
 #include "pdr_state_effecter.hpp"
 #include "pdr_state_sensor.hpp"
 #include "pdr_utils.hpp"
@@ -20,9 +21,19 @@
 
 #include <libpldm/entity.h>
 #include <libpldm/state_set.h>
+#include <libpldm/utils.h>
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <vector>
+
 using namespace pldm::utils;
 using namespace pldm::responder::pdr;
 using namespace pldm::responder::pdr_utils;
@@ -40,6 +51,31 @@ using InternalFailure =
 
 static const Json empty{};
 
+/** @brief Types of the PDRs generated from the PDR JSONs */
+static constexpr std::array<Type, 3> snapshotPDRTypes{
+    PLDM_STATE_EFFECTER_PDR, PLDM_NUMERIC_EFFECTER_PDR, PLDM_STATE_SENSOR_PDR};
+
+/** @brief Check whether the PDRs of a PDR JSON object depend on the entities
+ *         found in the inventory
+ *
+ *  @param[in] pdrJson - the PDR JSON object
+ *
+ *  @return true if an entry of the object names an entity path
+ */
+static bool dependsOnInventory(const Json& pdrJson)
+{
+    static const std::vector<Json> emptyList{};
+    for (const auto& e : pdrJson.value("entries", emptyList))
+    {
+        if (!e.value("entity_path", "").empty() ||
+            !e.value("parent_entity_path", "").empty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 void Handler::addDbusObjMaps(
     uint16_t id,
     std::tuple<pdr_utils::DbusMappings, pdr_utils::DbusValMaps> dbusObj,
@@ -71,16 +107,95 @@ const std::tuple<pdr_utils::DbusMappings, pdr_utils::DbusValMaps>&
 void Handler::generate(const pldm::utils::DBusHandler& dBusIntf,
                        const std::vector<fs::path>& dir, Repo& repo,
                        pldm_entity_association_tree* bmcEntityTree)
+{
+    GenerateState state{};
+    if (!startGenerate(dir, repo, state))
+    {
+        return;
+    }
+    while (generateNext(dBusIntf, repo, bmcEntityTree, state))
+    {}
+    finishGenerate(repo, state);
+}
+
+bool Handler::startGenerate(const std::vector<fs::path>& dir, Repo& repo,
+                            GenerateState& state)
 {
     for (const auto& directory : dir)
     {
         info("checking if : {DIR} exists", "DIR", directory.c_str());
         if (!fs::exists(directory))
         {
-            return;
+            return false;
         }
     }
 
+    if (!pdrSnapshotFile.empty())
+    {
+        auto snapshotKey = pdr_snapshot::getKey(dir, nextSensorId,
+                                                nextEffecterId);
+        if (loadPDRSnapshot(snapshotKey, repo))
+        {
+            return true;
+        }
+        state.snapshotKey = snapshotKey;
+        state.firstSensorId = nextSensorId;
+        state.firstEffecterId = nextEffecterId;
+        for (auto pdrType : snapshotPDRTypes)
+        {
+            state.firstRecords[pdrType] =
+                repo.getRecordsByType(pdrType).size();
+        }
+        state.firstInvalidations = repo.getInvalidations();
+    }
+
+    for (const auto& directory : dir)
+    {
+        for (const auto& dirEntry : fs::directory_iterator(directory))
+        {
+            state.files.emplace_back(dirEntry.path());
+        }
+    }
+    return true;
+}
+
+bool Handler::generateNext(const pldm::utils::DBusHandler& dBusIntf,
+                           Repo& repo,
+                           pldm_entity_association_tree* bmcEntityTree,
+                           GenerateState& state)
+{
+    if (state.nextFile < state.files.size())
+    {
+        state.fromJsonsOnly &= generateFromJson(
+            dBusIntf, state.files[state.nextFile++], repo, bmcEntityTree);
+    }
+    return state.nextFile < state.files.size();
+}
+
+void Handler::finishGenerate(const Repo& repo, const GenerateState& state)
+{
+    if (state.snapshotKey && state.fromJsonsOnly &&
+        state.firstInvalidations == repo.getInvalidations())
+    {
+        savePDRSnapshot(*state.snapshotKey, repo, state.firstSensorId,
+                        state.firstEffecterId, state.firstRecords);
+    }
+
+    if (fruHandler)
+    {
+        fruHandler->setStatePDRParams(pdrJsonsDir, getNextSensorId(),
+                                      getNextEffecterId(), sensorDbusObjMaps,
+                                      effecterDbusObjMaps, false);
+    }
+}
+
+bool Handler::generateFromJson(const pldm::utils::DBusHandler& dBusIntf,
+                               const fs::path& file, Repo& repo,
+                               pldm_entity_association_tree* bmcEntityTree)
+{
+    // Whether the PDRs depend on nothing but the PDR JSON file
+    bool fromJsonsOnly = true;
+
     // A map of PDR type to a lambda that handles creation of that PDR type.
     // The lambda essentially would parse the platform specific PDR JSONs to
     // generate the PDR structures. This function iterates through the map to
@@ -113,69 +228,127 @@ void Handler::generate(const pldm::utils::DBusHandler& dBusIntf,
     }}};
 
     Type pdrType{};
-    for (const auto& directory : dir)
+    try
     {
-        for (const auto& dirEntry : fs::directory_iterator(directory))
+        if (fs::is_regular_file(file))
         {
-            try
+            auto json = readJson(file.string());
+            if (!json.empty())
             {
-                if (fs::is_regular_file(dirEntry.path().string()))
+                auto effecterPDRs = json.value("effecterPDRs", empty);
+                for (const auto& effecter : effecterPDRs)
                 {
-                    auto json = readJson(dirEntry.path().string());
-                    if (!json.empty())
-                    {
-                        auto effecterPDRs = json.value("effecterPDRs", empty);
-                        for (const auto& effecter : effecterPDRs)
-                        {
-                            pdrType = effecter.value("pdrType", 0);
-                            generateHandlers.at(pdrType)(dBusIntf, effecter,
-                                                         repo, bmcEntityTree);
-                        }
-
-                        auto sensorPDRs = json.value("sensorPDRs", empty);
-                        for (const auto& sensor : sensorPDRs)
-                        {
-                            pdrType = sensor.value("pdrType", 0);
-                            generateHandlers.at(pdrType)(dBusIntf, sensor, repo,
-                                                         bmcEntityTree);
-                        }
-                    }
+                    pdrType = effecter.value("pdrType", 0);
+                    fromJsonsOnly &= !dependsOnInventory(effecter);
+                    generateHandlers.at(pdrType)(dBusIntf, effecter, repo,
+                                                 bmcEntityTree);
+                }
+
+                auto sensorPDRs = json.value("sensorPDRs", empty);
+                for (const auto& sensor : sensorPDRs)
+                {
+                    pdrType = sensor.value("pdrType", 0);
+                    fromJsonsOnly &= !dependsOnInventory(sensor);
+                    generateHandlers.at(pdrType)(dBusIntf, sensor, repo,
+                                                 bmcEntityTree);
                 }
             }
-            catch (const InternalFailure& e)
-            {
-                error(
-                    "PDR config directory does not exist or empty, TYPE= {PDR_TYP} PATH= {DIR_PATH} ERROR={ERR_EXCEP}",
-                    "PDR_TYP", pdrType, "DIR_PATH", dirEntry.path().string(),
-                    "ERR_EXCEP", e.what());
-            }
-            catch (const Json::exception& e)
-            {
-                error(
-                    "Failed parsing PDR JSON file, TYPE= {PDR_TYP} ERROR={ERR_EXCEP}",
-                    "PDR_TYP", pdrType, "ERR_EXCEP", e.what());
-                pldm::utils::reportError(
-                    "xyz.openbmc_project.PLDM.Error.Generate.PDRJsonFileParseFail",
-                    pldm::PelSeverity::ERROR);
-            }
-            catch (const std::exception& e)
+        }
+    }
+    catch (const InternalFailure& e)
+    {
+        error(
+            "PDR config directory does not exist or empty, TYPE= {PDR_TYP} PATH= {DIR_PATH} ERROR={ERR_EXCEP}",
+            "PDR_TYP", pdrType, "DIR_PATH", file.string(), "ERR_EXCEP",
+            e.what());
+        fromJsonsOnly = false;
+    }
+    catch (const Json::exception& e)
+    {
+        error(
+            "Failed parsing PDR JSON file, TYPE= {PDR_TYP} ERROR={ERR_EXCEP}",
+            "PDR_TYP", pdrType, "ERR_EXCEP", e.what());
+        pldm::utils::reportError(
+            "xyz.openbmc_project.PLDM.Error.Generate.PDRJsonFileParseFail",
+            pldm::PelSeverity::ERROR);
+        fromJsonsOnly = false;
+    }
+    catch (const std::exception& e)
+    {
+        error(
+            "Failed parsing PDR JSON file, TYPE= {PDR_TYP} ERROR={ERR_EXCEP}",
+            "PDR_TYP", pdrType, "ERR_EXCEP", e.what());
+        pldm::utils::reportError(
+            "xyz.openbmc_project.PLDM.Error.Generate.PDRJsonFileParseFail",
+            pldm::PelSeverity::ERROR);
+        fromJsonsOnly = false;
+    }
+
+    return fromJsonsOnly;
+}
+
+bool Handler::loadPDRSnapshot(uint64_t snapshotKey, Repo& repo)
+{
+    pdr_snapshot::Contents contents{};
+    if (!pdr_snapshot::load(pdrSnapshotFile, snapshotKey, repo, contents))
+    {
+        return false;
+    }
+
+    nextSensorId = contents.nextSensorId;
+    nextEffecterId = contents.nextEffecterId;
+    sensorDbusObjMaps.merge(contents.sensorDbusObjMaps);
+    effecterDbusObjMaps.merge(contents.effecterDbusObjMaps);
+    info("Loaded PDR snapshot {PATH}", "PATH", pdrSnapshotFile.string());
+    return true;
+}
+
+void Handler::savePDRSnapshot(uint64_t snapshotKey, const Repo& repo,
+                              uint16_t firstSensorId, uint16_t firstEffecterId,
+                              const std::map<Type, size_t>& firstRecords)
+{
+    pdr_snapshot::Contents contents{nextSensorId, nextEffecterId, {}, {}};
+
+    // Only the sensors and effecters generated from the PDR JSONs, a sensor
+    // or effecter whose D-Bus object was not found may be found next time
+    auto copyDbusObjMaps = [](const pdr_utils::DbusObjMaps& dbusObjMaps,
+                             uint16_t firstId, uint16_t lastId,
+                             pdr_utils::DbusObjMaps& snapshotMaps) {
+        for (auto it = dbusObjMaps.upper_bound(firstId);
+             it != dbusObjMaps.end() && it->first <= lastId; ++it)
+        {
+            for (const auto& dbusMapping : std::get<0>(it->second))
             {
-                error(
-                    "Failed parsing PDR JSON file, TYPE= {PDR_TYP} ERROR={ERR_EXCEP}",
-                    "PDR_TYP", pdrType, "ERR_EXCEP", e.what());
-                pldm::utils::reportError(
-                    "xyz.openbmc_project.PLDM.Error.Generate.PDRJsonFileParseFail",
-                    pldm::PelSeverity::ERROR);
+                if (dbusMapping.objectPath.empty())
+                {
+                    return false;
+                }
             }
+            snapshotMaps.emplace(*it);
         }
+        return true;
+    };
+    if (!copyDbusObjMaps(sensorDbusObjMaps, firstSensorId, nextSensorId,
+                         contents.sensorDbusObjMaps) ||
+        !copyDbusObjMaps(effecterDbusObjMaps, firstEffecterId, nextEffecterId,
+                         contents.effecterDbusObjMaps))
+    {
+        return;
     }
 
-    if (fruHandler)
+    // The PDRs in the order they were added, as their record handles
+    std::vector<pdr_utils::PdrEntry> records;
+    for (const auto& [pdrType, firstRecord] : firstRecords)
     {
-        fruHandler->setStatePDRParams(pdrJsonsDir, getNextSensorId(),
-                                      getNextEffecterId(), sensorDbusObjMaps,
-                                      effecterDbusObjMaps, false);
+        const auto& typeRecords = repo.getRecordsByType(pdrType);
+        records.insert(records.end(), typeRecords.begin() + firstRecord,
+                       typeRecords.end());
     }
+    std::ranges::sort(records, {}, [](const pdr_utils::PdrEntry& pdrEntry) {
+        return pdrEntry.handle.recordHandle;
+    });
+
+    pdr_snapshot::save(pdrSnapshotFile, snapshotKey, records, contents);
 }
 
 Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
@@ -192,36 +365,26 @@ Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
         }
     }
 
-    // Build FRU table if not built, since entity association PDR's
-    // are built when the FRU table is constructed.
-    if (fruHandler)
-    {
-        fruHandler->buildFRUTable();
-    }
-
+    // The PDRs are built in the background, see processBuildPDRs
     if (!pdrCreated)
     {
-        generateTerminusLocatorPDR(pdrRepo);
-
-        if (oemPlatformHandler != nullptr)
+        if (buildPDREvent)
         {
-            auto systemType = oemPlatformHandler->getConfigDir();
-            if (!systemType.empty())
+            // The host asking for the PDRs means the BMC is ready, don't wait
+            // for the next check
+            if (buildStep == BuildStep::WaitBMCReady)
             {
-                // In case of normal poweron , the system type would have been
-                // already filled by entity manager when ever BMC reaches Ready
-                // state. If this is not filled by time we get a getpdr request
-                // we can assume that the entity manager service is not present
-                // on this system & continue to build the common PDR's.
-                pdrJsonsDir.push_back(pdrJsonDir /
-                                      oemPlatformHandler->getConfigDir());
+                buildStep = BuildStep::FRUTable;
             }
-            oemPlatformHandler->buildOEMPDR(pdrRepo);
+            bmcReadyTimer->setEnabled(false);
+            buildPDREvent->set_enabled(sdeventplus::source::Enabled::On);
         }
-        generate(*dBusIntf, pdrJsonsDir, pdrRepo, bmcEntityTree);
-
-        pdrCreated = true;
+        return ccOnlyResponse(request, PLDM_ERROR_NOT_READY);
+    }
 
+    if (postGetPDRActionsPending)
+    {
+        postGetPDRActionsPending = false;
         if (dbusToPLDMEventHandler)
         {
             deferredGetPDREvent = std::make_unique<sdeventplus::source::Defer>(
@@ -232,8 +395,6 @@ Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
         }
     }
 
-    Response response(sizeof(pldm_msg_hdr) + PLDM_GET_PDR_MIN_RESP_BYTES, 0);
-
     if (payloadLength != PLDM_GET_PDR_REQ_BYTES)
     {
         return CmdHandler::ccOnlyResponse(request, PLDM_ERROR_INVALID_LENGTH);
@@ -300,26 +461,78 @@ Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
                 request, PLDM_PLATFORM_INVALID_RECORD_HANDLE);
         }
 
+        // The data transfer handle of a part is the offset of the part in
+        // the record, the first part starts at 0
+        uint32_t offset{};
+        if (transferOpFlag == PLDM_GET_NEXTPART)
+        {
+            offset = dataTransferHandle;
+        }
+        else if (transferOpFlag != PLDM_GET_FIRSTPART)
+        {
+            return CmdHandler::ccOnlyResponse(
+                request, PLDM_PLATFORM_INVALID_TRANSFER_OPERATION_FLAG);
+        }
+        if (offset)
+        {
+            if (offset >= e.size)
+            {
+                return CmdHandler::ccOnlyResponse(
+                    request, PLDM_PLATFORM_INVALID_DATA_TRANSFER_HANDLE);
+            }
+            // The record must not have changed since the first part
+            auto hdr = reinterpret_cast<const pldm_pdr_hdr*>(e.data);
+            if (recordChangeNum != hdr->record_change_num)
+            {
+                return CmdHandler::ccOnlyResponse(
+                    request, PLDM_PLATFORM_INVALID_RECORD_CHANGE_NUMBER);
+            }
+        }
+
+        uint8_t transferFlag = PLDM_START_AND_END;
+        uint32_t nextDataTransferHandle{};
+        uint8_t transferCRC{};
         if (reqSizeBytes)
         {
-            respSizeBytes = e.size;
-            if (respSizeBytes > reqSizeBytes)
+            // Clamp in 32 bits before narrowing, a record may be longer
+            // than 64 KiB
+            respSizeBytes = static_cast<uint16_t>(
+                std::min<uint32_t>(e.size - offset, reqSizeBytes));
+            recordData = e.data + offset;
+
+            bool last = offset + respSizeBytes == e.size;
+            if (!offset)
+            {
+                transferFlag = last ? PLDM_START_AND_END : PLDM_START;
+            }
+            else
+            {
+                transferFlag = last ? PLDM_END : PLDM_MIDDLE;
+            }
+            if (!last)
+            {
+                nextDataTransferHandle = offset + respSizeBytes;
+            }
+            else if (offset)
             {
-                respSizeBytes = reqSizeBytes;
+                transferCRC = crc8(e.data, e.size);
             }
-            recordData = e.data;
         }
-        response.resize(sizeof(pldm_msg_hdr) + PLDM_GET_PDR_MIN_RESP_BYTES +
-                            respSizeBytes,
-                        0);
+        auto response = allocResponse(
+            sizeof(pldm_msg_hdr) + PLDM_GET_PDR_MIN_RESP_BYTES +
+            respSizeBytes +
+            (transferFlag == PLDM_END ? sizeof(transferCRC) : 0));
         auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
-        rc = encode_get_pdr_resp(
-            request->hdr.instance_id, PLDM_SUCCESS, e.handle.nextRecordHandle,
-            0, PLDM_START_AND_END, respSizeBytes, recordData, 0, responsePtr);
+        rc = encode_get_pdr_resp(request->hdr.instance_id, PLDM_SUCCESS,
+                                 e.handle.nextRecordHandle,
+                                 nextDataTransferHandle, transferFlag,
+                                 respSizeBytes, recordData, transferCRC,
+                                 responsePtr);
         if (rc != PLDM_SUCCESS)
         {
             return ccOnlyResponse(request, rc);
         }
+        return response;
     }
     catch (const std::exception& e)
     {
@@ -327,11 +540,85 @@ Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
               "REC_HNDL", recordHandle, "ERR_EXCEP", e.what());
         return CmdHandler::ccOnlyResponse(request, PLDM_ERROR);
     }
-    return response;
+}
+
+namespace
+{
+
+/** @class DeferredDBusHandler
+ *
+ *  D-Bus interface of the state effecter and sensor handlers for their
+ *  deferred variants: the properties set are recorded to be set
+ *  asynchronously afterwards, and the properties read are served from the
+ *  values read asynchronously beforehand.
+ */
+class DeferredDBusHandler
+{
+  public:
+    void setDbusProperty(const DBusMapping& dBusMap,
+                         const PropertyValue& value) const
+    {
+        properties.emplace_back(dBusMap, value);
+    }
+
+    PropertyValue getDbusPropertyVariant(const char* objPath,
+                                         const char* dbusProp,
+                                         const char* dbusInterface) const
+    {
+        return values.at({objPath, dbusInterface, dbusProp});
+    }
+
+    /** @brief Properties set, in order */
+    mutable std::vector<DBusProperty> properties;
+
+    /** @brief Values of the properties read, by object path, interface and
+     *         property name, a property missing here fails to be read
+     */
+    std::map<std::tuple<std::string, std::string, std::string>, PropertyValue>
+        values;
+};
+
+} // namespace
+
+void Handler::setStateEffecterStates(const pldm_msg* request,
+                                     size_t payloadLength,
+                                     ResponseCompletion&& complete)
+{
+    DeferredDBusHandler dBusIntf;
+    auto response = setStateEffecterStates(dBusIntf, request, payloadLength);
+    if (dBusIntf.properties.empty())
+    {
+        complete(std::move(response));
+        return;
+    }
+
+    pldm_msg requestHdr{};
+    requestHdr.hdr = request->hdr;
+    const pldm::utils::DBusHandler dBusHandler;
+    dBusHandler.setDbusPropertiesAsync(
+        std::move(dBusIntf.properties),
+        [requestHdr, response = std::move(response),
+         complete = std::move(complete)](bool set) mutable {
+        if (!set)
+        {
+            complete(ccOnlyResponse(&requestHdr, PLDM_ERROR));
+            return;
+        }
+        complete(std::move(response));
+    });
 }
 
 Response Handler::setStateEffecterStates(const pldm_msg* request,
                                          size_t payloadLength)
+{
+    return setStateEffecterStates(pldm::utils::DBusHandler(), request,
+                                  payloadLength);
+}
+
+template <class DBusInterface>
+Response Handler::setStateEffecterStates(const DBusInterface& dBusIntf,
+                                         const pldm_msg* request,
+                                         size_t payloadLength)
 {
     Response response(
         sizeof(pldm_msg_hdr) + PLDM_SET_STATE_EFFECTER_STATES_RESP_BYTES, 0);
@@ -359,7 +646,6 @@ Response Handler::setStateEffecterStates(const pldm_msg* request,
     }
 
     stateField.resize(compEffecterCnt);
-    const pldm::utils::DBusHandler dBusIntf;
     uint16_t entityType{};
     uint16_t entityInstance{};
     uint16_t stateSetId{};
@@ -376,8 +662,7 @@ Response Handler::setStateEffecterStates(const pldm_msg* request,
     else
     {
         rc = platform_state_effecter::setStateEffecterStatesHandler<
-            pldm::utils::DBusHandler, Handler>(dBusIntf, *this, effecterId,
-                                               stateField);
+            DBusInterface, Handler>(dBusIntf, *this, effecterId, stateField);
     }
     if (rc != PLDM_SUCCESS)
     {
@@ -666,8 +951,7 @@ int Handler::pldmPDRRepositoryChgEvent(const pldm_msg* request,
             {
                 if (std::get<0>(terminusInfo) == tid)
                 {
-                    pldm_pdr_remove_pdrs_by_terminus_handle(pdrRepo.getPdr(),
-                                                            terminusHandle);
+                    pdrRepo.removeRecordsByTerminusHandle(terminusHandle);
                 }
             }
         }
@@ -876,8 +1160,79 @@ void Handler::generateTerminusLocatorPDR(Repo& repo)
     }
 }
 
+void Handler::getStateSensorReadings(const pldm_msg* request,
+                                     size_t payloadLength,
+                                     ResponseCompletion&& complete)
+{
+    // The request is gone once this returns, keep a copy of it to make the
+    // response from
+    auto requestMsg = std::make_shared<std::vector<uint8_t>>(
+        reinterpret_cast<const uint8_t*>(request),
+        reinterpret_cast<const uint8_t*>(request) + sizeof(pldm_msg_hdr) +
+            payloadLength);
+    auto dBusIntf = std::make_shared<DeferredDBusHandler>();
+    auto respond = [this, requestMsg, payloadLength, dBusIntf,
+                    complete = std::move(complete)]() {
+        complete(getStateSensorReadings(
+            *dBusIntf, reinterpret_cast<const pldm_msg*>(requestMsg->data()),
+            payloadLength));
+    };
+
+    uint16_t sensorId{};
+    bitfield8_t sensorRearm{};
+    uint8_t reserved{};
+    if (payloadLength != PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES ||
+        decode_get_state_sensor_readings_req(request, payloadLength, &sensorId,
+                                             &sensorRearm,
+                                             &reserved) != PLDM_SUCCESS ||
+        !sensorDbusObjMaps.contains(sensorId))
+    {
+        // Invalid requests and OEM sensors don't read D-Bus properties here
+        respond();
+        return;
+    }
+
+    const auto& dbusMappings = std::get<0>(sensorDbusObjMaps.at(sensorId));
+    auto pending = std::make_shared<size_t>(dbusMappings.size());
+    if (!*pending)
+    {
+        respond();
+        return;
+    }
+    const pldm::utils::DBusHandler dBusHandler;
+    for (const auto& dbusMapping : dbusMappings)
+    {
+        dBusHandler.getDbusPropertyVariantAsync(
+            dbusMapping.objectPath, dbusMapping.propertyName,
+            dbusMapping.interface,
+            [dbusMapping, dBusIntf, pending,
+             respond](std::optional<PropertyValue> value) {
+            if (value)
+            {
+                dBusIntf->values.insert_or_assign(
+                    {dbusMapping.objectPath, dbusMapping.interface,
+                     dbusMapping.propertyName},
+                    std::move(*value));
+            }
+            if (!--*pending)
+            {
+                respond();
+            }
+        });
+    }
+}
+
 Response Handler::getStateSensorReadings(const pldm_msg* request,
                                          size_t payloadLength)
+{
+    return getStateSensorReadings(pldm::utils::DBusHandler(), request,
+                                  payloadLength);
+}
+
+template <class DBusInterface>
+Response Handler::getStateSensorReadings(const DBusInterface& dBusIntf,
+                                         const pldm_msg* request,
+                                         size_t payloadLength)
 {
     uint16_t sensorId{};
     bitfield8_t sensorRearm{};
@@ -900,7 +1255,6 @@ Response Handler::getStateSensorReadings(const pldm_msg* request,
     uint8_t sensorRearmCount = std::popcount(sensorRearm.byte);
     std::vector<get_sensor_state_field> stateField(sensorRearmCount);
     uint8_t comSensorCnt{};
-    const pldm::utils::DBusHandler dBusIntf;
 
     uint16_t entityType{};
     uint16_t entityInstance{};
@@ -918,7 +1272,7 @@ Response Handler::getStateSensorReadings(const pldm_msg* request,
     else
     {
         rc = platform_state_sensor::getStateSensorReadingsHandler<
-            pldm::utils::DBusHandler, Handler>(
+            DBusInterface, Handler>(
             dBusIntf, *this, sensorId, sensorRearmCount, comSensorCnt,
             stateField, dbusToPLDMEventHandler->getSensorCache());
     }
@@ -943,6 +1297,147 @@ Response Handler::getStateSensorReadings(const pldm_msg* request,
     return response;
 }
 
+int Handler::checkBMCState()
+{
+    if (oemPlatformHandler != nullptr)
+    {
+        return oemPlatformHandler->checkBMCState();
+    }
+
+    try
+    {
+        auto propertyValue = dBusIntf->getDbusPropertyVariant(
+            "/xyz/openbmc_project/state/bmc0", "CurrentBMCState",
+            "xyz.openbmc_project.State.BMC");
+        if (std::get<std::string>(propertyValue) !=
+            "xyz.openbmc_project.State.BMC.BMCState.Ready")
+        {
+            return PLDM_ERROR_NOT_READY;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        error("Error getting the current BMC state ERROR={ERR_EXCEP}",
+              "ERR_EXCEP", e.what());
+        return PLDM_ERROR;
+    }
+    return PLDM_SUCCESS;
+}
+
+void Handler::processBuildPDRs(sdeventplus::source::EventBase& /*source*/)
+{
+    switch (buildStep)
+    {
+        case BuildStep::WaitBMCReady:
+        {
+            auto rc = checkBMCState();
+            if (rc != PLDM_SUCCESS)
+            {
+                buildPDREvent->set_enabled(sdeventplus::source::Enabled::Off);
+                // Without an OEM handler and a BMC state, the PDRs are built
+                // on the first GetPDR
+                if (rc == PLDM_ERROR_NOT_READY || oemPlatformHandler != nullptr)
+                {
+                    bmcReadyTimer->restartOnce(bmcReadyRetryInterval);
+                }
+                return;
+            }
+            buildStep = BuildStep::FRUTable;
+            break;
+        }
+
+        case BuildStep::FRUTable:
+            // Build FRU table first, since entity association PDR's are
+            // built when the FRU table is constructed.
+            if (fruHandler)
+            {
+                try
+                {
+                    fruHandler->buildFRUTable();
+                }
+                catch (const std::exception& e)
+                {
+                    error("Failed to build the FRU table, ERROR={ERR_EXCEP}",
+                          "ERR_EXCEP", e.what());
+                }
+            }
+            buildStep = BuildStep::PDRs;
+            break;
+
+        case BuildStep::PDRs:
+            startBuildPDRs();
+            buildStep = BuildStep::PDRJsons;
+            break;
+
+        case BuildStep::PDRJsons:
+            // One PDR JSON file per step, so that requests are served in
+            // between
+            if (pdrJsonsBuild && generateNext(*dBusIntf, pdrRepo,
+                                              bmcEntityTree, *pdrJsonsBuild))
+            {
+                break;
+            }
+            if (pdrJsonsBuild)
+            {
+                finishGenerate(pdrRepo, *pdrJsonsBuild);
+                pdrJsonsBuild.reset();
+            }
+            // Drop the PDR JSONs parsed ahead that were not taken
+            pldm::utils::clearPreloadedJsons();
+            pdrCreated = true;
+            postGetPDRActionsPending = true;
+            bmcReadyTimer.reset();
+            buildPDREvent.reset();
+            break;
+    }
+}
+
+void Handler::startBuildPDRs()
+{
+    generateTerminusLocatorPDR(pdrRepo);
+
+    if (oemPlatformHandler != nullptr)
+    {
+        auto systemType = oemPlatformHandler->getConfigDir();
+        if (!systemType.empty())
+        {
+            // In case of normal poweron , the system type would have been
+            // already filled by entity manager when ever BMC reaches Ready
+            // state. If this is not filled by the time the BMC is ready we
+            // can assume that the entity manager service is not present on
+            // this system & continue to build the common PDR's.
+            pdrJsonsDir.push_back(pdrJsonDir /
+                                  oemPlatformHandler->getConfigDir());
+        }
+        oemPlatformHandler->buildOEMPDR(pdrRepo);
+    }
+
+    pdrJsonsBuild.emplace();
+    if (!startGenerate(pdrJsonsDir, pdrRepo, *pdrJsonsBuild))
+    {
+        pdrJsonsBuild.reset();
+        return;
+    }
+
+    // The PDR JSONs are only parsed when they are not in the PDR snapshot,
+    // in parallel, and the PDRs are generated once they are all parsed
+    std::vector<fs::path> files;
+    std::ranges::copy_if(pdrJsonsBuild->files, std::back_inserter(files),
+                         [](const fs::path& file) {
+        return fs::is_regular_file(file);
+    });
+    if (jsonPreloader && !files.empty())
+    {
+        buildPDREvent->set_enabled(sdeventplus::source::Enabled::Off);
+        jsonPreloader(files, [this]() {
+            if (buildPDREvent)
+            {
+                buildPDREvent->set_enabled(sdeventplus::source::Enabled::On);
+            }
+        });
+    }
+}
+
 void Handler::_processPostGetPDRActions(sdeventplus::source::EventBase&
                                         /*source */)
 {
@@ -959,12 +1454,8 @@ bool isOemNumericEffecter(Handler& handler, uint16_t effecterId,
 {
     pldm_numeric_effecter_value_pdr* pdr = nullptr;
 
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)>
-        numericEffecterPdrRepo(pldm_pdr_init(), pldm_pdr_destroy);
-    pldm::responder::pdr_utils::Repo numericEffecterPDRs(
-        numericEffecterPdrRepo.get());
-    pldm::responder::pdr::getRepoByType(handler.getRepo(), numericEffecterPDRs,
-                                        PLDM_NUMERIC_EFFECTER_PDR);
+    const auto& numericEffecterPDRs =
+        handler.getRepo().getRecordsByType(PLDM_NUMERIC_EFFECTER_PDR);
 
     if (numericEffecterPDRs.empty())
     {
@@ -972,45 +1463,39 @@ bool isOemNumericEffecter(Handler& handler, uint16_t effecterId,
         return false;
     }
 
-    PdrEntry pdrEntry{};
-    auto pdrRecord = numericEffecterPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
+    auto pdrEntry = handler.getRepo().getRecordByEffecterId(
+        PLDM_NUMERIC_EFFECTER_PDR, effecterId);
+    if (!pdrEntry)
     {
-        pdr = reinterpret_cast<pldm_numeric_effecter_value_pdr*>(pdrEntry.data);
-        assert(pdr != NULL);
-        if (pdr->effecter_id != effecterId)
-        {
-            pdr = nullptr;
-            pdrRecord = numericEffecterPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
-
-        auto tmpEntityType = pdr->entity_type;
-        auto tmpEntityInstance = pdr->entity_instance;
-        auto tmpEffecterDataSize = pdr->effecter_data_size;
-        auto tmpEffecterSemanticId = pdr->effecter_semantic_id;
-        auto tmpEffecterOffset = pdr->offset;
-        auto tmpEffecterResolution = pdr->resolution;
-
-        if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
-             tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
-            (tmpEffecterSemanticId >= PLDM_OEM_STATE_SET_ID_START &&
-             tmpEffecterSemanticId < PLDM_OEM_STATE_SET_ID_END))
-        {
-            entityType = tmpEntityType;
-            entityInstance = tmpEntityInstance;
-            effecterDataSize = tmpEffecterDataSize;
-            effecterSemanticId = tmpEffecterSemanticId;
-            effecterOffset = tmpEffecterOffset;
-            effecterResolution = tmpEffecterResolution;
-            return true;
-        }
-        else
-        {
-            return false;
-        }
+        return false;
+    }
+    pdr = reinterpret_cast<pldm_numeric_effecter_value_pdr*>(pdrEntry->data);
+    assert(pdr != NULL);
+
+    auto tmpEntityType = pdr->entity_type;
+    auto tmpEntityInstance = pdr->entity_instance;
+    auto tmpEffecterDataSize = pdr->effecter_data_size;
+    auto tmpEffecterSemanticId = pdr->effecter_semantic_id;
+    auto tmpEffecterOffset = pdr->offset;
+    auto tmpEffecterResolution = pdr->resolution;
+
+    if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
+         tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
+        (tmpEffecterSemanticId >= PLDM_OEM_STATE_SET_ID_START &&
+         tmpEffecterSemanticId < PLDM_OEM_STATE_SET_ID_END))
+    {
+        entityType = tmpEntityType;
+        entityInstance = tmpEntityInstance;
+        effecterDataSize = tmpEffecterDataSize;
+        effecterSemanticId = tmpEffecterSemanticId;
+        effecterOffset = tmpEffecterOffset;
+        effecterResolution = tmpEffecterResolution;
+        return true;
+    }
+    else
+    {
+        return false;
     }
-    return false;
 }
 
 bool isOemStateSensor(Handler& handler, uint16_t sensorId,
@@ -1020,68 +1505,56 @@ bool isOemStateSensor(Handler& handler, uint16_t sensorId,
 {
     pldm_state_sensor_pdr* pdr = nullptr;
 
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> stateSensorPdrRepo(
-        pldm_pdr_init(), pldm_pdr_destroy);
-    if (!stateSensorPdrRepo)
-    {
-        return false;
-    }
-    Repo stateSensorPDRs(stateSensorPdrRepo.get());
-    getRepoByType(handler.getRepo(), stateSensorPDRs, PLDM_STATE_SENSOR_PDR);
+    const auto& stateSensorPDRs =
+        handler.getRepo().getRecordsByType(PLDM_STATE_SENSOR_PDR);
     if (stateSensorPDRs.empty())
     {
         error("Failed to get record by PDR type");
         return false;
     }
 
-    PdrEntry pdrEntry{};
-    auto pdrRecord = stateSensorPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
+    auto pdrEntry =
+        handler.getRepo().getRecordBySensorId(PLDM_STATE_SENSOR_PDR, sensorId);
+    if (!pdrEntry)
     {
-        pdr = reinterpret_cast<pldm_state_sensor_pdr*>(pdrEntry.data);
-        assert(pdr != NULL);
-        if (pdr->sensor_id != sensorId)
-        {
-            pdr = nullptr;
-            pdrRecord = stateSensorPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
-        auto tmpEntityType = pdr->entity_type;
-        auto tmpEntityInstance = pdr->entity_instance;
-        auto tmpEntityContainerId = pdr->container_id;
-        auto tmpCompSensorCnt = pdr->composite_sensor_count;
-        auto tmpPossibleStates =
-            reinterpret_cast<state_sensor_possible_states*>(
-                pdr->possible_states);
-        auto tmpStateSetId = tmpPossibleStates->state_set_id;
-
-        if (sensorRearmCount > tmpCompSensorCnt)
-        {
-            error(
-                "The requester sent wrong sensorRearm count for the sensor, SENSOR_ID={SENSOR_ID} SENSOR_REARM_COUNT={SENSOR_REARM_COUNT}",
-                "SENSOR_ID", sensorId, "SENSOR_REARM_COUNT",
-                (uint16_t)sensorRearmCount);
-            break;
-        }
+        return false;
+    }
+    pdr = reinterpret_cast<pldm_state_sensor_pdr*>(pdrEntry->data);
+    assert(pdr != NULL);
+
+    auto tmpEntityType = pdr->entity_type;
+    auto tmpEntityInstance = pdr->entity_instance;
+    auto tmpEntityContainerId = pdr->container_id;
+    auto tmpCompSensorCnt = pdr->composite_sensor_count;
+    auto tmpPossibleStates =
+        reinterpret_cast<state_sensor_possible_states*>(pdr->possible_states);
+    auto tmpStateSetId = tmpPossibleStates->state_set_id;
+
+    if (sensorRearmCount > tmpCompSensorCnt)
+    {
+        error(
+            "The requester sent wrong sensorRearm count for the sensor, SENSOR_ID={SENSOR_ID} SENSOR_REARM_COUNT={SENSOR_REARM_COUNT}",
+            "SENSOR_ID", sensorId, "SENSOR_REARM_COUNT",
+            (uint16_t)sensorRearmCount);
+        return false;
+    }
 
-        if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
-             tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
-            (tmpStateSetId >= PLDM_OEM_STATE_SET_ID_START &&
-             tmpStateSetId < PLDM_OEM_STATE_SET_ID_END))
-        {
-            entityType = tmpEntityType;
-            entityInstance = tmpEntityInstance;
-            stateSetId = tmpStateSetId;
-            compSensorCnt = tmpCompSensorCnt;
-            containerId = tmpEntityContainerId;
-            return true;
-        }
-        else
-        {
-            return false;
-        }
+    if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
+         tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
+        (tmpStateSetId >= PLDM_OEM_STATE_SET_ID_START &&
+         tmpStateSetId < PLDM_OEM_STATE_SET_ID_END))
+    {
+        entityType = tmpEntityType;
+        entityInstance = tmpEntityInstance;
+        stateSetId = tmpStateSetId;
+        compSensorCnt = tmpCompSensorCnt;
+        containerId = tmpEntityContainerId;
+        return true;
+    }
+    else
+    {
+        return false;
     }
-    return false;
 }
 
 bool isOemStateEffecter(Handler& handler, uint16_t effecterId,
@@ -1090,66 +1563,52 @@ bool isOemStateEffecter(Handler& handler, uint16_t effecterId,
 {
     pldm_state_effecter_pdr* pdr = nullptr;
 
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> stateEffecterPdrRepo(
-        pldm_pdr_init(), pldm_pdr_destroy);
-    if (!stateEffecterPdrRepo)
-    {
-        return false;
-    }
-    Repo stateEffecterPDRs(stateEffecterPdrRepo.get());
-    getRepoByType(handler.getRepo(), stateEffecterPDRs,
-                  PLDM_STATE_EFFECTER_PDR);
+    const auto& stateEffecterPDRs =
+        handler.getRepo().getRecordsByType(PLDM_STATE_EFFECTER_PDR);
     if (stateEffecterPDRs.empty())
     {
         error("Failed to get record by PDR type");
         return false;
     }
 
-    PdrEntry pdrEntry{};
-    auto pdrRecord = stateEffecterPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
+    auto pdrEntry = handler.getRepo().getRecordByEffecterId(
+        PLDM_STATE_EFFECTER_PDR, effecterId);
+    if (!pdrEntry)
     {
-        pdr = reinterpret_cast<pldm_state_effecter_pdr*>(pdrEntry.data);
-        assert(pdr != NULL);
-        if (pdr->effecter_id != effecterId)
-        {
-            pdr = nullptr;
-            pdrRecord = stateEffecterPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
+        return false;
+    }
+    pdr = reinterpret_cast<pldm_state_effecter_pdr*>(pdrEntry->data);
+    assert(pdr != NULL);
 
-        auto tmpEntityType = pdr->entity_type;
-        auto tmpEntityInstance = pdr->entity_instance;
-        auto tmpPossibleStates =
-            reinterpret_cast<state_effecter_possible_states*>(
-                pdr->possible_states);
-        auto tmpStateSetId = tmpPossibleStates->state_set_id;
+    auto tmpEntityType = pdr->entity_type;
+    auto tmpEntityInstance = pdr->entity_instance;
+    auto tmpPossibleStates =
+        reinterpret_cast<state_effecter_possible_states*>(pdr->possible_states);
+    auto tmpStateSetId = tmpPossibleStates->state_set_id;
 
-        if (compEffecterCnt > pdr->composite_effecter_count)
-        {
-            error(
-                "The requester sent wrong composite effecter count for the effecter, EFFECTER_ID={EFFECTER_ID} COMP_EFF_CNT={COMP_EFF_CNT}",
-                "EFFECTER_ID", effecterId, "COMP_EFF_CNT",
-                (uint16_t)compEffecterCnt);
-            return false;
-        }
+    if (compEffecterCnt > pdr->composite_effecter_count)
+    {
+        error(
+            "The requester sent wrong composite effecter count for the effecter, EFFECTER_ID={EFFECTER_ID} COMP_EFF_CNT={COMP_EFF_CNT}",
+            "EFFECTER_ID", effecterId, "COMP_EFF_CNT",
+            (uint16_t)compEffecterCnt);
+        return false;
+    }
 
-        if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
-             tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
-            (tmpStateSetId >= PLDM_OEM_STATE_SET_ID_START &&
-             tmpStateSetId < PLDM_OEM_STATE_SET_ID_END))
-        {
-            entityType = tmpEntityType;
-            entityInstance = tmpEntityInstance;
-            stateSetId = tmpStateSetId;
-            return true;
-        }
-        else
-        {
-            return false;
-        }
+    if ((tmpEntityType >= PLDM_OEM_ENTITY_TYPE_START &&
+         tmpEntityType <= PLDM_OEM_ENTITY_TYPE_END) ||
+        (tmpStateSetId >= PLDM_OEM_STATE_SET_ID_START &&
+         tmpStateSetId < PLDM_OEM_STATE_SET_ID_END))
+    {
+        entityType = tmpEntityType;
+        entityInstance = tmpEntityInstance;
+        stateSetId = tmpStateSetId;
+        return true;
+    }
+    else
+    {
+        return false;
     }
-    return false;
 }
 
 } // namespace platform
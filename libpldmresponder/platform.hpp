@@ -16,8 +16,13 @@
 #include <stdint.h>
 
 #include <phosphor-logging/lg2.hpp>
+#include <sdeventplus/source/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
 
+#include <chrono>
+#include <functional>
 #include <map>
+#include <optional>
 
 PHOSPHOR_LOG2_USING;
 
@@ -47,6 +52,12 @@ using EventMap = std::map<EventType, EventHandlers>;
 using AssociatedEntityMap = std::map<DbusPath, pldm_entity>;
 using namespace sdbusplus::bus::match::rules;
 
+/** @brief Parses JSON files ahead of time without blocking, and invokes the
+ *         callback on the event loop once they are parsed
+ */
+using JsonPreloader = std::function<void(const std::vector<fs::path>& files,
+                                         std::function<void()> done)>;
+
 class Handler : public CmdHandler
 {
   public:
@@ -58,20 +69,42 @@ class Handler : public CmdHandler
             pldm_entity_association_tree* bmcEntityTree,
             pldm::responder::oem_platform::Handler* oemPlatformHandler,
             sdeventplus::Event& event, bool buildPDRLazily = false,
-            const std::optional<EventMap>& addOnHandlersMap = std::nullopt) :
+            const std::optional<EventMap>& addOnHandlersMap = std::nullopt,
+            const fs::path& pdrSnapshotFile = {},
+            JsonPreloader jsonPreloader = {}) :
         pdrRepo(repo),
         hostPDRHandler(hostPDRHandler),
         dbusToPLDMEventHandler(dbusToPLDMEventHandler), fruHandler(fruHandler),
         bmcEntityTree(bmcEntityTree), dBusIntf(dBusIntf),
         oemPlatformHandler(oemPlatformHandler), event(event),
-        pdrJsonDir(pdrJsonDir), pdrCreated(false), pdrJsonsDir({pdrJsonDir})
+        pdrJsonDir(pdrJsonDir), pdrCreated(false), pdrJsonsDir({pdrJsonDir}),
+        pdrSnapshotFile(pdrSnapshotFile),
+        jsonPreloader(std::move(jsonPreloader))
     {
+        if (fruHandler)
+        {
+            fruHandler->setPdrRepo(&pdrRepo);
+        }
         if (!buildPDRLazily)
         {
             generateTerminusLocatorPDR(pdrRepo);
             generate(*dBusIntf, pdrJsonsDir, pdrRepo, bmcEntityTree);
             pdrCreated = true;
         }
+        else
+        {
+            // Build the FRU table and the PDRs once the BMC is ready, one
+            // step at a time whenever the event loop is idle, instead of in
+            // the first GetPDR
+            buildPDREvent = std::make_unique<sdeventplus::source::Defer>(
+                event, std::bind(std::mem_fn(&Handler::processBuildPDRs), this,
+                                 std::placeholders::_1));
+            buildPDREvent->set_priority(SD_EVENT_PRIORITY_IDLE);
+            bmcReadyTimer = std::make_unique<sdeventplus::utility::Timer<
+                sdeventplus::ClockId::Monotonic>>(event, [this](auto&) {
+                buildPDREvent->set_enabled(sdeventplus::source::Enabled::On);
+            });
+        }
 
         handlers.emplace(PLDM_GET_PDR,
                          [this](const pldm_msg* request, size_t payloadLength) {
@@ -85,17 +118,23 @@ class Handler : public CmdHandler
                          [this](const pldm_msg* request, size_t payloadLength) {
             return this->getNumericEffecterValue(request, payloadLength);
         });
-        handlers.emplace(PLDM_SET_STATE_EFFECTER_STATES,
-                         [this](const pldm_msg* request, size_t payloadLength) {
-            return this->setStateEffecterStates(request, payloadLength);
+        deferredHandlers.emplace(
+            PLDM_SET_STATE_EFFECTER_STATES,
+            [this](const pldm_msg* request, size_t payloadLength,
+                   ResponseCompletion&& complete) {
+            this->setStateEffecterStates(request, payloadLength,
+                                         std::move(complete));
         });
         handlers.emplace(PLDM_PLATFORM_EVENT_MESSAGE,
                          [this](const pldm_msg* request, size_t payloadLength) {
             return this->platformEventMessage(request, payloadLength);
         });
-        handlers.emplace(PLDM_GET_STATE_SENSOR_READINGS,
-                         [this](const pldm_msg* request, size_t payloadLength) {
-            return this->getStateSensorReadings(request, payloadLength);
+        deferredHandlers.emplace(
+            PLDM_GET_STATE_SENSOR_READINGS,
+            [this](const pldm_msg* request, size_t payloadLength,
+                   ResponseCompletion&& complete) {
+            this->getStateSensorReadings(request, payloadLength,
+                                         std::move(complete));
         });
 
         // Default handler for PLDM Events
@@ -200,6 +239,10 @@ class Handler : public CmdHandler
     }
 
     /** @brief Parse PDR JSONs and build PDR repository
+     *
+     *  When a PDR snapshot file is set, the PDRs and the D-Bus mappings are
+     *  loaded from the snapshot if it was saved from the same PDR JSONs, and
+     *  saved to it otherwise.
      *
      *  @param[in] dBusIntf - The interface object
      *  @param[in] dir - directory housing platform specific PDR JSON files
@@ -225,6 +268,9 @@ class Handler : public CmdHandler
     EventMap eventHandlers;
 
     /** @brief Handler for GetPDR
+     *
+     *  A record larger than the request count is transferred in parts, the
+     *  data transfer handle of each part is its offset in the record.
      *
      *  @param[in] request - Request message payload
      *  @param[in] payloadLength - Request payload length
@@ -259,6 +305,16 @@ class Handler : public CmdHandler
     Response getStateSensorReadings(const pldm_msg* request,
                                     size_t payloadLength);
 
+    /** @brief Handler for getStateSensorReadings that reads the D-Bus
+     *         properties of the sensor without blocking the event loop
+     *
+     *  @param[in] request - Request message
+     *  @param[in] payloadLength - Request payload length
+     *  @param[in] complete - completion token the response is sent with
+     */
+    void getStateSensorReadings(const pldm_msg* request, size_t payloadLength,
+                                ResponseCompletion&& complete);
+
     /** @brief Handler for setStateEffecterStates
      *
      *  @param[in] request - Request message
@@ -268,6 +324,16 @@ class Handler : public CmdHandler
     Response setStateEffecterStates(const pldm_msg* request,
                                     size_t payloadLength);
 
+    /** @brief Handler for setStateEffecterStates that sets the D-Bus
+     *         properties of the effecter without blocking the event loop
+     *
+     *  @param[in] request - Request message
+     *  @param[in] payloadLength - Request payload length
+     *  @param[in] complete - completion token the response is sent with
+     */
+    void setStateEffecterStates(const pldm_msg* request, size_t payloadLength,
+                                ResponseCompletion&& complete);
+
     /** @brief Handler for PlatformEventMessage
      *
      *  @param[in] request - Request message
@@ -340,51 +406,31 @@ class Handler : public CmdHandler
         pldm_state_effecter_pdr* pdr = nullptr;
         uint8_t compEffecterCnt = stateField.size();
 
-        std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)>
-            stateEffecterPdrRepo(pldm_pdr_init(), pldm_pdr_destroy);
-        if (!stateEffecterPdrRepo)
-        {
-            throw std::runtime_error(
-                "Failed to instantiate state effecter PDR repository");
-        }
-        pldm::responder::pdr_utils::Repo stateEffecterPDRs(
-            stateEffecterPdrRepo.get());
-        getRepoByType(pdrRepo, stateEffecterPDRs, PLDM_STATE_EFFECTER_PDR);
+        const auto& stateEffecterPDRs =
+            pdrRepo.getRecordsByType(PLDM_STATE_EFFECTER_PDR);
         if (stateEffecterPDRs.empty())
         {
             error("Failed to get record by PDR type");
             return PLDM_PLATFORM_INVALID_EFFECTER_ID;
         }
 
-        pldm::responder::pdr_utils::PdrEntry pdrEntry{};
-        auto pdrRecord = stateEffecterPDRs.getFirstRecord(pdrEntry);
-        while (pdrRecord)
+        auto pdrEntry = pdrRepo.getRecordByEffecterId(
+            PLDM_STATE_EFFECTER_PDR, effecterId);
+        if (!pdrEntry)
         {
-            pdr = reinterpret_cast<pldm_state_effecter_pdr*>(pdrEntry.data);
-            if (pdr->effecter_id != effecterId)
-            {
-                pdr = nullptr;
-                pdrRecord = stateEffecterPDRs.getNextRecord(pdrRecord,
-                                                            pdrEntry);
-                continue;
-            }
-
-            states = reinterpret_cast<state_effecter_possible_states*>(
-                pdr->possible_states);
-            if (compEffecterCnt > pdr->composite_effecter_count)
-            {
-                error(
-                    "The requester sent wrong composite effecter count for the effecter, EFFECTER_ID={EFFECTER_ID} COMP_EFF_CNT={COMP_EFF_CNT}",
-                    "EFFECTER_ID", (unsigned)effecterId, "COMP_EFF_CNT",
-                    (unsigned)compEffecterCnt);
-                return PLDM_ERROR_INVALID_DATA;
-            }
-            break;
+            return PLDM_PLATFORM_INVALID_EFFECTER_ID;
         }
+        pdr = reinterpret_cast<pldm_state_effecter_pdr*>(pdrEntry->data);
 
-        if (!pdr)
+        states = reinterpret_cast<state_effecter_possible_states*>(
+            pdr->possible_states);
+        if (compEffecterCnt > pdr->composite_effecter_count)
         {
-            return PLDM_PLATFORM_INVALID_EFFECTER_ID;
+            error(
+                "The requester sent wrong composite effecter count for the effecter, EFFECTER_ID={EFFECTER_ID} COMP_EFF_CNT={COMP_EFF_CNT}",
+                "EFFECTER_ID", (unsigned)effecterId, "COMP_EFF_CNT",
+                (unsigned)compEffecterCnt);
+            return PLDM_ERROR_INVALID_DATA;
         }
 
         int rc = PLDM_SUCCESS;
@@ -491,6 +537,150 @@ class Handler : public CmdHandler
     void _processPostGetPDRActions(sdeventplus::source::EventBase& source);
 
   private:
+    /** @brief Handler for getStateSensorReadings
+     *
+     *  @tparam DBusInterface - D-Bus interface type
+     *  @param[in] dBusIntf - D-Bus interface the properties are read with
+     *  @param[in] request - Request message
+     *  @param[in] payloadLength - Request payload length
+     *  @return Response - PLDM Response message
+     */
+    template <class DBusInterface>
+    Response getStateSensorReadings(const DBusInterface& dBusIntf,
+                                    const pldm_msg* request,
+                                    size_t payloadLength);
+
+    /** @brief Handler for setStateEffecterStates
+     *
+     *  @tparam DBusInterface - D-Bus interface type
+     *  @param[in] dBusIntf - D-Bus interface the properties are set with
+     *  @param[in] request - Request message
+     *  @param[in] payloadLength - Request payload length
+     *  @return Response - PLDM Response message
+     */
+    template <class DBusInterface>
+    Response setStateEffecterStates(const DBusInterface& dBusIntf,
+                                    const pldm_msg* request,
+                                    size_t payloadLength);
+
+    /** @brief Take the next step of building the FRU table and the PDRs,
+     *         one step per dispatch of the idle event source
+     *
+     *  @param[in] source - sdeventplus event source
+     */
+    void processBuildPDRs(sdeventplus::source::EventBase& source);
+
+    /** @brief Check whether the BMC is ready for the PDRs to be built
+     *
+     *  @return PLDM_SUCCESS if the BMC is ready, PLDM_ERROR_NOT_READY if not
+     *          yet, PLDM_ERROR if its state cannot be read
+     */
+    int checkBMCState();
+
+    /** @brief Build the terminus locator PDR and the OEM PDRs, and start
+     *         generating the PDRs of the PDR JSONs
+     */
+    void startBuildPDRs();
+
+    /** @brief Progress of generating the PDRs of the PDR JSONs */
+    struct GenerateState
+    {
+        /** @brief PDR JSON files, in order */
+        std::vector<fs::path> files;
+        /** @brief Next PDR JSON file to generate the PDRs of */
+        size_t nextFile = 0;
+        /** @brief Whether the PDRs depend on nothing but the PDR JSONs */
+        bool fromJsonsOnly = true;
+        /** @brief Key of the PDR snapshot saved once done, if any */
+        std::optional<uint64_t> snapshotKey;
+        /** @brief Last sensor and effecter IDs assigned, and number of PDRs
+         *         of each type, before generating
+         */
+        uint16_t firstSensorId = 0;
+        uint16_t firstEffecterId = 0;
+        std::map<pldm::pdr::Type, size_t> firstRecords;
+        /** @brief Repo::getInvalidations before generating, the snapshot is
+         *         not saved if the PDR lists changed meanwhile
+         */
+        uint64_t firstInvalidations = 0;
+    };
+
+    /** @brief Start generating the PDRs of the PDR JSONs, which are loaded
+     *         from the PDR snapshot instead if it was saved from the same
+     *         PDR JSONs
+     *
+     *  @param[in] dir - directory housing platform specific PDR JSON files
+     *  @param[in] repo - instance of concrete implementation of Repo
+     *  @param[out] state - progress of the generation
+     *
+     *  @return false if there is nothing to generate since a directory is
+     *          missing
+     */
+    bool startGenerate(const std::vector<fs::path>& dir,
+                       pldm::responder::pdr_utils::Repo& repo,
+                       GenerateState& state);
+
+    /** @brief Generate the PDRs of the next PDR JSON file
+     *
+     *  @param[in] dBusIntf - The interface object
+     *  @param[in] repo - instance of concrete implementation of Repo
+     *  @param[in,out] state - progress of the generation
+     *
+     *  @return true if PDR JSON files are left
+     */
+    bool generateNext(const pldm::utils::DBusHandler& dBusIntf,
+                      pldm::responder::pdr_utils::Repo& repo,
+                      pldm_entity_association_tree* bmcEntityTree,
+                      GenerateState& state);
+
+    /** @brief Finish generating the PDRs of the PDR JSONs, saving them to
+     *         the PDR snapshot
+     *
+     *  @param[in] repo - instance of concrete implementation of Repo
+     *  @param[in] state - progress of the generation
+     */
+    void finishGenerate(const pldm::responder::pdr_utils::Repo& repo,
+                        const GenerateState& state);
+
+    /** @brief Parse a PDR JSON file and build its PDRs
+     *
+     *  @param[in] dBusIntf - The interface object
+     *  @param[in] file - platform specific PDR JSON file
+     *  @param[in] repo - instance of concrete implementation of Repo
+     *
+     *  @return true if the PDRs depend on nothing but the PDR JSON file
+     */
+    bool generateFromJson(const pldm::utils::DBusHandler& dBusIntf,
+                          const fs::path& file,
+                          pldm::responder::pdr_utils::Repo& repo,
+                          pldm_entity_association_tree* bmcEntityTree);
+
+    /** @brief Load the PDRs and the D-Bus mappings from the PDR snapshot
+     *
+     *  @param[in] snapshotKey - key of the PDR JSONs
+     *  @param[in] repo - instance of concrete implementation of Repo
+     *
+     *  @return true if the snapshot was saved from the same PDR JSONs
+     */
+    bool loadPDRSnapshot(uint64_t snapshotKey,
+                         pldm::responder::pdr_utils::Repo& repo);
+
+    /** @brief Save the PDRs and the D-Bus mappings generated from the PDR
+     *         JSONs to the PDR snapshot
+     *
+     *  @param[in] snapshotKey - key of the PDR JSONs
+     *  @param[in] repo - instance of concrete implementation of Repo
+     *  @param[in] firstSensorId - last sensor ID assigned before generating
+     *  @param[in] firstEffecterId - last effecter ID assigned before
+     *                               generating
+     *  @param[in] firstRecords - number of PDRs of each type before
+     *                            generating
+     */
+    void savePDRSnapshot(uint64_t snapshotKey,
+                         const pldm::responder::pdr_utils::Repo& repo,
+                         uint16_t firstSensorId, uint16_t firstEffecterId,
+                         const std::map<pldm::pdr::Type, size_t>& firstRecords);
+
     pdr_utils::Repo pdrRepo;
     uint16_t nextEffecterId{};
     uint16_t nextSensorId{};
@@ -506,7 +696,37 @@ class Handler : public CmdHandler
     fs::path pdrJsonDir;
     bool pdrCreated;
     std::vector<fs::path> pdrJsonsDir;
+    /** @brief Snapshot of the PDRs generated from the PDR JSONs, no
+     *         snapshot is kept if empty
+     */
+    fs::path pdrSnapshotFile;
+    /** @brief Parses the PDR JSONs ahead of the background build, if set */
+    JsonPreloader jsonPreloader;
     std::unique_ptr<sdeventplus::source::Defer> deferredGetPDREvent;
+    /** @brief Steps of building the FRU table and the PDRs */
+    enum class BuildStep
+    {
+        WaitBMCReady,
+        FRUTable,
+        PDRs,
+        PDRJsons,
+    };
+    BuildStep buildStep = BuildStep::WaitBMCReady;
+    /** @brief Progress of generating the PDRs of the PDR JSONs, one file per
+     *         step
+     */
+    std::optional<GenerateState> pdrJsonsBuild;
+    /** @brief Idle event source building the FRU table and the PDRs */
+    std::unique_ptr<sdeventplus::source::Defer> buildPDREvent;
+    /** @brief Timer checking again whether the BMC is ready */
+    std::unique_ptr<
+        sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>
+        bmcReadyTimer;
+    static constexpr auto bmcReadyRetryInterval = std::chrono::seconds(5);
+    /** @brief The post GetPDR actions are taken on the first GetPDR after
+     *         the PDRs are built
+     */
+    bool postGetPDRActionsPending = false;
     bool isFirstGetPDR = true;
     /** @brief D-Bus property changed signal match */
     std::unique_ptr<sdbusplus::bus::match::match> hostOffMatch;
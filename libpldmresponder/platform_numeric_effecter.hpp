@@ -254,16 +254,8 @@ int setNumericEffecterValueHandler(const DBusInterface& dBusIntf,
     constexpr auto effecterValueArrayLength = 4;
     pldm_numeric_effecter_value_pdr* pdr = nullptr;
 
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)>
-        numericEffecterPdrRepo(pldm_pdr_init(), pldm_pdr_destroy);
-    if (!numericEffecterPdrRepo)
-    {
-        return PLDM_ERROR;
-    }
-    pldm::responder::pdr_utils::Repo numericEffecterPDRs(
-        numericEffecterPdrRepo.get());
-    pldm::responder::pdr::getRepoByType(handler.getRepo(), numericEffecterPDRs,
-                                        PLDM_NUMERIC_EFFECTER_PDR);
+    const auto& numericEffecterPDRs =
+        handler.getRepo().getRecordsByType(PLDM_NUMERIC_EFFECTER_PDR);
     if (numericEffecterPDRs.empty())
     {
         error("The Numeric Effecter PDR repo is empty.");
@@ -272,25 +264,13 @@ int setNumericEffecterValueHandler(const DBusInterface& dBusIntf,
 
     // Get the pdr structure of pldm_numeric_effecter_value_pdr according
     // to the effecterId
-    pldm::responder::pdr_utils::PdrEntry pdrEntry{};
-    auto pdrRecord = numericEffecterPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
-    {
-        pdr = reinterpret_cast<pldm_numeric_effecter_value_pdr*>(pdrEntry.data);
-        if (pdr->effecter_id != effecterId)
-        {
-            pdr = nullptr;
-            pdrRecord = numericEffecterPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
-
-        break;
-    }
-
-    if (!pdr)
+    auto pdrEntry = handler.getRepo().getRecordByEffecterId(
+        PLDM_NUMERIC_EFFECTER_PDR, effecterId);
+    if (!pdrEntry)
     {
         return PLDM_PLATFORM_INVALID_EFFECTER_ID;
     }
+    pdr = reinterpret_cast<pldm_numeric_effecter_value_pdr*>(pdrEntry->data);
 
     if (effecterValueLength != effecterValueArrayLength)
     {
@@ -479,12 +459,8 @@ int getNumericEffecterData(const DBusInterface& dBusIntf, Handler& handler,
 {
     pldm_numeric_effecter_value_pdr* pdr = nullptr;
 
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)>
-        numericEffecterPdrRepo(pldm_pdr_init(), pldm_pdr_destroy);
-    pldm::responder::pdr_utils::Repo numericEffecterPDRs(
-        numericEffecterPdrRepo.get());
-    pldm::responder::pdr::getRepoByType(handler.getRepo(), numericEffecterPDRs,
-                                        PLDM_NUMERIC_EFFECTER_PDR);
+    const auto& numericEffecterPDRs =
+        handler.getRepo().getRecordsByType(PLDM_NUMERIC_EFFECTER_PDR);
     if (numericEffecterPDRs.empty())
     {
         error("The Numeric Effecter PDR repo is empty.");
@@ -493,28 +469,16 @@ int getNumericEffecterData(const DBusInterface& dBusIntf, Handler& handler,
 
     // Get the pdr structure of pldm_numeric_effecter_value_pdr according
     // to the effecterId
-    pldm::responder::pdr_utils::PdrEntry pdrEntry{};
-    auto pdrRecord = numericEffecterPDRs.getFirstRecord(pdrEntry);
-
-    while (pdrRecord)
-    {
-        pdr = reinterpret_cast<pldm_numeric_effecter_value_pdr*>(pdrEntry.data);
-        if (pdr->effecter_id != effecterId)
-        {
-            pdr = nullptr;
-            pdrRecord = numericEffecterPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
-        effecterDataSize = pdr->effecter_data_size;
-        break;
-    }
-
-    if (!pdr)
+    auto pdrEntry = handler.getRepo().getRecordByEffecterId(
+        PLDM_NUMERIC_EFFECTER_PDR, effecterId);
+    if (!pdrEntry)
     {
         error("The Numeric Effecter not found EFFECTERID={EFFECTERID}",
               "EFFECTERID", effecterId);
         return PLDM_PLATFORM_INVALID_EFFECTER_ID;
     }
+    pdr = reinterpret_cast<pldm_numeric_effecter_value_pdr*>(pdrEntry->data);
+    effecterDataSize = pdr->effecter_data_size;
 
     try
     {
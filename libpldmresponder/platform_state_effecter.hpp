@@ -47,50 +47,30 @@ int setStateEffecterStatesHandler(
     pldm_state_effecter_pdr* pdr = nullptr;
     uint8_t compEffecterCnt = stateField.size();
 
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> stateEffecterPdrRepo(
-        pldm_pdr_init(), pldm_pdr_destroy);
-    if (!stateEffecterPdrRepo)
-    {
-        throw std::runtime_error(
-            "Failed to instantiate state effecter PDR repository");
-    }
-    pldm::responder::pdr_utils::Repo stateEffecterPDRs(
-        stateEffecterPdrRepo.get());
-    getRepoByType(handler.getRepo(), stateEffecterPDRs,
-                  PLDM_STATE_EFFECTER_PDR);
+    const auto& stateEffecterPDRs =
+        handler.getRepo().getRecordsByType(PLDM_STATE_EFFECTER_PDR);
     if (stateEffecterPDRs.empty())
     {
         error("Failed to get record by PDR type");
         return PLDM_PLATFORM_INVALID_EFFECTER_ID;
     }
 
-    pldm::responder::pdr_utils::PdrEntry pdrEntry{};
-    auto pdrRecord = stateEffecterPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
+    auto pdrEntry = handler.getRepo().getRecordByEffecterId(
+        PLDM_STATE_EFFECTER_PDR, effecterId);
+    if (!pdrEntry)
     {
-        pdr = reinterpret_cast<pldm_state_effecter_pdr*>(pdrEntry.data);
-        if (pdr->effecter_id != effecterId)
-        {
-            pdr = nullptr;
-            pdrRecord = stateEffecterPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
-
-        states = reinterpret_cast<state_effecter_possible_states*>(
-            pdr->possible_states);
-        if (compEffecterCnt > pdr->composite_effecter_count)
-        {
-            error(
-                "The requester sent wrong composite effecter count for the effecter, EFFECTER_ID={EFFECTER_ID} COMP_EFF_CNT={COMP_EFF_CNT}",
-                "EFFECTER_ID", effecterId, "COMP_EFF_CNT", compEffecterCnt);
-            return PLDM_ERROR_INVALID_DATA;
-        }
-        break;
+        return PLDM_PLATFORM_INVALID_EFFECTER_ID;
     }
+    pdr = reinterpret_cast<pldm_state_effecter_pdr*>(pdrEntry->data);
 
-    if (!pdr)
+    states = reinterpret_cast<state_effecter_possible_states*>(
+        pdr->possible_states);
+    if (compEffecterCnt > pdr->composite_effecter_count)
     {
-        return PLDM_PLATFORM_INVALID_EFFECTER_ID;
+        error(
+            "The requester sent wrong composite effecter count for the effecter, EFFECTER_ID={EFFECTER_ID} COMP_EFF_CNT={COMP_EFF_CNT}",
+            "EFFECTER_ID", effecterId, "COMP_EFF_CNT", compEffecterCnt);
+        return PLDM_ERROR_INVALID_DATA;
     }
 
     int rc = PLDM_SUCCESS;
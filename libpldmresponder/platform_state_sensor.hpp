@@ -103,55 +103,36 @@ int getStateSensorReadingsHandler(
 
     pldm_state_sensor_pdr* pdr = nullptr;
 
-    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> stateSensorPdrRepo(
-        pldm_pdr_init(), pldm_pdr_destroy);
-    if (!stateSensorPdrRepo)
-    {
-        throw std::runtime_error(
-            "Failed to instantiate state sensor PDR repository");
-    }
-    pldm::responder::pdr_utils::Repo stateSensorPDRs(stateSensorPdrRepo.get());
-    getRepoByType(handler.getRepo(), stateSensorPDRs, PLDM_STATE_SENSOR_PDR);
+    const auto& stateSensorPDRs =
+        handler.getRepo().getRecordsByType(PLDM_STATE_SENSOR_PDR);
     if (stateSensorPDRs.empty())
     {
         error("Failed to get record by PDR type");
         return PLDM_PLATFORM_INVALID_SENSOR_ID;
     }
 
-    pldm::responder::pdr_utils::PdrEntry pdrEntry{};
-    auto pdrRecord = stateSensorPDRs.getFirstRecord(pdrEntry);
-    while (pdrRecord)
+    auto pdrEntry = handler.getRepo().getRecordBySensorId(
+        PLDM_STATE_SENSOR_PDR, sensorId);
+    if (!pdrEntry)
     {
-        pdr = reinterpret_cast<pldm_state_sensor_pdr*>(pdrEntry.data);
-        assert(pdr != NULL);
-        if (pdr->sensor_id != sensorId)
-        {
-            pdr = nullptr;
-            pdrRecord = stateSensorPDRs.getNextRecord(pdrRecord, pdrEntry);
-            continue;
-        }
-
-        compSensorCnt = pdr->composite_sensor_count;
-        if (sensorRearmCnt > compSensorCnt)
-        {
-            error(
-                "The requester sent wrong sensorRearm count for the sensor, SENSOR_ID={SENSOR_ID} SENSOR_REARM_COUNT={SENSOR_REARM_CNT}",
-                "SENSOR_ID", sensorId, "SENSOR_REARM_CNT", sensorRearmCnt);
-            return PLDM_PLATFORM_REARM_UNAVAILABLE_IN_PRESENT_STATE;
-        }
-
-        if (sensorRearmCnt == 0)
-        {
-            sensorRearmCnt = compSensorCnt;
-            stateField.resize(sensorRearmCnt);
-        }
+        return PLDM_PLATFORM_INVALID_SENSOR_ID;
+    }
+    pdr = reinterpret_cast<pldm_state_sensor_pdr*>(pdrEntry->data);
+    assert(pdr != NULL);
 
-        break;
+    compSensorCnt = pdr->composite_sensor_count;
+    if (sensorRearmCnt > compSensorCnt)
+    {
+        error(
+            "The requester sent wrong sensorRearm count for the sensor, SENSOR_ID={SENSOR_ID} SENSOR_REARM_COUNT={SENSOR_REARM_CNT}",
+            "SENSOR_ID", sensorId, "SENSOR_REARM_CNT", sensorRearmCnt);
+        return PLDM_PLATFORM_REARM_UNAVAILABLE_IN_PRESENT_STATE;
     }
 
-    if (!pdr)
+    if (sensorRearmCnt == 0)
     {
-        return PLDM_PLATFORM_INVALID_SENSOR_ID;
+        sensorRearmCnt = compSensorCnt;
+        stateField.resize(sensorRearmCnt);
     }
 
     int rc = PLDM_SUCCESS;
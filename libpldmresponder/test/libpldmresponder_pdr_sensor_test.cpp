@@ -7,6 +7,9 @@
 #include <sdbusplus/test/sdbus_mock.hpp>
 #include <sdeventplus/event.hpp>
 
+#include <cstring>
+#include <filesystem>
+
 #include <gtest/gtest.h>
 
 using namespace pldm::responder;
@@ -69,6 +72,155 @@ TEST(GeneratePDRByStateSensor, testGoodJson)
     pldm_pdr_destroy(outPDRRepo);
 }
 
+TEST(GeneratePDRByStateSensor, testRecordLookup)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_PDR_REQ_BYTES>
+        requestPayload{};
+    auto req = reinterpret_cast<pldm_msg*>(requestPayload.data());
+    size_t requestPayloadLength = requestPayload.size() - sizeof(pldm_msg_hdr);
+
+    MockdBusHandler mockedUtils;
+    EXPECT_CALL(mockedUtils, getService(StrEq("/foo/bar"), _))
+        .Times(1)
+        .WillRepeatedly(Return("foo.bar"));
+
+    auto inPDRRepo = pldm_pdr_init();
+    auto event = sdeventplus::Event::get_default();
+    Handler handler(&mockedUtils, "./pdr_jsons/state_sensor/good", inPDRRepo,
+                    nullptr, nullptr, nullptr, nullptr, nullptr, event);
+    handler.getPDR(req, requestPayloadLength);
+    auto& repo = handler.getRepo();
+
+    const auto& stateSensorPDRs = repo.getRecordsByType(PLDM_STATE_SENSOR_PDR);
+    ASSERT_EQ(stateSensorPDRs.size(), 1);
+    EXPECT_EQ(stateSensorPDRs[0].handle.recordHandle, 2);
+    auto pdr =
+        reinterpret_cast<pldm_state_sensor_pdr*>(stateSensorPDRs[0].data);
+    EXPECT_EQ(pdr->hdr.type, PLDM_STATE_SENSOR_PDR);
+    EXPECT_EQ(pdr->sensor_id, 1);
+
+    EXPECT_TRUE(repo.getRecordsByType(PLDM_STATE_EFFECTER_PDR).empty());
+
+    auto entry = repo.getRecordBySensorId(PLDM_STATE_SENSOR_PDR, 1);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->data, stateSensorPDRs[0].data);
+    EXPECT_EQ(repo.getRecordBySensorId(PLDM_STATE_SENSOR_PDR, 2), nullptr);
+    EXPECT_EQ(repo.getRecordByEffecterId(PLDM_STATE_EFFECTER_PDR, 1), nullptr);
+
+    repo.removeRecordsByTerminusHandle(TERMINUS_HANDLE);
+    EXPECT_TRUE(repo.getRecordsByType(PLDM_STATE_SENSOR_PDR).empty());
+    EXPECT_EQ(repo.getRecordBySensorId(PLDM_STATE_SENSOR_PDR, 1), nullptr);
+
+    pldm_pdr_destroy(inPDRRepo);
+}
+
+TEST(GeneratePDRByStateSensor, testRecordLookupHotplug)
+{
+    auto pdrRepo = pldm_pdr_init();
+    Repo repo(pdrRepo);
+
+    std::vector<uint8_t> entry(sizeof(pldm_state_sensor_pdr));
+    auto pdr = reinterpret_cast<pldm_state_sensor_pdr*>(entry.data());
+    pdr->hdr.type = PLDM_STATE_SENSOR_PDR;
+    pdr->hdr.length = entry.size() - sizeof(pldm_pdr_hdr);
+    PdrEntry pdrEntry{};
+    pdrEntry.data = entry.data();
+    pdrEntry.size = entry.size();
+    for (uint16_t sensorId = 1; sensorId <= 2; ++sensorId)
+    {
+        pdr->sensor_id = sensorId;
+        pdrEntry.handle.recordHandle = sensorId;
+        repo.addRecord(pdrEntry);
+    }
+    ASSERT_NE(repo.getRecordBySensorId(PLDM_STATE_SENSOR_PDR, 2), nullptr);
+    auto invalidations = repo.getInvalidations();
+
+    // FRU hot-unplug removes the PDRs of the FRU directly
+    EXPECT_EQ(pldm_delete_by_sensor_id(pdrRepo, 2, false), 2);
+    repo.invalidate();
+    EXPECT_EQ(repo.getRecordBySensorId(PLDM_STATE_SENSOR_PDR, 2), nullptr);
+    ASSERT_EQ(repo.getRecordsByType(PLDM_STATE_SENSOR_PDR).size(), 1);
+    EXPECT_NE(repo.getInvalidations(), invalidations);
+
+    // FRU hot-plug adds the PDRs of the FRU after the last local PDR
+    pdr->sensor_id = 3;
+    EXPECT_EQ(pldm_pdr_add_hotplug_record(pdrRepo, entry.data(), entry.size(),
+                                          2, false, 1, TERMINUS_HANDLE),
+              2);
+    repo.invalidate();
+    auto hotplugEntry = repo.getRecordBySensorId(PLDM_STATE_SENSOR_PDR, 3);
+    ASSERT_NE(hotplugEntry, nullptr);
+    EXPECT_EQ(hotplugEntry->handle.recordHandle, 2);
+    EXPECT_EQ(reinterpret_cast<const pldm_state_sensor_pdr*>(hotplugEntry->data)
+                  ->sensor_id,
+              3);
+
+    // Added after the lists were rebuilt
+    pdr->sensor_id = 4;
+    pdrEntry.handle.recordHandle = 4;
+    repo.addRecord(pdrEntry);
+    EXPECT_NE(repo.getRecordBySensorId(PLDM_STATE_SENSOR_PDR, 4), nullptr);
+    const auto& stateSensorPDRs = repo.getRecordsByType(PLDM_STATE_SENSOR_PDR);
+    ASSERT_EQ(stateSensorPDRs.size(), 3);
+    EXPECT_EQ(stateSensorPDRs[1].handle.recordHandle, 2);
+    EXPECT_EQ(stateSensorPDRs[2].handle.recordHandle, 4);
+
+    pldm_pdr_destroy(pdrRepo);
+}
+
+TEST(GeneratePDRByStateSensor, testSnapshot)
+{
+    char tmpdir[] = "/tmp/pldm_pdr_snapshot.XXXXXX";
+    auto dir = std::filesystem::path(mkdtemp(tmpdir));
+    auto snapshotFile = dir / "pdr_snapshot";
+    auto event = sdeventplus::Event::get_default();
+
+    MockdBusHandler mockedUtils;
+    EXPECT_CALL(mockedUtils, getService(StrEq("/foo/bar"), _))
+        .Times(1)
+        .WillRepeatedly(Return("foo.bar"));
+    auto inPDRRepo = pldm_pdr_init();
+    Handler handler(&mockedUtils, "./pdr_jsons/state_sensor/good", inPDRRepo,
+                    nullptr, nullptr, nullptr, nullptr, nullptr, event, false,
+                    std::nullopt, snapshotFile);
+    ASSERT_TRUE(std::filesystem::exists(snapshotFile));
+
+    // The PDRs and the D-Bus mappings come from the snapshot, D-Bus is not
+    // looked up again
+    MockdBusHandler snapshotUtils;
+    EXPECT_CALL(snapshotUtils, getService(_, _)).Times(0);
+    auto outPDRRepo = pldm_pdr_init();
+    Handler snapshotHandler(&snapshotUtils, "./pdr_jsons/state_sensor/good",
+                            outPDRRepo, nullptr, nullptr, nullptr, nullptr,
+                            nullptr, event, false, std::nullopt,
+                            snapshotFile);
+
+    Repo inRepo(inPDRRepo);
+    Repo outRepo(outPDRRepo);
+    ASSERT_EQ(outRepo.getRecordCount(), inRepo.getRecordCount());
+
+    auto inEntry =
+        handler.getRepo().getRecordBySensorId(PLDM_STATE_SENSOR_PDR, 1);
+    auto outEntry =
+        snapshotHandler.getRepo().getRecordBySensorId(PLDM_STATE_SENSOR_PDR, 1);
+    ASSERT_NE(inEntry, nullptr);
+    ASSERT_NE(outEntry, nullptr);
+    ASSERT_EQ(outEntry->size, inEntry->size);
+    EXPECT_EQ(0, memcmp(outEntry->data, inEntry->data, inEntry->size));
+
+    const auto& [dbusMappings, dbusValMaps] =
+        snapshotHandler.getDbusObjMaps(1, TypeId::PLDM_SENSOR_ID);
+    ASSERT_EQ(dbusMappings.size(), 1);
+    EXPECT_EQ(dbusMappings[0].objectPath, "/foo/bar");
+    EXPECT_EQ(dbusMappings[0].propertyType, "string");
+    EXPECT_EQ(dbusValMaps,
+              std::get<1>(handler.getDbusObjMaps(1, TypeId::PLDM_SENSOR_ID)));
+
+    pldm_pdr_destroy(inPDRRepo);
+    pldm_pdr_destroy(outPDRRepo);
+    std::filesystem::remove_all(dir);
+}
+
 TEST(GeneratePDR, testMalformedJson)
 {
     std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_PDR_REQ_BYTES>
@@ -9,9 +9,12 @@
 #include "libpldmresponder/platform_state_effecter.hpp"
 #include "libpldmresponder/platform_state_sensor.hpp"
 
+#include <libpldm/utils.h>
+
 #include <sdbusplus/test/sdbus_mock.hpp>
 #include <sdeventplus/event.hpp>
 
+#include <chrono>
 #include <iostream>
 
 using namespace pldm::pdr;
@@ -94,6 +97,134 @@ TEST(getPDR, testShortRead)
     pldm_pdr_destroy(pdrRepo);
 }
 
+TEST(getPDR, testMultipartRead)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_PDR_REQ_BYTES>
+        requestPayload{};
+    auto req = reinterpret_cast<pldm_msg*>(requestPayload.data());
+    size_t requestPayloadLength = requestPayload.size() - sizeof(pldm_msg_hdr);
+
+    struct pldm_get_pdr_req* request =
+        reinterpret_cast<struct pldm_get_pdr_req*>(req->payload);
+    request->record_handle = 1;
+    request->transfer_op_flag = PLDM_GET_FIRSTPART;
+    request->request_count = 100;
+
+    MockdBusHandler mockedUtils;
+    EXPECT_CALL(mockedUtils, getService(StrEq("/foo/bar"), _))
+        .Times(5)
+        .WillRepeatedly(Return("foo.bar"));
+
+    auto pdrRepo = pldm_pdr_init();
+    auto event = sdeventplus::Event::get_default();
+    Handler handler(&mockedUtils, "./pdr_jsons/state_effecter/good", pdrRepo,
+                    nullptr, nullptr, nullptr, nullptr, nullptr, event);
+    auto response = handler.getPDR(req, requestPayloadLength);
+    auto resp = reinterpret_cast<struct pldm_get_pdr_resp*>(
+        reinterpret_cast<pldm_msg*>(response.data())->payload);
+    ASSERT_EQ(PLDM_SUCCESS, resp->completion_code);
+    ASSERT_EQ(PLDM_START_AND_END, resp->transfer_flag);
+    std::vector<uint8_t> record(resp->record_data,
+                                resp->record_data + resp->response_count);
+    ASSERT_GT(record.size(), 8);
+
+    // Fetch the record again 8 bytes at a time
+    std::vector<uint8_t> parts;
+    request->request_count = 8;
+    uint8_t transferFlag = PLDM_START;
+    while (true)
+    {
+        response = handler.getPDR(req, requestPayloadLength);
+        resp = reinterpret_cast<struct pldm_get_pdr_resp*>(
+            reinterpret_cast<pldm_msg*>(response.data())->payload);
+        ASSERT_EQ(PLDM_SUCCESS, resp->completion_code);
+        ASSERT_EQ(transferFlag, resp->transfer_flag);
+        ASSERT_EQ(2, resp->next_record_handle);
+        parts.insert(parts.end(), resp->record_data,
+                     resp->record_data + resp->response_count);
+        if (resp->transfer_flag == PLDM_END)
+        {
+            EXPECT_EQ(0, resp->next_data_transfer_handle);
+            EXPECT_EQ(crc8(record.data(), record.size()),
+                      resp->record_data[resp->response_count]);
+            break;
+        }
+        EXPECT_EQ(8, resp->response_count);
+        EXPECT_EQ(parts.size(), resp->next_data_transfer_handle);
+        request->transfer_op_flag = PLDM_GET_NEXTPART;
+        request->data_transfer_handle = resp->next_data_transfer_handle;
+        transferFlag = record.size() - parts.size() > 8 ? PLDM_MIDDLE
+                                                        : PLDM_END;
+    }
+    EXPECT_EQ(record, parts);
+
+    // A transfer handle past the end of the record
+    request->data_transfer_handle = record.size();
+    response = handler.getPDR(req, requestPayloadLength);
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_PLATFORM_INVALID_DATA_TRANSFER_HANDLE);
+
+    // A part of a record that changed since the first part
+    auto hdr = reinterpret_cast<pldm_pdr_hdr*>(record.data());
+    request->data_transfer_handle = 8;
+    request->record_change_number = hdr->record_change_num + 1;
+    response = handler.getPDR(req, requestPayloadLength);
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_PLATFORM_INVALID_RECORD_CHANGE_NUMBER);
+
+    request->transfer_op_flag = PLDM_ACKNOWLEDGEMENT_ONLY;
+    response = handler.getPDR(req, requestPayloadLength);
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_PLATFORM_INVALID_TRANSFER_OPERATION_FLAG);
+
+    pldm_pdr_destroy(pdrRepo);
+}
+
+TEST(getPDR, testBuildInBackground)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_PDR_REQ_BYTES>
+        requestPayload{};
+    auto req = reinterpret_cast<pldm_msg*>(requestPayload.data());
+    size_t requestPayloadLength = requestPayload.size() - sizeof(pldm_msg_hdr);
+
+    struct pldm_get_pdr_req* request =
+        reinterpret_cast<struct pldm_get_pdr_req*>(req->payload);
+    request->request_count = 100;
+
+    MockdBusHandler mockedUtils;
+    EXPECT_CALL(mockedUtils, getService(StrEq("/foo/bar"), _))
+        .Times(5)
+        .WillRepeatedly(Return("foo.bar"));
+
+    auto pdrRepo = pldm_pdr_init();
+    auto event = sdeventplus::Event::get_default();
+    Handler handler(&mockedUtils, "./pdr_jsons/state_effecter/good", pdrRepo,
+                    nullptr, nullptr, nullptr, nullptr, nullptr, event, true);
+    Repo repo(pdrRepo);
+    ASSERT_EQ(repo.empty(), true);
+
+    // The PDRs are not built by GetPDR
+    auto response = handler.getPDR(req, requestPayloadLength);
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_ERROR_NOT_READY);
+    ASSERT_EQ(repo.empty(), true);
+
+    // One step at a time while the event loop is idle
+    for (int i = 0; i < 3; ++i)
+    {
+        event.run(std::chrono::microseconds(0));
+    }
+    ASSERT_EQ(repo.empty(), false);
+
+    response = handler.getPDR(req, requestPayloadLength);
+    auto resp = reinterpret_cast<struct pldm_get_pdr_resp*>(
+        reinterpret_cast<pldm_msg*>(response.data())->payload);
+    ASSERT_EQ(PLDM_SUCCESS, resp->completion_code);
+    ASSERT_EQ(true, resp->response_count != 0);
+
+    pldm_pdr_destroy(pdrRepo);
+}
+
 TEST(getPDR, testBadRecordHandle)
 {
     std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_PDR_REQ_BYTES>
@@ -19,6 +19,8 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
 
 PHOSPHOR_LOG2_USING;
@@ -50,8 +52,15 @@ struct AspeedXdmaOp
 
 constexpr auto xdmaDev = "/dev/aspeed-xdma";
 
+/** @brief Serializes the XDMA operations. The engine runs one operation at a
+ *  time, file IO offloaded to the worker pool takes turns here instead of
+ *  contending for the device and its reserved memory.
+ */
+std::mutex xdmaMutex;
+
 int DMA::transferHostDataToSocket(int fd, uint32_t length, uint64_t address)
 {
+    std::lock_guard<std::mutex> guard(xdmaMutex);
     socketWriteStatus = NotReady;
     static const size_t pageSize = getpagesize();
     uint32_t numPages = length / pageSize;
@@ -120,6 +129,7 @@ int DMA::transferHostDataToSocket(int fd, uint32_t length, uint64_t address)
 int DMA::transferDataHost(int fd, uint32_t offset, uint32_t length,
                           uint64_t address, bool upstream)
 {
+    std::lock_guard<std::mutex> guard(xdmaMutex);
     static const size_t pageSize = getpagesize();
     uint32_t numPages = length / pageSize;
     uint32_t pageAlignedLength = numPages * pageSize;
@@ -244,6 +254,109 @@ int DMA::transferDataHost(int fd, uint32_t offset, uint32_t length,
 
 namespace oem_ibm
 {
+namespace
+{
+
+/** @struct MemoryTransfer
+ *
+ *  Decoded read/write file by type into memory request
+ */
+struct MemoryTransfer
+{
+    std::unique_ptr<FileHandler> fileHandler; //!< handler of the file type
+    uint32_t offset = 0;                      //!< offset in the file
+    uint32_t length = 0;                      //!< length of the transfer
+    uint64_t address = 0;                     //!< DMA address on the host
+};
+
+/** @brief Decode a read/write file by type into memory request
+ *
+ *  @param[in] cmd - PLDM read/write command
+ *  @param[in] request - PLDM request msg
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[in] dbusImplReqester - pldm dbus api requester
+ *  @param[in] handler - PLDM request handler
+ *  @param[out] response - PLDM response message, encoded on an error
+ *
+ *  @return the transfer to run, std::nullopt on an error
+ */
+std::optional<MemoryTransfer> decodeMemoryTransfer(
+    uint8_t cmd, const pldm_msg* request, size_t payloadLength,
+    dbus_api::Requester* dbusImplReqester,
+    pldm::requester::Handler<pldm::requester::Request>* handler,
+    Response& response)
+{
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+
+    if (payloadLength != PLDM_RW_FILE_BY_TYPE_MEM_REQ_BYTES)
+    {
+        encode_rw_file_by_type_memory_resp(request->hdr.instance_id, cmd,
+                                           PLDM_ERROR_INVALID_LENGTH, 0,
+                                           responsePtr);
+        return std::nullopt;
+    }
+
+    MemoryTransfer transfer{};
+    uint16_t fileType{};
+    uint32_t fileHandle{};
+    auto rc = decode_rw_file_by_type_memory_req(
+        request, payloadLength, &fileType, &fileHandle, &transfer.offset,
+        &transfer.length, &transfer.address);
+    if (rc != PLDM_SUCCESS)
+    {
+        encode_rw_file_by_type_memory_resp(request->hdr.instance_id, cmd, rc, 0,
+                                           responsePtr);
+        return std::nullopt;
+    }
+    if ((transfer.length == 0) || (transfer.length % dma::minSize))
+    {
+        error("Length is not a multiple of DMA minSize, LENGTH={LEN}", "LEN",
+              transfer.length);
+        encode_rw_file_by_type_memory_resp(request->hdr.instance_id, cmd,
+                                           PLDM_ERROR_INVALID_LENGTH, 0,
+                                           responsePtr);
+        return std::nullopt;
+    }
+
+    try
+    {
+        transfer.fileHandler = getHandlerByType(fileType, fileHandle,
+                                                dbusImplReqester, handler);
+    }
+    catch (const InternalFailure& e)
+    {
+        error("unknown file type, TYPE={LEN}  ERROR={ERR_EXCEP}", "LEN",
+              fileType, "ERR_EXCEP", e.what());
+        encode_rw_file_by_type_memory_resp(request->hdr.instance_id, cmd,
+                                           PLDM_INVALID_FILE_TYPE, 0,
+                                           responsePtr);
+        return std::nullopt;
+    }
+    return transfer;
+}
+
+/** @brief Run a read/write file by type into memory transfer
+ *
+ *  @param[in] cmd - PLDM read/write command
+ *  @param[in] transfer - decoded request
+ *  @param[in] oemPlatformHandler - oem platform handler
+ *
+ *  @return PLDM status code
+ */
+int runMemoryTransfer(uint8_t cmd, const MemoryTransfer& transfer,
+                      oem_platform::Handler* oemPlatformHandler)
+{
+    return cmd == PLDM_WRITE_FILE_BY_TYPE_FROM_MEMORY
+               ? transfer.fileHandler->writeFromMemory(
+                     transfer.offset, transfer.length, transfer.address,
+                     oemPlatformHandler)
+               : transfer.fileHandler->readIntoMemory(
+                     transfer.offset, transfer.length, transfer.address,
+                     oemPlatformHandler);
+}
+
+} // namespace
+
 Response Handler::readFileIntoMemory(const pldm_msg* request,
                                      size_t payloadLength)
 {
@@ -415,8 +528,8 @@ Response Handler::getFileTable(const pldm_msg* request, size_t payloadLength)
     uint8_t transferFlag = 0;
     uint8_t tableType = 0;
 
-    Response response(sizeof(pldm_msg_hdr) +
-                      PLDM_GET_FILE_TABLE_MIN_RESP_BYTES);
+    auto response = allocResponse(sizeof(pldm_msg_hdr) +
+                                  PLDM_GET_FILE_TABLE_MIN_RESP_BYTES);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
     if (payloadLength != PLDM_GET_FILE_TABLE_REQ_BYTES)
@@ -470,7 +583,8 @@ Response Handler::readFile(const pldm_msg* request, size_t payloadLength)
     uint32_t offset = 0;
     uint32_t length = 0;
 
-    Response response(sizeof(pldm_msg_hdr) + PLDM_READ_FILE_RESP_BYTES);
+    auto response = allocResponse(sizeof(pldm_msg_hdr) +
+                                  PLDM_READ_FILE_RESP_BYTES);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
     if (payloadLength != PLDM_READ_FILE_REQ_BYTES)
@@ -632,63 +746,15 @@ Response
 {
     Response response(
         sizeof(pldm_msg_hdr) + PLDM_RW_FILE_BY_TYPE_MEM_RESP_BYTES, 0);
-    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
-
-    if (payloadLength != PLDM_RW_FILE_BY_TYPE_MEM_REQ_BYTES)
-    {
-        encode_rw_file_by_type_memory_resp(request->hdr.instance_id, cmd,
-                                           PLDM_ERROR_INVALID_LENGTH, 0,
-                                           responsePtr);
-        return response;
-    }
-
-    uint16_t fileType{};
-    uint32_t fileHandle{};
-    uint32_t offset{};
-    uint32_t length{};
-    uint64_t address{};
-    auto rc = decode_rw_file_by_type_memory_req(request, payloadLength,
-                                                &fileType, &fileHandle, &offset,
-                                                &length, &address);
-    if (rc != PLDM_SUCCESS)
-    {
-        encode_rw_file_by_type_memory_resp(request->hdr.instance_id, cmd, rc, 0,
-                                           responsePtr);
-        return response;
-    }
-    if ((length == 0) || (length % dma::minSize))
-    {
-        error("Length is not a multiple of DMA minSize, LENGTH={LEN}", "LEN",
-              length);
-        encode_rw_file_by_type_memory_resp(request->hdr.instance_id, cmd,
-                                           PLDM_ERROR_INVALID_LENGTH, 0,
-                                           responsePtr);
-        return response;
-    }
-
-    std::unique_ptr<FileHandler> handler{};
-    try
+    auto transfer = decodeMemoryTransfer(cmd, request, payloadLength,
+                                         dbusImplReqester, handler, response);
+    if (transfer)
     {
-        handler = getHandlerByType(fileType, fileHandle, dbusImplReqester,
-                                   Handler::handler);
+        auto rc = runMemoryTransfer(cmd, *transfer, oemPlatformHandler);
+        encode_rw_file_by_type_memory_resp(
+            request->hdr.instance_id, cmd, rc, transfer->length,
+            reinterpret_cast<pldm_msg*>(response.data()));
     }
-    catch (const InternalFailure& e)
-    {
-        error("unknown file type, TYPE={LEN}  ERROR={ERR_EXCEP}", "LEN",
-              fileType, "ERR_EXCEP", e.what());
-        encode_rw_file_by_type_memory_resp(request->hdr.instance_id, cmd,
-                                           PLDM_INVALID_FILE_TYPE, 0,
-                                           responsePtr);
-        return response;
-    }
-
-    rc = cmd == PLDM_WRITE_FILE_BY_TYPE_FROM_MEMORY
-             ? handler->writeFromMemory(offset, length, address,
-                                        oemPlatformHandler)
-             : handler->readIntoMemory(offset, length, address,
-                                       oemPlatformHandler);
-    encode_rw_file_by_type_memory_resp(request->hdr.instance_id, cmd, rc,
-                                       length, responsePtr);
     return response;
 }
 
@@ -708,6 +774,95 @@ Response Handler::readFileByTypeIntoMemory(const pldm_msg* request,
                                   dbusImplReqester);
 }
 
+void Handler::offloadToWorker(
+    Command command, Response (Handler::*fileIO)(const pldm_msg*, size_t))
+{
+    deferredHandlers.emplace(command, [this, fileIO](
+                                          const pldm_msg* request,
+                                          size_t payloadLength,
+                                          ResponseCompletion&& complete) {
+        // Build the file table on the event loop, the workers only read it
+        pldm::filetable::buildFileTable(FILE_TABLE_JSON);
+
+        // The request is only valid for the duration of this call
+        auto msg = reinterpret_cast<const uint8_t*>(request);
+        auto requestMsg = std::make_shared<std::vector<uint8_t>>(
+            msg, msg + sizeof(pldm_msg_hdr) + payloadLength);
+        auto response = std::make_shared<Response>();
+
+        auto work = [this, fileIO, requestMsg, response, payloadLength]() {
+            *response = (this->*fileIO)(
+                reinterpret_cast<const pldm_msg*>(requestMsg->data()),
+                payloadLength);
+        };
+        auto done = [requestMsg, response, complete]() {
+            if (response->empty())
+            {
+                // The handler threw on the worker thread
+                *response = ccOnlyResponse(
+                    reinterpret_cast<const pldm_msg*>(requestMsg->data()),
+                    PLDM_ERROR);
+            }
+            complete(std::move(*response));
+        };
+
+        if (!workerPool->submit(std::move(work), std::move(done)))
+        {
+            // The pool is saturated, handle the command inline
+            complete((this->*fileIO)(request, payloadLength));
+        }
+    });
+}
+
+void Handler::offloadByTypeToWorker(Command command)
+{
+    deferredHandlers.emplace(command, [this, command](
+                                          const pldm_msg* request,
+                                          size_t payloadLength,
+                                          ResponseCompletion&& complete) {
+        // The file handler is created on the event loop, its constructor may
+        // make D-Bus calls
+        auto response = std::make_shared<Response>(
+            sizeof(pldm_msg_hdr) + PLDM_RW_FILE_BY_TYPE_MEM_RESP_BYTES, 0);
+        auto transfer = decodeMemoryTransfer(command, request, payloadLength,
+                                             dbusImplReqester, handler,
+                                             *response);
+        if (!transfer)
+        {
+            complete(std::move(*response));
+            return;
+        }
+
+        auto instanceId = request->hdr.instance_id;
+        auto upstream = command == PLDM_READ_FILE_BY_TYPE_INTO_MEMORY;
+        auto rc = std::make_shared<int>(PLDM_ERROR);
+        auto done = [command, instanceId, response, rc,
+                     length = transfer->length, complete]() {
+            encode_rw_file_by_type_memory_resp(
+                instanceId, command, *rc, length,
+                reinterpret_cast<pldm_msg*>(response->data()));
+            complete(std::move(*response));
+        };
+        if (!transfer->fileHandler->isWorkerSafe(upstream, oemPlatformHandler))
+        {
+            *rc = runMemoryTransfer(command, *transfer, oemPlatformHandler);
+            done();
+            return;
+        }
+
+        auto shared = std::make_shared<MemoryTransfer>(std::move(*transfer));
+        auto work = [command, shared, rc]() {
+            *rc = runMemoryTransfer(command, *shared, nullptr);
+        };
+        if (!workerPool->submit(work, done))
+        {
+            // The pool is saturated, run the transfer inline
+            work();
+            done();
+        }
+    });
+}
+
 void Handler::postWriteCallBack(
     const uint16_t fileType, const uint32_t fileHandle,
     const struct fileack_status_metadata& metaDataObj)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/utils.hpp"
+#include "common/worker_pool.hpp"
 #include "oem/ibm/requester/dbus_to_file_handler.hpp"
 #include "oem_ibm_handler.hpp"
 #include "pldmd/handler.hpp"
@@ -173,10 +174,12 @@ class Handler : public CmdHandler
     Handler(oem_platform::Handler* oemPlatformHandler, int hostSockFd,
             uint8_t hostEid, dbus_api::Requester* dbusImplReqester,
             pldm::requester::Handler<pldm::requester::Request>* handler,
-            sdeventplus::Event& event) :
+            sdeventplus::Event& event,
+            pldm::WorkerPool* workerPool = nullptr) :
         oemPlatformHandler(oemPlatformHandler),
         hostSockFd(hostSockFd), hostEid(hostEid),
-        dbusImplReqester(dbusImplReqester), handler(handler), event(event)
+        dbusImplReqester(dbusImplReqester), handler(handler), event(event),
+        workerPool(workerPool)
     {
         handlers.emplace(PLDM_READ_FILE_INTO_MEMORY,
                          [this](const pldm_msg* request, size_t payloadLength) {
@@ -236,6 +239,24 @@ class Handler : public CmdHandler
             return this->newFileAvailableWithMetaData(request, payloadLength);
         });
 
+        if (workerPool)
+        {
+            // File IO by file handle only touches the file table and the file
+            // system, so it is safe to run on the worker pool and large
+            // transfers don't hold up the other commands.
+            offloadToWorker(PLDM_READ_FILE_INTO_MEMORY,
+                            &Handler::readFileIntoMemory);
+            offloadToWorker(PLDM_WRITE_FILE_FROM_MEMORY,
+                            &Handler::writeFileFromMemory);
+            offloadToWorker(PLDM_READ_FILE, &Handler::readFile);
+            offloadToWorker(PLDM_WRITE_FILE, &Handler::writeFile);
+
+            // File IO by type into memory only runs there for the file types
+            // whose transfer is plain file IO, see FileHandler::isWorkerSafe
+            offloadByTypeToWorker(PLDM_READ_FILE_BY_TYPE_INTO_MEMORY);
+            offloadByTypeToWorker(PLDM_WRITE_FILE_BY_TYPE_FROM_MEMORY);
+        }
+
         resDumpMatcher = std::make_unique<sdbusplus::bus::match::match>(
             pldm::utils::DBusHandler::getBus(),
             sdbusplus::bus::match::rules::interfacesAdded() +
@@ -493,6 +514,25 @@ class Handler : public CmdHandler
                            const struct fileack_status_metadata& metaDataObj);
 
   private:
+    /** @brief Register a deferred handler that runs a file IO command handler
+     *         on the worker pool and sends its response from the event loop
+     *
+     *  @param[in] command - PLDM command code
+     *  @param[in] fileIO - synchronous handler of the command, it must be safe
+     *                      to run on a worker thread
+     */
+    void offloadToWorker(Command command,
+                         Response (Handler::*fileIO)(const pldm_msg*, size_t));
+
+    /** @brief Register a deferred handler for a read/write file by type into
+     *         memory command. The request is decoded on the event loop and
+     *         the transfer runs on the worker pool if the file type allows it.
+     *
+     *  @param[in] command - PLDM_READ_FILE_BY_TYPE_INTO_MEMORY or
+     *                       PLDM_WRITE_FILE_BY_TYPE_FROM_MEMORY
+     */
+    void offloadByTypeToWorker(Command command);
+
     oem_platform::Handler* oemPlatformHandler;
     int hostSockFd;
     uint8_t hostEid;
@@ -520,6 +560,8 @@ class Handler : public CmdHandler
     sdeventplus::Event& event;
     /** @brief sdeventplus defer event source */
     std::unique_ptr<sdeventplus::source::Defer> smsEvent;
+    /** @brief pool running blocking file IO off the event loop */
+    pldm::WorkerPool* workerPool;
 };
 
 } // namespace oem_ibm
@@ -46,6 +46,22 @@ class FileHandler
                                uint64_t address,
                                oem_platform::Handler* oemPlatformHandler) = 0;
 
+    /** @brief Method to check if the transfer of an oem file type from or
+     *  into host memory only does file IO and DMA, so that it can run on a
+     *  worker thread. It is then called there without the oem platform
+     *  handler, file types that depend on it resolve what they need here.
+     *  @param[in] upstream - true for readIntoMemory, false for
+     *                        writeFromMemory
+     *  @param[in] oemPlatformHandler - oem handler for PLDM platform related
+     *                                  tasks
+     *  @return true if the transfer can run on a worker thread
+     */
+    virtual bool isWorkerSafe(bool /*upstream*/,
+                              oem_platform::Handler* /*oemPlatformHandler*/)
+    {
+        return false;
+    }
+
     /** @brief Method to read an oem file type's content into the PLDM response.
      *  @param[in] offset - offset to read
      *  @param[in/out] length - length to be read
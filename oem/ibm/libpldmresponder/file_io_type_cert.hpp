@@ -35,6 +35,16 @@ class CertHandler : public FileHandler
     virtual int readIntoMemory(uint32_t offset, uint32_t length,
                                uint64_t address,
                                oem_platform::Handler* /*oemPlatformHandler*/);
+
+    /** @brief Certificate signing requests are read from their own file,
+     *  writes update the certificates shared with newFileAvailable
+     */
+    virtual bool isWorkerSafe(bool upstream,
+                              oem_platform::Handler* /*oemPlatformHandler*/)
+    {
+        return upstream;
+    }
+
     virtual int read(uint32_t offset, uint32_t& length, Response& response,
                      oem_platform::Handler* /*oemPlatformHandler*/);
 
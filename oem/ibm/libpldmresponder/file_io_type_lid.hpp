@@ -248,6 +248,14 @@ class LidHandler : public FileHandler
         return PLDM_ERROR;
     }
 
+    virtual bool isWorkerSafe(bool upstream,
+                              oem_platform::Handler* oemPlatformHandler)
+    {
+        // The LID path is resolved from the boot side here, the read then
+        // only does file IO and DMA. Writes may complete a code update.
+        return upstream && constructLIDPath(oemPlatformHandler);
+    }
+
     virtual int write(const char* buffer, uint32_t offset, uint32_t& length,
                       oem_platform::Handler* oemPlatformHandler,
                       struct fileack_status_metadata& /*metaDataObj*/)
@@ -190,6 +190,15 @@ class PCIeInfoHandler : public FileHandler
                                uint64_t address,
                                oem_platform::Handler* /*oemPlatformHandler*/);
 
+    /** @brief The topology and cable information are written to their own
+     *  files, they are only parsed once the host acknowledges them
+     */
+    virtual bool isWorkerSafe(bool upstream,
+                              oem_platform::Handler* /*oemPlatformHandler*/)
+    {
+        return !upstream;
+    }
+
     virtual int read(uint32_t offset, uint32_t& length, Response& response,
                      oem_platform::Handler* /*oemPlatformHandler*/);
 
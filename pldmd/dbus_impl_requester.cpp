@@ -13,12 +13,6 @@ namespace dbus_api
 
 uint8_t Requester::getInstanceId(uint8_t eid)
 {
-    if (ids.find(eid) == ids.end())
-    {
-        InstanceId id;
-        ids.emplace(eid, InstanceId());
-    }
-
     uint8_t id{};
     try
     {
@@ -6,7 +6,9 @@
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/server/object.hpp>
 
-#include <map>
+#include <array>
+#include <limits>
+#include <optional>
 
 namespace pldm
 {
@@ -41,6 +43,16 @@ class Requester : public RequesterIntf
     /** @brief Implementation for RequesterIntf.GetInstanceId */
     uint8_t getInstanceId(uint8_t eid) override;
 
+    /** @brief Get an instance id only if one is unused, unlike
+     *         getInstanceId the oldest one is never released
+     *  @param[in] eid - MCTP eid to get the instance id for
+     *  @return - PLDM instance id or nullopt if all of them are in use
+     */
+    std::optional<uint8_t> tryGetInstanceId(uint8_t eid)
+    {
+        return ids[eid].tryNext();
+    }
+
     /** @brief Mark an instance id as unused
      *  @param[in] eid - MCTP eid to which this instance id belongs
      *  @param[in] instanceId - PLDM instance id to be freed
@@ -52,8 +64,8 @@ class Requester : public RequesterIntf
     }
 
   private:
-    /** @brief EID to PLDM Instance ID map */
-    std::map<uint8_t, InstanceId> ids;
+    /** @brief PLDM Instance IDs indexed by EID */
+    std::array<InstanceId, std::numeric_limits<uint8_t>::max() + 1> ids;
 };
 
 } // namespace dbus_api
@@ -0,0 +1,66 @@
+#include "dbus_impl_stats.hpp"
+
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/message.hpp>
+
+#include <tuple>
+#include <vector>
+
+namespace pldm
+{
+namespace dbus_api
+{
+
+using StatsEntry = std::tuple<uint8_t, uint8_t, uint8_t, uint64_t, uint64_t,
+                              uint64_t, uint64_t, std::vector<uint64_t>>;
+
+const sdbusplus::vtable_t Stats::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::method("GetResponderStats", "", statsSignature,
+                              Stats::getResponderStats),
+    sdbusplus::vtable::method("GetRequesterStats", "", statsSignature,
+                              Stats::getRequesterStats),
+    sdbusplus::vtable::end()};
+
+int Stats::getResponderStats(sd_bus_message* msg, void* /*context*/,
+                             sd_bus_error* error)
+{
+    return replyStats(msg, stats::CommandStats::getResponderStats(), error);
+}
+
+int Stats::getRequesterStats(sd_bus_message* msg, void* /*context*/,
+                             sd_bus_error* error)
+{
+    return replyStats(msg, stats::CommandStats::getRequesterStats(), error);
+}
+
+int Stats::replyStats(sd_bus_message* msg, const stats::CommandStats& stats,
+                      sd_bus_error* error)
+{
+    try
+    {
+        std::vector<StatsEntry> entries;
+        entries.reserve(stats.getEntries().size());
+        for (const auto& [key, entry] : stats.getEntries())
+        {
+            entries.emplace_back(
+                key.type, key.command, key.eid, entry.count, entry.errors,
+                entry.timeouts, entry.maxLatencyUs,
+                std::vector<uint64_t>(entry.histogram.begin(),
+                                      entry.histogram.end()));
+        }
+
+        auto call = sdbusplus::message_t(msg);
+        auto reply = call.new_method_return();
+        reply.append(entries);
+        reply.method_return();
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        return sd_bus_error_set(error, e.name(), e.description());
+    }
+    return 1;
+}
+
+} // namespace dbus_api
+} // namespace pldm
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "common/command_stats.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <string>
+
+namespace pldm
+{
+namespace dbus_api
+{
+
+/** @class Stats
+ *  @brief xyz.openbmc_project.PLDM.Stats implementation
+ *  @details Exports the PLDM command stats of the responder and the requester
+ *  with the methods GetResponderStats and GetRequesterStats. Both return an
+ *  array of (PLDM type, PLDM command, EID, count, errors, timeouts, max latency
+ *  in us, latency histogram) structs, the histogram buckets are described in
+ *  pldm::stats::CommandStats.
+ */
+class Stats
+{
+  public:
+    Stats() = delete;
+    Stats(const Stats&) = delete;
+    Stats& operator=(const Stats&) = delete;
+    Stats(Stats&&) = delete;
+    Stats& operator=(Stats&&) = delete;
+    ~Stats() = default;
+
+    /** @brief Constructor to put object onto bus at a dbus path.
+     *  @param[in] bus - Bus to attach to.
+     *  @param[in] path - Path to attach at.
+     */
+    Stats(sdbusplus::bus_t& bus, const std::string& path) :
+        intf(bus, path.c_str(), interface, vtable, this)
+    {}
+
+  private:
+    static constexpr auto interface = "xyz.openbmc_project.PLDM.Stats";
+
+    /** @brief D-Bus signature of the stats returned by the methods */
+    static constexpr auto statsSignature = "a(yyyttttat)";
+
+    static const sdbusplus::vtable_t vtable[];
+
+    /** @brief Callback of the GetResponderStats method */
+    static int getResponderStats(sd_bus_message* msg, void* context,
+                                 sd_bus_error* error);
+
+    /** @brief Callback of the GetRequesterStats method */
+    static int getRequesterStats(sd_bus_message* msg, void* context,
+                                 sd_bus_error* error);
+
+    /** @brief Reply to a method call with the command stats
+     *
+     *  @param[in] msg - method call message
+     *  @param[in] stats - stats to reply with
+     *  @param[out] error - D-Bus error on failure
+     *
+     *  @return 1 on success, negative errno on failure
+     */
+    static int replyStats(sd_bus_message* msg,
+                          const stats::CommandStats& stats,
+                          sd_bus_error* error);
+
+    sdbusplus::server::interface_t intf;
+};
+
+} // namespace dbus_api
+} // namespace pldm
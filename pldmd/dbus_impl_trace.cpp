@@ -0,0 +1,78 @@
+#include "dbus_impl_trace.hpp"
+
+#include "common/packet_tracer.hpp"
+
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/message.hpp>
+
+#include <vector>
+
+using pldm::tracer::PacketTracer;
+
+namespace pldm
+{
+namespace dbus_api
+{
+
+const sdbusplus::vtable_t Trace::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::method("Enable", "b", "", Trace::enable),
+    sdbusplus::vtable::method("SetFilter", "ayay", "", Trace::setFilter),
+    sdbusplus::vtable::method("GetDropped", "", "t", Trace::getDropped),
+    sdbusplus::vtable::end()};
+
+int Trace::enable(sd_bus_message* msg, void* /*context*/, sd_bus_error* error)
+{
+    try
+    {
+        auto call = sdbusplus::message_t(msg);
+        bool enable{};
+        call.read(enable);
+        PacketTracer::getInstance().enable(enable);
+        call.new_method_return().method_return();
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        return sd_bus_error_set(error, e.name(), e.description());
+    }
+    return 1;
+}
+
+int Trace::setFilter(sd_bus_message* msg, void* /*context*/,
+                     sd_bus_error* error)
+{
+    try
+    {
+        auto call = sdbusplus::message_t(msg);
+        std::vector<uint8_t> eids;
+        std::vector<uint8_t> types;
+        call.read(eids, types);
+        PacketTracer::getInstance().setFilter(eids, types);
+        call.new_method_return().method_return();
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        return sd_bus_error_set(error, e.name(), e.description());
+    }
+    return 1;
+}
+
+int Trace::getDropped(sd_bus_message* msg, void* /*context*/,
+                      sd_bus_error* error)
+{
+    try
+    {
+        auto call = sdbusplus::message_t(msg);
+        auto reply = call.new_method_return();
+        reply.append(PacketTracer::getInstance().getDropped());
+        reply.method_return();
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        return sd_bus_error_set(error, e.name(), e.description());
+    }
+    return 1;
+}
+
+} // namespace dbus_api
+} // namespace pldm
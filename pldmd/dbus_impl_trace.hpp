@@ -0,0 +1,63 @@
+#pragma once
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <string>
+
+namespace pldm
+{
+namespace dbus_api
+{
+
+/** @class Trace
+ *  @brief xyz.openbmc_project.PLDM.Trace implementation
+ *  @details Runtime control of the PLDM message tracing of pldmd, see
+ *  pldm::tracer::PacketTracer. The interface has the methods
+ *  Enable(b enable), SetFilter(ay eids, ay types) where an empty array selects
+ *  all the EIDs or PLDM types, and GetDropped() returning the number of
+ *  messages not traced because of the rate limit or a full trace queue.
+ */
+class Trace
+{
+  public:
+    Trace() = delete;
+    Trace(const Trace&) = delete;
+    Trace& operator=(const Trace&) = delete;
+    Trace(Trace&&) = delete;
+    Trace& operator=(Trace&&) = delete;
+    ~Trace() = default;
+
+    /** @brief Constructor to put object onto bus at a dbus path.
+     *  @param[in] bus - Bus to attach to.
+     *  @param[in] path - Path to attach at.
+     */
+    Trace(sdbusplus::bus_t& bus, const std::string& path) :
+        intf(bus, path.c_str(), interface, vtable, this)
+    {}
+
+  private:
+    static constexpr auto interface = "xyz.openbmc_project.PLDM.Trace";
+
+    static const sdbusplus::vtable_t vtable[];
+
+    /** @brief Callback of the Enable method */
+    static int enable(sd_bus_message* msg, void* context,
+                      sd_bus_error* error);
+
+    /** @brief Callback of the SetFilter method */
+    static int setFilter(sd_bus_message* msg, void* context,
+                         sd_bus_error* error);
+
+    /** @brief Callback of the GetDropped method */
+    static int getDropped(sd_bus_message* msg, void* context,
+                          sd_bus_error* error);
+
+    sdbusplus::server::interface_t intf;
+};
+
+} // namespace dbus_api
+} // namespace pldm
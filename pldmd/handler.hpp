@@ -2,9 +2,12 @@
 
 #include "libpldm/base.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <functional>
-#include <map>
+#include <limits>
+#include <mutex>
 #include <vector>
 
 namespace pldm
@@ -20,6 +23,168 @@ class CmdHandler;
 using HandlerFunc =
     std::function<Response(const pldm_msg* request, size_t reqMsgLen)>;
 
+/** @brief Completion token of a deferred command handler, invoking it sends
+ *         the response to the requester. It must be invoked exactly once, from
+ *         the main event loop.
+ */
+using ResponseCompletion = std::function<void(Response&& response)>;
+
+/** @brief Deferred command handler, the request message is only valid for the
+ *         duration of the call and the response is sent later by invoking the
+ *         completion token, typically from an async D-Bus reply or IO callback.
+ */
+using DeferredHandlerFunc =
+    std::function<void(const pldm_msg* request, size_t reqMsgLen,
+                       ResponseCompletion&& complete)>;
+
+/** @class CommandTable
+ *
+ *  Dense dispatch table of command handlers indexed by the PLDM command code.
+ *  A 256 entry array maps the command code to a slot in a compact vector of
+ *  handlers, so looking up a command is two array accesses and an unsupported
+ *  command is detected without throwing. The emplace() and contains() members
+ *  mirror std::map so derived command handlers register their commands the
+ *  same way they always have.
+ */
+template <typename Func>
+class CommandTable
+{
+  public:
+    /** @brief Register a handler for a command, like std::map::emplace an
+     *         already registered command is not overwritten
+     *
+     *  @param[in] command - PLDM command code
+     *  @param[in] func - command handler
+     *  @return true if the handler was registered
+     */
+    template <typename F>
+    bool emplace(Command command, F&& func)
+    {
+        if (index[command])
+        {
+            return false;
+        }
+        funcs.emplace_back(std::forward<F>(func));
+        index[command] = static_cast<uint16_t>(funcs.size());
+        return true;
+    }
+
+    /** @brief Check if a handler is registered for a command
+     *
+     *  @param[in] command - PLDM command code
+     *  @return true if the command has a handler
+     */
+    bool contains(Command command) const
+    {
+        return index[command] != 0;
+    }
+
+    /** @brief Look up the handler of a command
+     *
+     *  @param[in] command - PLDM command code
+     *  @return pointer to the handler, nullptr if the command has none
+     */
+    const Func* find(Command command) const
+    {
+        auto slot = index[command];
+        return slot ? &funcs[slot - 1] : nullptr;
+    }
+
+  private:
+    static constexpr size_t maxCommands =
+        std::numeric_limits<Command>::max() + 1;
+
+    /** @brief 1-based slot in funcs per command code, 0 when unsupported */
+    std::array<uint16_t, maxCommands> index{};
+
+    /** @brief registered handlers, in registration order */
+    std::vector<Func> funcs;
+};
+
+/** @class ResponsePool
+ *
+ *  Free list of response buffers. Buffers handed out by the pool keep the
+ *  capacity of previously sent responses, so building a response and growing
+ *  it with resize()/insert() while encoding does not reallocate and copy the
+ *  payload. pldmd returns the buffer to the pool once it has been sent, a
+ *  buffer dropped instead, e.g. for an error response, is simply freed.
+ */
+class ResponsePool
+{
+  public:
+    ResponsePool(const ResponsePool&) = delete;
+    ResponsePool(ResponsePool&&) = delete;
+    ResponsePool& operator=(const ResponsePool&) = delete;
+    ResponsePool& operator=(ResponsePool&&) = delete;
+    ~ResponsePool() = default;
+
+    /** @brief Buffers with a capacity bigger than this are not retained */
+    static constexpr size_t maxRetainedCapacity = 64 * 1024;
+
+    /** @brief Capacity reserved for buffers created by the pool */
+    static constexpr size_t defaultCapacity = 4096;
+
+    /** @brief Maximum number of buffers retained in the pool */
+    static constexpr size_t maxBuffers = 16;
+
+    static ResponsePool& getInstance()
+    {
+        static ResponsePool pool;
+        return pool;
+    }
+
+    /** @brief Get a zero filled response buffer
+     *
+     *  @param[in] size - size of the response message including the PLDM
+     *                    message header
+     *
+     *  @return response buffer of the requested size
+     */
+    Response acquire(size_t size)
+    {
+        Response response;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!freeList.empty())
+            {
+                response = std::move(freeList.back());
+                freeList.pop_back();
+            }
+        }
+        response.reserve(std::max(size, defaultCapacity));
+        response.assign(size, 0);
+        return response;
+    }
+
+    /** @brief Return a sent response buffer to the pool
+     *
+     *  @param[in] response - response buffer that is no longer needed
+     */
+    void release(Response&& response)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (response.capacity() > maxRetainedCapacity)
+        {
+            return;
+        }
+
+        if (freeList.size() < maxBuffers)
+        {
+            response.clear();
+            freeList.emplace_back(std::move(response));
+        }
+    }
+
+  private:
+    ResponsePool()
+    {
+        freeList.reserve(maxBuffers);
+    }
+
+    std::mutex lock;                //!< guards the free list
+    std::vector<Response> freeList; //!< buffers available for reuse
+};
+
 class CmdHandler
 {
   public:
@@ -30,12 +195,49 @@ class CmdHandler
      *  @param[in] pldmCommand - PLDM command code
      *  @param[in] request - PLDM request message
      *  @param[in] reqMsgLen - PLDM request message size
-     *  @return PLDM response message
+     *  @return PLDM response message, a response with completion code
+     *          PLDM_ERROR_UNSUPPORTED_PLDM_CMD if the command has no handler
      */
     Response handle(Command pldmCommand, const pldm_msg* request,
                     size_t reqMsgLen)
     {
-        return handlers.at(pldmCommand)(request, reqMsgLen);
+        auto handler = handlers.find(pldmCommand);
+        if (!handler)
+        {
+            return ccOnlyResponse(request, PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+        }
+        return (*handler)(request, reqMsgLen);
+    }
+
+    /** @brief Check if a PLDM command is handled by a deferred handler
+     *
+     *  @param[in] pldmCommand - PLDM command code
+     *  @return true if the command response is sent asynchronously
+     */
+    bool isDeferred(Command pldmCommand) const
+    {
+        return deferredHandlers.contains(pldmCommand);
+    }
+
+    /** @brief Invoke a deferred PLDM command handler
+     *
+     *  @param[in] pldmCommand - PLDM command code
+     *  @param[in] request - PLDM request message
+     *  @param[in] reqMsgLen - PLDM request message size
+     *  @param[in] complete - completion token to send the response with
+     *  @return true if the command has a deferred handler, false otherwise
+     *          in which case the completion token is not consumed
+     */
+    bool handleDeferred(Command pldmCommand, const pldm_msg* request,
+                        size_t reqMsgLen, ResponseCompletion&& complete)
+    {
+        auto handler = deferredHandlers.find(pldmCommand);
+        if (!handler)
+        {
+            return false;
+        }
+        (*handler)(request, reqMsgLen, std::move(complete));
+        return true;
     }
 
     /** @brief Create a response message containing only cc
@@ -46,7 +248,7 @@ class CmdHandler
      */
     static Response ccOnlyResponse(const pldm_msg* request, uint8_t cc)
     {
-        Response response(sizeof(pldm_msg), 0);
+        auto response = allocResponse(sizeof(pldm_msg));
         auto ptr = reinterpret_cast<pldm_msg*>(response.data());
         auto rc = encode_cc_only_resp(request->hdr.instance_id,
                                       request->hdr.type, request->hdr.command,
@@ -55,11 +257,30 @@ class CmdHandler
         return response;
     }
 
+    /** @brief Get a zero filled response buffer from the response pool,
+     *         large responses should use this instead of constructing a
+     *         Response so the buffer capacity is reused across requests.
+     *
+     *  @param[in] size - size of the response message including the PLDM
+     *                    message header
+     *  @return PLDM response message buffer
+     */
+    static Response allocResponse(size_t size)
+    {
+        return ResponsePool::getInstance().acquire(size);
+    }
+
   protected:
-    /** @brief map of PLDM command code to handler - to be populated by derived
-     *         classes.
+    /** @brief table of PLDM command code to handler - to be populated by
+     *         derived classes.
+     */
+    CommandTable<HandlerFunc> handlers;
+
+    /** @brief table of PLDM command code to deferred handler - to be
+     *         populated by derived classes whose commands complete
+     *         asynchronously.
      */
-    std::map<Command, HandlerFunc> handlers;
+    CommandTable<DeferredHandlerFunc> deferredHandlers;
 };
 
 } // namespace responder
@@ -2,6 +2,7 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <bit>
 #include <stdexcept>
 
 PHOSPHOR_LOG2_USING;
@@ -10,70 +11,110 @@ namespace pldm
 {
 uint8_t InstanceId::next()
 {
-    uint8_t idx = 0;
-    while (idx < id.size() && id.test(idx))
+    auto idx = tryNext();
+    if (idx.has_value())
     {
-        ++idx;
+        return idx.value();
     }
 
-    if (idx == id.size())
+    // check all the instance ids and free up the one
+    // that is acquired oldest
+    error("lg2 all the Instance ids are exhausted");
+
+    auto instance = returnOldestId();
+    if (!instance.has_value())
     {
-        // check all the instance ids and free up the one
-        // that is acquired oldest
-        error("lg2 all the Instance ids are exhausted");
-
-        auto instance = returnOldestId();
-        if (instance.has_value())
-        {
-            idx = instance.value();
-            // forcefully release the instance id
-            markFree(idx);
-        }
-        else
-        {
-            throw std::runtime_error(
-                "Instance Id older than instance id expiration time could not be found");
-        }
+        throw std::runtime_error(
+            "Instance Id older than instance id expiration time could not be found");
     }
 
-    id.set(idx);
-    timestamp[idx] = std::chrono::system_clock::now();
+    // forcefully release the instance id
+    markFree(instance.value());
+    return tryNext().value();
+}
+
+std::optional<uint8_t> InstanceId::tryNext()
+{
+    auto unused = ~used;
+    if (!unused)
+    {
+        return std::nullopt;
+    }
+
+    // The first unused id from the cursor on, wrapping around
+    uint8_t idx = (cursor + std::countr_zero(std::rotr(unused, cursor))) %
+                  maxInstanceIds;
+    cursor = (idx + 1) % maxInstanceIds;
+
+    used |= uint32_t{1} << idx;
+    timestamp[idx] = std::chrono::steady_clock::now();
+    prev[idx] = newest;
+    succ[idx] = none;
+    if (newest == none)
+    {
+        oldest = idx;
+    }
+    else
+    {
+        succ[newest] = idx;
+    }
+    newest = idx;
     return idx;
 }
 
 std::optional<uint8_t> InstanceId::returnOldestId()
 {
-    uint8_t idx = 0;
-    bool skipInstance = true;
-    auto now = std::chrono::system_clock::now();
-    std::chrono::duration<double> elapsedtime{};
-
-    for (const auto& [instanceId, timepoint] : timestamp)
+    if (oldest == none)
     {
-        std::chrono::duration<double> instanceTime = now - timepoint;
-        if (instanceTime >
-            std::chrono::seconds(INSTANCE_ID_EXPIRATION_INTERVAL))
-        {
-            skipInstance = false;
-        }
-        if (instanceTime > elapsedtime)
-        {
-            elapsedtime = instanceTime;
-            idx = instanceId;
-        }
+        return std::nullopt;
     }
-    if (skipInstance)
+
+    auto age = std::chrono::steady_clock::now() - timestamp[oldest];
+    if (age <= std::chrono::seconds(INSTANCE_ID_EXPIRATION_INTERVAL))
     {
         error(
             "lg2 None of the instance id's are older then the pldm instance id expiration time");
         return std::nullopt;
     }
-    const std::time_t t_c =
-        std::chrono::system_clock::to_time_t(timestamp[idx]);
-    std::cerr << "Forcefully releasing Instance ID :" << (unsigned)idx
-              << " Last used at timestamp : "
-              << std::put_time(std::localtime(&t_c), "%F %T\n") << std::flush;
-    return idx;
+
+    error(
+        "Forcefully releasing Instance ID {INSTANCE_ID}, last used {AGE_MS} ms ago",
+        "INSTANCE_ID", (unsigned)oldest, "AGE_MS",
+        std::chrono::duration_cast<std::chrono::milliseconds>(age).count());
+    return oldest;
+}
+
+void InstanceId::markFree(uint8_t instanceId)
+{
+    if (instanceId >= maxInstanceIds)
+    {
+        throw std::out_of_range("Invalid PLDM instance id");
+    }
+
+    auto bit = uint32_t{1} << instanceId;
+    if (!(used & bit))
+    {
+        return;
+    }
+    used &= ~bit;
+
+    // Unlink the id from the ids in use
+    if (prev[instanceId] == none)
+    {
+        oldest = succ[instanceId];
+    }
+    else
+    {
+        succ[prev[instanceId]] = succ[instanceId];
+    }
+    if (succ[instanceId] == none)
+    {
+        newest = prev[instanceId];
+    }
+    else
+    {
+        prev[succ[instanceId]] = prev[instanceId];
+    }
 }
 
 } // namespace pldm
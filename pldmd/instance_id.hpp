@@ -1,11 +1,8 @@
 #pragma once
 
-#include <bitset>
+#include <array>
 #include <chrono>
-#include <ctime>
-#include <iomanip>
-#include <iostream>
-#include <map>
+#include <cstdint>
 #include <optional>
 
 namespace pldm
@@ -15,34 +12,54 @@ constexpr size_t maxInstanceIds = 32;
 
 /** @class InstanceId
  *  @brief Implementation of PLDM instance id as per DSP0240 v1.0.0
+ *  @details The instance ids are handed out round-robin, so that an id freed
+ *  by a timed out request is not reused right away, and the ids in use are
+ *  kept in the order they were handed out so that the oldest one is found
+ *  in constant time. The timestamps use the monotonic clock, setting the
+ *  BMC time doesn't affect the expiration of the ids.
  */
 class InstanceId
 {
   public:
     /** @brief Get next unused instance id
      *  @return - PLDM instance id
+     *  @note will throw std::runtime_error if all of them are in use and none
+     *        is older than the instance id expiration interval
      */
     uint8_t next();
 
-    /** @brief Get the oldest instance id based on timestamp
+    /** @brief Get next unused instance id, without releasing the oldest one
+     *         when all of them are in use
+     *  @return - PLDM instance id or nullopt if all of them are in use
+     */
+    std::optional<uint8_t> tryNext();
+
+    /** @brief Get the oldest instance id, if it is older than the instance
+     *         id expiration interval
      *  @return - Oldest PLDM instance id or nullopt
      */
     std::optional<uint8_t> returnOldestId();
 
     /** @brief Mark an instance id as unused
      *  @param[in] instanceId - PLDM instance id to be freed
+     *  @note will throw std::out_of_range if instanceId > 31
      */
-    void markFree(uint8_t instanceId)
-    {
-        id.set(instanceId, false);
-        // Clear the time stamp associated with the instance id
-        timestamp.erase(instanceId);
-    }
+    void markFree(uint8_t instanceId);
 
   private:
-    std::bitset<maxInstanceIds> id;
-    std::map<uint8_t, std::chrono::time_point<std::chrono::system_clock>>
-        timestamp;
+    /** @brief End of the list of the ids in use */
+    static constexpr uint8_t none = maxInstanceIds;
+
+    static_assert(maxInstanceIds == 32, "The ids in use are a 32-bit mask");
+
+    uint32_t used = 0;     //!< mask of the ids in use
+    uint8_t cursor = 0;    //!< id to start the search of the next one from
+    uint8_t oldest = none; //!< first id in use, in the order handed out
+    uint8_t newest = none; //!< last id in use, in the order handed out
+    std::array<uint8_t, maxInstanceIds> prev{}; //!< previous id in use
+    std::array<uint8_t, maxInstanceIds> succ{}; //!< next id in use
+    std::array<std::chrono::steady_clock::time_point, maxInstanceIds>
+        timestamp{}; //!< time each id in use was handed out
 };
 
 } // namespace pldm
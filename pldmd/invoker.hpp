@@ -4,8 +4,9 @@
 
 #include "handler.hpp"
 
-#include <map>
+#include <array>
 #include <memory>
+#include <stdexcept>
 
 namespace pldm
 {
@@ -18,14 +19,28 @@ namespace responder
 class Invoker
 {
   public:
+    /** @brief Number of PLDM types, the type is a 6 bit field of the PLDM
+     *         message header
+     */
+    static constexpr size_t maxTypes = 64;
+
     /** @brief Register a handler for a PLDM Type
      *
      *  @param[in] pldmType - PLDM type code
      *  @param[in] handler - PLDM Type handler
+     *
+     *  @throw std::out_of_range if pldmType is not a valid PLDM type
      */
     void registerHandler(Type pldmType, std::unique_ptr<CmdHandler> handler)
     {
-        handlers.emplace(pldmType, std::move(handler));
+        if (pldmType >= maxTypes)
+        {
+            throw std::out_of_range("Invalid PLDM type");
+        }
+        if (!handlers[pldmType])
+        {
+            handlers[pldmType] = std::move(handler);
+        }
     }
 
     /** @brief Invoke a PLDM command handler
@@ -34,16 +49,55 @@ class Invoker
      *  @param[in] pldmCommand - PLDM command code
      *  @param[in] request - PLDM request message
      *  @param[in] reqMsgLen - PLDM request message size
-     *  @return PLDM response message
+     *  @return PLDM response message, a response with completion code
+     *          PLDM_ERROR_UNSUPPORTED_PLDM_CMD if the PLDM type or command
+     *          has no handler
      */
     Response handle(Type pldmType, Command pldmCommand, const pldm_msg* request,
                     size_t reqMsgLen)
     {
-        return handlers.at(pldmType)->handle(pldmCommand, request, reqMsgLen);
+        auto handler = getHandler(pldmType);
+        if (!handler)
+        {
+            return CmdHandler::ccOnlyResponse(request,
+                                              PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+        }
+        return handler->handle(pldmCommand, request, reqMsgLen);
+    }
+
+    /** @brief Invoke a deferred PLDM command handler, if the command has one
+     *
+     *  @param[in] pldmType - PLDM type code
+     *  @param[in] pldmCommand - PLDM command code
+     *  @param[in] request - PLDM request message
+     *  @param[in] reqMsgLen - PLDM request message size
+     *  @param[in] complete - completion token to send the response with
+     *  @return true if the command was dispatched to a deferred handler,
+     *          false if it has to be handled synchronously with handle()
+     */
+    bool handleDeferred(Type pldmType, Command pldmCommand,
+                        const pldm_msg* request, size_t reqMsgLen,
+                        ResponseCompletion&& complete)
+    {
+        auto handler = getHandler(pldmType);
+        return handler && handler->handleDeferred(pldmCommand, request,
+                                                  reqMsgLen,
+                                                  std::move(complete));
     }
 
   private:
-    std::map<Type, std::unique_ptr<CmdHandler>> handlers;
+    /** @brief Look up the handler of a PLDM type
+     *
+     *  @param[in] pldmType - PLDM type code
+     *  @return pointer to the handler, nullptr if the type has none
+     */
+    CmdHandler* getHandler(Type pldmType) const
+    {
+        return pldmType < maxTypes ? handlers[pldmType].get() : nullptr;
+    }
+
+    /** @brief PLDM type handlers indexed by the PLDM type code */
+    std::array<std::unique_ptr<CmdHandler>, maxTypes> handlers{};
 };
 
 } // namespace responder
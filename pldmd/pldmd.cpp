@@ -3,15 +3,24 @@
 #include "libpldm/pdr.h"
 #include "libpldm/platform.h"
 
+#include "common/command_stats.hpp"
 #include "common/flight_recorder.hpp"
+#include "common/json_preload.hpp"
+#include "common/packet_tracer.hpp"
+#include "common/tx_queue.hpp"
 #include "common/utils.hpp"
+#include "common/worker_pool.hpp"
 #include "dbus_impl_requester.hpp"
+#include "dbus_impl_stats.hpp"
+#include "dbus_impl_trace.hpp"
 #include "fw-update/manager.hpp"
 #include "host-bmc/dbus/deserialize.hpp"
 #include "invoker.hpp"
 #include "requester/handler.hpp"
 #include "requester/mctp_endpoint_discovery.hpp"
 #include "requester/request.hpp"
+#include "response_cache.hpp"
+#include "rx_batch.hpp"
 
 #include <err.h>
 #include <getopt.h>
@@ -28,14 +37,18 @@
 #include <sdeventplus/source/signal.hpp>
 #include <stdplus/signal.hpp>
 
+#include <chrono>
 #include <cstdio>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -92,10 +105,34 @@ void requestPLDMServiceName()
     bus.request_name("xyz.openbmc_project.PLDM");
 }
 
+/** @brief Sends a PLDM response message to an MCTP endpoint */
+using ResponseSender = std::function<void(uint8_t eid, Response&& response)>;
+
+/** @brief Account a PLDM command handled by the responder in the stats
+ *
+ *  @param[in] hdrFields - header fields of the request
+ *  @param[in] eid - MCTP endpoint ID of the requester
+ *  @param[in] response - PLDM response message
+ *  @param[in] start - time the request was received
+ */
+static void recordResponse(const pldm_header_info& hdrFields, uint8_t eid,
+                           const Response& response,
+                           std::chrono::steady_clock::time_point start)
+{
+    uint8_t completionCode = response.size() > sizeof(pldm_msg_hdr)
+                                 ? response[sizeof(pldm_msg_hdr)]
+                                 : static_cast<uint8_t>(PLDM_ERROR);
+    stats::CommandStats::getResponderStats().record(
+        hdrFields.pldm_type, hdrFields.command, eid, completionCode,
+        std::chrono::steady_clock::now() - start);
+}
+
 static std::optional<Response>
-    processRxMsg(const std::vector<uint8_t>& requestMsg, Invoker& invoker,
+    processRxMsg(std::span<const uint8_t> requestMsg, Invoker& invoker,
                  requester::Handler<requester::Request>& handler,
-                 fw_update::Manager* fwManager)
+                 fw_update::Manager* fwManager,
+                 const ResponseSender& sendResponse,
+                 ResponseCache& responseCache)
 {
     using type = uint8_t;
     uint8_t eid = requestMsg[0];
@@ -111,12 +148,51 @@ static std::optional<Response>
 
     if (PLDM_RESPONSE != hdrFields.msg_type)
     {
+        auto start = std::chrono::steady_clock::now();
         Response response;
         auto request = reinterpret_cast<const pldm_msg*>(hdr);
         size_t requestLen = requestMsg.size() - sizeof(struct pldm_msg_hdr) -
                             sizeof(eid) - sizeof(type);
+
+        // A request retried with the same instance ID is answered with the
+        // response already sent
+        auto requestBytes = requestMsg.subspan(sizeof(eid) + sizeof(type));
+        bool cacheable = ResponseCache::isCacheable(hdrFields.pldm_type,
+                                                    hdrFields.command);
+        if (cacheable)
+        {
+            auto cached = responseCache.lookup(eid, requestBytes);
+            if (cached)
+            {
+                recordResponse(hdrFields, eid, *cached, start);
+                return cached;
+            }
+        }
+
         try
         {
+            auto complete =
+                [&sendResponse, &responseCache, eid, hdrFields, start,
+                 cachedRequest = cacheable ? std::vector<uint8_t>(
+                                                 requestBytes.begin(),
+                                                 requestBytes.end())
+                                           : std::vector<uint8_t>{}](
+                    Response&& response) {
+                recordResponse(hdrFields, eid, response, start);
+                if (!cachedRequest.empty())
+                {
+                    responseCache.store(eid, cachedRequest, response);
+                }
+                sendResponse(eid, std::move(response));
+            };
+            if (hdrFields.pldm_type != PLDM_FWUP &&
+                invoker.handleDeferred(hdrFields.pldm_type, hdrFields.command,
+                                       request, requestLen, complete))
+            {
+                // The handler sends the response once it completes
+                return std::nullopt;
+            }
+
             if (hdrFields.pldm_type != PLDM_FWUP)
             {
                 response = invoker.handle(hdrFields.pldm_type,
@@ -131,6 +207,8 @@ static std::optional<Response>
         }
         catch (const std::out_of_range& e)
         {
+            // Unsupported commands are answered by the invoker, this only
+            // catches lookup failures escaping from a command handler
             uint8_t completion_code = PLDM_ERROR_UNSUPPORTED_PLDM_CMD;
             response.resize(sizeof(pldm_msg_hdr));
             auto responseHdr = reinterpret_cast<pldm_msg_hdr*>(response.data());
@@ -147,6 +225,11 @@ static std::optional<Response>
             }
             response.insert(response.end(), completion_code);
         }
+        recordResponse(hdrFields, eid, response, start);
+        if (cacheable)
+        {
+            responseCache.store(eid, requestBytes, response);
+        }
         return response;
     }
     else if (PLDM_RESPONSE == hdrFields.msg_type)
@@ -218,13 +301,48 @@ int main(int argc, char** argv)
     sdbusplus::server::manager::manager ledManager(
         bus, "/xyz/openbmc_project/led/groups");
     dbus_api::Requester dbusImplReq(bus, "/xyz/openbmc_project/pldm");
+    dbus_api::Stats dbusImplStats(bus, "/xyz/openbmc_project/pldm");
+    dbus_api::Trace dbusImplTrace(bus, "/xyz/openbmc_project/pldm");
+    tracer::PacketTracer::getInstance().enable(verbose);
 
     Invoker invoker{};
+    pldm::WorkerPool workerPool(event);
+
+    // Responses and requests are sent without blocking, messages the socket
+    // can't take right away are queued and sent in order on EPOLLOUT.
+    pldm::TxQueue txQueue(event, sockfd);
     requester::Handler<requester::Request> reqHandler(
-        sockfd, event, dbusImplReq, currentSendbuffSize, verbose);
+        sockfd, &txQueue, event, dbusImplReq, currentSendbuffSize);
+    ResponseCache responseCache{};
 
 #ifdef LIBPLDMRESPONDER
     using namespace pldm::state_sensor;
+    auto platformConfigHandler = std::make_unique<platform_config::Handler>();
+
+    // Parse the configuration JSONs concurrently, the handlers constructed
+    // below take them instead of parsing them one after another. The PDR
+    // JSONs are parsed by the platform handler once it builds the PDRs, and
+    // only if they are not in the PDR snapshot.
+    std::vector<std::filesystem::path> jsonPaths{
+        FRU_JSONS_DIR, FRU_MASTER_JSON, HOST_JSONS_DIR, EVENTS_JSONS_DIR};
+#ifdef SYSTEM_SPECIFIC_BIOS_JSON
+    // The BIOS JSONs of the system type, if it is known already
+    if (auto systemType = platformConfigHandler->getPlatformName())
+    {
+        jsonPaths.emplace_back(std::filesystem::path(BIOS_JSONS_DIR) /
+                               *systemType);
+    }
+#else
+    jsonPaths.emplace_back(BIOS_JSONS_DIR);
+#endif
+    pldm::utils::preloadJsons(workerPool, event, jsonPaths, CONFIG_BLOB_FILE);
+    auto preloadPDRJsons =
+        [&workerPool](const std::vector<std::filesystem::path>& files,
+                      std::function<void()> done) {
+        pldm::utils::preloadJsonsAsync(workerPool, files, std::move(done),
+                                       CONFIG_BLOB_FILE);
+    };
+
     dbus_api::Host dbusImplHost(bus, "/xyz/openbmc_project/pldm");
     std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> pdrRepo(
         pldm_pdr_init(), pldm_pdr_destroy);
@@ -258,7 +376,6 @@ int main(int argc, char** argv)
     std::unique_ptr<DbusToPLDMEvent> dbusToPLDMEventHandler;
     DBusHandler dbusHandler;
     auto hostEID = pldm::utils::readHostEID();
-    auto platformConfigHandler = std::make_unique<platform_config::Handler>();
     auto biosHandler = std::make_unique<bios::Handler>(
         sockfd, hostEID, &dbusImplReq, &reqHandler, platformConfigHandler.get(),
         requestPLDMServiceName);
@@ -291,7 +408,7 @@ int main(int argc, char** argv)
     invoker.registerHandler(PLDM_OEM,
                             std::make_unique<oem_ibm::Handler>(
                                 oemPlatformHandler.get(), sockfd, hostEID,
-                                &dbusImplReq, &reqHandler, event));
+                                &dbusImplReq, &reqHandler, event, &workerPool));
 
     // host lamp test
     std::unique_ptr<pldm::led::HostLampTest> hostLampTest =
@@ -327,7 +444,20 @@ int main(int argc, char** argv)
     auto platformHandler = std::make_unique<platform::Handler>(
         &dbusHandler, PDR_JSONS_DIR, pdrRepo.get(), hostPDRHandler.get(),
         dbusToPLDMEventHandler.get(), fruHandler.get(), bmcEntityTree.get(),
-        oemPlatformHandler.get(), event, true);
+        oemPlatformHandler.get(), event, true, std::nullopt,
+        PDR_SNAPSHOT_FILE, preloadPDRJsons);
+
+    // A retried GetPDR is not answered from before the PDRs changed, FRU
+    // hot-plug changes the FRU record table along with them
+    auto flushPDRResponses = [&responseCache]() {
+        responseCache.flush(PLDM_PLATFORM);
+        responseCache.flush(PLDM_FRU);
+    };
+    platformHandler->getRepo().setChangeHandler(flushPDRResponses);
+    if (hostPDRHandler)
+    {
+        hostPDRHandler->setPdrRepoChangeHandler(flushPDRResponses);
+    }
 #ifdef OEM_IBM
     pldm::responder::oem_ibm_platform::Handler* oemIbmPlatformHandler =
         dynamic_cast<pldm::responder::oem_ibm_platform::Handler*>(
@@ -352,6 +482,9 @@ int main(int argc, char** argv)
 
     pldm::deserialize::restoreDbusObj(hostPDRHandler.get());
 
+    // The handlers are constructed, drop the JSON files they did not take
+    pldm::utils::clearPreloadedJsons();
+
 #endif
 
     pldm::utils::CustomFD socketFd(sockfd);
@@ -385,112 +518,68 @@ int main(int argc, char** argv)
     std::unique_ptr<MctpDiscovery> mctpDiscoveryHandler =
         std::make_unique<MctpDiscovery>(bus, fwManager.get());
 
-    auto callback = [verbose, &invoker, &reqHandler, currentSendbuffSize,
-                     &fwManager](IO& io, int fd, uint32_t revents) mutable {
+    ResponseSender sendResponse = [&txQueue](uint8_t eid,
+                                             Response&& response) {
+        FlightRecorder::GetInstance().saveRecord(response, true);
+        tracer::PacketTracer::getInstance().trace(Tx, eid, response);
+        txQueue.send(eid, response);
+
+        // Hand the buffer back so its capacity is reused by the next response.
+        ResponsePool::getInstance().release(std::move(response));
+    };
+
+    RxBatch rxBatch{};
+
+    auto callback = [&invoker, &reqHandler, &fwManager, &rxBatch,
+                     &sendResponse,
+                     &responseCache](IO& io, int fd, uint32_t revents) {
         if (!(revents & EPOLLIN))
         {
             return;
         }
 
-        // Outgoing message.
-        struct iovec iov[2]{};
-
-        // This structure contains the parameter information for the response
-        // message.
-        struct msghdr msg
-        {};
+        auto dispatch = [&](std::span<const uint8_t> requestMsg) {
+            if (requestMsg.empty())
+            {
+                // MCTP daemon has closed the socket this daemon is connected
+                // to. This may or may not be an error scenario, in either case
+                // the recovery mechanism for this daemon is to restart, and
+                // hence exit the event loop, that will cause this daemon to
+                // exit with a failure code.
+                io.get_event().exit(0);
+                return;
+            }
 
-        int returnCode = 0;
-        ssize_t peekedLength = recv(fd, nullptr, 0, MSG_PEEK | MSG_TRUNC);
-        if (0 == peekedLength)
-        {
-            // MCTP daemon has closed the socket this daemon is connected to.
-            // This may or may not be an error scenario, in either case the
-            // recovery mechanism for this daemon is to restart, and hence exit
-            // the event loop, that will cause this daemon to exit with a
-            // failure code.
-            io.get_event().exit(0);
-        }
-        else if (peekedLength <= -1)
-        {
-            returnCode = -errno;
-            error("recv system call failed, RC= {RC}", "RC", returnCode);
-        }
-        else
-        {
-            std::vector<uint8_t> requestMsg(peekedLength);
-            auto recvDataLength = recv(
-                fd, static_cast<void*>(requestMsg.data()), peekedLength, 0);
-            if (recvDataLength == peekedLength)
+            FlightRecorder::GetInstance().saveRecord(requestMsg, false);
+            if (requestMsg.size() > 2)
             {
-                FlightRecorder::GetInstance().saveRecord(requestMsg, false);
-                if (verbose)
-                {
-                    printBuffer(Rx, requestMsg);
-                }
+                tracer::PacketTracer::getInstance().trace(
+                    Rx, requestMsg[0], requestMsg.subspan(2));
+            }
 
-                if (MCTP_MSG_TYPE_PLDM != requestMsg[1])
-                {
-                    // Skip this message and continue.
-                    error("Encountered Non-PLDM type message");
-                }
-                else
-                {
-                    // process message and send response
-                    auto response = processRxMsg(requestMsg, invoker,
-                                                 reqHandler, fwManager.get());
-                    if (response.has_value())
-                    {
-                        FlightRecorder::GetInstance().saveRecord(*response,
-                                                                 true);
-                        if (verbose)
-                        {
-                            printBuffer(Tx, *response);
-                        }
-
-                        iov[0].iov_base = &requestMsg[0];
-                        iov[0].iov_len = sizeof(requestMsg[0]) +
-                                         sizeof(requestMsg[1]);
-                        iov[1].iov_base = (*response).data();
-                        iov[1].iov_len = (*response).size();
-
-                        msg.msg_iov = iov;
-                        msg.msg_iovlen = sizeof(iov) / sizeof(iov[0]);
-                        if (currentSendbuffSize >= 0 &&
-                            (size_t)currentSendbuffSize < (*response).size())
-                        {
-                            int oldBuffSize = currentSendbuffSize;
-                            currentSendbuffSize = (*response).size();
-                            int res = setsockopt(fd, SOL_SOCKET, SO_SNDBUF,
-                                                 &currentSendbuffSize,
-                                                 sizeof(currentSendbuffSize));
-                            if (res == -1)
-                            {
-                                error(
-                                    "Responder : Failed to set the new send buffer size [bytes] : {CUR_BUFF_SIZE} from current size [bytes] : {OLD_BUFF_SIZE}, Error : {ERR}",
-                                    "CUR_BUFF_SIZE", currentSendbuffSize,
-                                    "OLD_BUFF_SIZE", oldBuffSize, "ERR",
-                                    strerror(errno));
-                                return;
-                            }
-                        }
-
-                        int result = sendmsg(fd, &msg, 0);
-                        if (-1 == result)
-                        {
-                            returnCode = -errno;
-                            error("sendto system call failed, RC= {RC}", "RC",
-                                  returnCode);
-                        }
-                    }
-                }
+            if (requestMsg.size() < 2 || MCTP_MSG_TYPE_PLDM != requestMsg[1])
+            {
+                // Skip this message and continue.
+                error("Encountered Non-PLDM type message");
+                return;
             }
-            else
+
+            // process message and send response
+            auto response = processRxMsg(requestMsg, invoker, reqHandler,
+                                         fwManager.get(), sendResponse,
+                                         responseCache);
+            if (response.has_value())
             {
-                error(
-                    "Failure to read peeked length packet. peekedLength = {PEEK_LEN}, recvDataLength= {RECV_DATA}",
-                    "PEEK_LEN", peekedLength, "RECV_DATA", recvDataLength);
+                sendResponse(requestMsg[0], std::move(*response));
             }
+        };
+
+        // Drain every message pending on the socket on this wake, each one is
+        // received into a preallocated buffer and dispatched in order.
+        auto rc = rxBatch.drain(fd, dispatch);
+        if (rc < 0)
+        {
+            error("recvmmsg system call failed, RC= {RC}", "RC", rc);
         }
     };
 
@@ -508,7 +597,24 @@ int main(int argc, char** argv)
 #endif
     stdplus::signal::block(SIGUSR1);
     sdeventplus::source::Signal sigUsr1(
-        event, SIGUSR1, std::bind_front(&interruptFlightRecorderCallBack));
+        event, SIGUSR1,
+        [&rxBatch](Signal& signal, const struct signalfd_siginfo* siginfo) {
+        interruptFlightRecorderCallBack(signal, siginfo);
+        rxBatch.logStats();
+    });
+    stdplus::signal::block(SIGUSR2);
+    sdeventplus::source::Signal sigUsr2(
+        event, SIGUSR2,
+        [&responseCache, &txQueue,
+         &reqHandler](Signal& /*signal*/,
+                      const struct signalfd_siginfo* /*siginfo*/) {
+        info("Received SIGUSR2(12) Signal interrupt, dumping command stats");
+        stats::CommandStats::getResponderStats().dump("Responder");
+        stats::CommandStats::getRequesterStats().dump("Requester");
+        responseCache.logStats();
+        txQueue.logStats();
+        reqHandler.logStats();
+    });
     returnCode = event.loop();
 
     if (shutdown(sockfd, SHUT_RDWR))
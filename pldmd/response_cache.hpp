@@ -0,0 +1,237 @@
+#pragma once
+
+#include "common/idempotent.hpp"
+#include "handler.hpp"
+
+#include <libpldm/base.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+namespace responder
+{
+
+/** @class ResponseCache
+ *
+ *  Remembers the last responses sent for idempotent commands, so that a
+ *  request the requester retries with the same instance ID after a timeout is
+ *  answered with the response already sent instead of running the command
+ *  handler again, as DSP0240 expects. A cached response is only replayed for
+ *  a request from the same EID with the same PLDM header and payload, within
+ *  the instance ID expiration interval. The cache has a fixed number of
+ *  entries, the oldest entry is replaced when it is full. The responses of a
+ *  PLDM type are flushed when the state they were read from changes.
+ */
+class ResponseCache
+{
+  public:
+    /** @struct Stats
+     *
+     *  Lookup counters of the cache.
+     */
+    struct Stats
+    {
+        uint64_t hits = 0;   //!< requests answered from the cache
+        uint64_t misses = 0; //!< cacheable requests not in the cache
+    };
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache(ResponseCache&&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+    ResponseCache& operator=(ResponseCache&&) = delete;
+    ~ResponseCache() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] capacity - number of responses kept, 0 disables the cache
+     *  @param[in] expiry - time a response is kept for, this is the instance
+     *                      ID expiration interval of the requesters
+     */
+    explicit ResponseCache(
+        size_t capacity = RESPONSE_CACHE_SIZE,
+        std::chrono::steady_clock::duration expiry =
+            std::chrono::seconds(INSTANCE_ID_EXPIRATION_INTERVAL)) :
+        expiry(expiry),
+        entries(capacity)
+    {}
+
+    /** @brief Check if the responses of a command can be replayed, these are
+     *         the commands that only read state, except for the live sensor
+     *         and effecter readings
+     *
+     *  A requester may reuse an instance ID as soon as it gets the response,
+     *  so a poller reading the same sensor again within the expiration
+     *  interval would be answered with the previous reading.
+     *
+     *  @param[in] type - PLDM type
+     *  @param[in] command - PLDM command
+     *  @return true if the command is idempotent and not a live reading
+     */
+    static bool isCacheable(uint8_t type, uint8_t command)
+    {
+        switch (type)
+        {
+            case PLDM_PLATFORM:
+                if (command == PLDM_GET_STATE_SENSOR_READINGS ||
+                    command == PLDM_GET_NUMERIC_EFFECTER_VALUE)
+                {
+                    return false;
+                }
+                break;
+            case PLDM_BIOS:
+                if (command == PLDM_GET_BIOS_ATTRIBUTE_CURRENT_VALUE_BY_HANDLE)
+                {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+        return isIdempotent(type, command);
+    }
+
+    /** @brief Look up the response to a retried request
+     *
+     *  @param[in] eid - MCTP endpoint ID of the requester
+     *  @param[in] request - PLDM request message, header and payload
+     *  @return copy of the cached response, std::nullopt on a miss
+     */
+    std::optional<Response> lookup(uint8_t eid,
+                                   std::span<const uint8_t> request)
+    {
+        if (entries.empty() || request.size() < sizeof(pldm_msg_hdr))
+        {
+            return std::nullopt;
+        }
+
+        auto key = makeKey(eid, request);
+        auto now = std::chrono::steady_clock::now();
+        for (const auto& entry : entries)
+        {
+            if (entry.valid && entry.key == key && now - entry.time < expiry &&
+                std::ranges::equal(entry.request, request))
+            {
+                ++stats.hits;
+                auto response = CmdHandler::allocResponse(
+                    entry.response.size());
+                std::ranges::copy(entry.response, response.begin());
+                return response;
+            }
+        }
+        ++stats.misses;
+        return std::nullopt;
+    }
+
+    /** @brief Remember the response sent to a request, only successful
+     *         responses are cached
+     *
+     *  @param[in] eid - MCTP endpoint ID of the requester
+     *  @param[in] request - PLDM request message, header and payload
+     *  @param[in] response - PLDM response message sent
+     */
+    void store(uint8_t eid, std::span<const uint8_t> request,
+               std::span<const uint8_t> response)
+    {
+        if (entries.empty() || request.size() < sizeof(pldm_msg_hdr) ||
+            response.size() <= sizeof(pldm_msg_hdr) ||
+            response[sizeof(pldm_msg_hdr)] != PLDM_SUCCESS)
+        {
+            return;
+        }
+
+        auto key = makeKey(eid, request);
+        auto it = std::ranges::find_if(entries, [key](const auto& entry) {
+            return entry.valid && entry.key == key;
+        });
+        if (it == entries.end())
+        {
+            it = entries.begin() + next;
+            next = (next + 1) % entries.size();
+        }
+
+        it->valid = true;
+        it->key = key;
+        it->time = std::chrono::steady_clock::now();
+        it->request.assign(request.begin(), request.end());
+        it->response.assign(response.begin(), response.end());
+    }
+
+    /** @brief Drop the cached responses of a PLDM type, once the state they
+     *         were read from changed
+     *
+     *  @param[in] type - PLDM type
+     */
+    void flush(uint8_t type)
+    {
+        for (auto& entry : entries)
+        {
+            if (entry.valid &&
+                reinterpret_cast<const pldm_msg_hdr*>(entry.request.data())
+                        ->type == type)
+            {
+                entry.valid = false;
+            }
+        }
+    }
+
+    /** @brief Get the lookup counters
+     *
+     *  @return const reference to the counters
+     */
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+    /** @brief Log the lookup counters */
+    void logStats() const
+    {
+        info("Response cache stats: HITS={HITS} MISSES={MISSES}", "HITS",
+             stats.hits, "MISSES", stats.misses);
+    }
+
+  private:
+    /** @struct Entry
+     *
+     *  A cached response and the request it answers.
+     */
+    struct Entry
+    {
+        bool valid = false;                    //!< entry holds a response
+        uint32_t key = 0;                      //!< see makeKey()
+        std::chrono::steady_clock::time_point time; //!< time it was sent
+        std::vector<uint8_t> request;          //!< request message
+        std::vector<uint8_t> response;         //!< response message
+    };
+
+    std::chrono::steady_clock::duration expiry; //!< lifetime of an entry
+    std::vector<Entry> entries;                 //!< cached responses
+    size_t next = 0;                            //!< next entry to replace
+    Stats stats;                                //!< lookup counters
+
+    /** @brief Key of a request, the EID, instance ID, PLDM type and command
+     *
+     *  @param[in] eid - MCTP endpoint ID of the requester
+     *  @param[in] request - PLDM request message
+     *  @return key of the request
+     */
+    static uint32_t makeKey(uint8_t eid, std::span<const uint8_t> request)
+    {
+        auto hdr = reinterpret_cast<const pldm_msg_hdr*>(request.data());
+        return static_cast<uint32_t>(eid) << 24 | hdr->instance_id << 16 |
+               hdr->type << 8 | hdr->command;
+    }
+};
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <sys/socket.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+
+/** @class RxBatch
+ *
+ *  Drains all the MCTP messages pending on the socket on a single epoll wake
+ *  using recvmmsg(2). The messages are received into a pool of preallocated
+ *  buffers that are reused across wakes, so that the receive path does not
+ *  perform any heap allocation or an extra MSG_PEEK system call per message.
+ */
+class RxBatch
+{
+  public:
+    /** @brief Number of log2 buckets in the messages-per-wake histogram, the
+     *         last bucket accumulates all the wakes with 2^(N-1) or more
+     *         messages.
+     */
+    static constexpr size_t histogramBuckets = 8;
+
+    /** @struct Stats
+     *
+     *  Receive statistics used for tuning the batch size.
+     */
+    struct Stats
+    {
+        uint64_t wakes = 0;      //!< number of epoll wakes drained
+        uint64_t messages = 0;   //!< number of messages received
+        uint64_t truncated = 0;  //!< messages dropped for exceeding buffer
+        uint64_t maxPerWake = 0; //!< max messages received in a single wake
+        std::array<uint64_t, histogramBuckets> perWake{}; //!< histogram
+    };
+
+    RxBatch(const RxBatch&) = delete;
+    RxBatch(RxBatch&&) = delete;
+    RxBatch& operator=(const RxBatch&) = delete;
+    RxBatch& operator=(RxBatch&&) = delete;
+    ~RxBatch() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] batchSize - number of messages received per recvmmsg call
+     *  @param[in] bufferSize - size of each receive buffer, messages bigger
+     *                          than this are dropped
+     */
+    explicit RxBatch(size_t batchSize = RX_BATCH_SIZE,
+                     size_t bufferSize = RX_BUFFER_SIZE) :
+        batchSize(batchSize),
+        bufferSize(bufferSize),
+        pool(std::make_unique_for_overwrite<uint8_t[]>(batchSize *
+                                                       bufferSize)),
+        iovs(batchSize), hdrs(batchSize)
+    {
+        for (size_t i = 0; i < batchSize; ++i)
+        {
+            iovs[i].iov_base = pool.get() + i * bufferSize;
+            iovs[i].iov_len = bufferSize;
+            hdrs[i].msg_hdr.msg_iov = &iovs[i];
+            hdrs[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    /** @brief Receive all the messages pending on the socket and dispatch
+     *         them in order. A zero length message is dispatched when the
+     *         peer has closed the socket and no further messages are read.
+     *
+     *  @param[in] fd - fd of the MCTP communications socket
+     *  @param[in] dispatch - callable invoked with a std::span<const uint8_t>
+     *                        for every message, the span is valid only for
+     *                        the duration of the call
+     *
+     *  @return number of messages dispatched on success, -errno on failure
+     */
+    template <typename Dispatch>
+    int drain(int fd, Dispatch&& dispatch)
+    {
+        size_t received = 0;
+        while (true)
+        {
+            for (auto& hdr : hdrs)
+            {
+                hdr.msg_hdr.msg_flags = 0;
+                hdr.msg_len = 0;
+            }
+
+            int count = recvmmsg(fd, hdrs.data(), batchSize, MSG_DONTWAIT,
+                                 nullptr);
+            if (count < 0)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    break;
+                }
+                int rc = -errno;
+                record(received);
+                return rc;
+            }
+
+            for (int i = 0; i < count; ++i)
+            {
+                const auto& hdr = hdrs[i];
+                if (hdr.msg_hdr.msg_flags & MSG_TRUNC)
+                {
+                    ++stats.truncated;
+                    error(
+                        "Dropping MCTP message larger than the receive buffer, BUFFER_SIZE={BUFF_SIZE}",
+                        "BUFF_SIZE", bufferSize);
+                    continue;
+                }
+
+                ++received;
+                dispatch(std::span<const uint8_t>(
+                    static_cast<const uint8_t*>(iovs[i].iov_base),
+                    hdr.msg_len));
+                if (!hdr.msg_len)
+                {
+                    // Peer has closed the socket, nothing more to read
+                    record(received);
+                    return static_cast<int>(received);
+                }
+            }
+
+            if (static_cast<size_t>(count) < batchSize)
+            {
+                break;
+            }
+        }
+
+        record(received);
+        return static_cast<int>(received);
+    }
+
+    /** @brief Get the receive statistics
+     *
+     *  @return const reference to the statistics
+     */
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+    /** @brief Log the receive statistics */
+    void logStats() const
+    {
+        info(
+            "MCTP receive stats: WAKES={WAKES} MESSAGES={MSGS} TRUNCATED={TRUNC} MAX_PER_WAKE={MAX}",
+            "WAKES", stats.wakes, "MSGS", stats.messages, "TRUNC",
+            stats.truncated, "MAX", stats.maxPerWake);
+        for (size_t i = 0; i < histogramBuckets; ++i)
+        {
+            info("MCTP messages per wake >= {LOW}: {COUNT}", "LOW",
+                 (uint64_t{1} << i), "COUNT", stats.perWake[i]);
+        }
+    }
+
+  private:
+    size_t batchSize;  //!< number of messages per recvmmsg call
+    size_t bufferSize; //!< size of each receive buffer
+    std::unique_ptr<uint8_t[]> pool; //!< backing storage of receive buffers
+    std::vector<iovec> iovs;         //!< one iovec per receive buffer
+    std::vector<mmsghdr> hdrs;       //!< recvmmsg headers
+    Stats stats;                     //!< receive statistics
+
+    /** @brief Account the messages received in one wake
+     *
+     *  @param[in] received - number of messages received
+     */
+    void record(size_t received)
+    {
+        if (!received)
+        {
+            return;
+        }
+        ++stats.wakes;
+        stats.messages += received;
+        stats.maxPerWake = std::max<uint64_t>(stats.maxPerWake, received);
+        size_t bucket = std::bit_width(received) - 1;
+        ++stats.perWake[std::min(bucket, histogramBuckets - 1)];
+    }
+};
+
+} // namespace pldm
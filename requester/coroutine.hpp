@@ -0,0 +1,427 @@
+#pragma once
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+namespace requester
+{
+
+template <typename T = void>
+class Task;
+
+namespace detail
+{
+
+/** @struct PromiseBase
+ *
+ *  State of a Task coroutine common to all the result types. The coroutine
+ *  is started lazily, by awaiting the Task or by detaching it, and when it
+ *  finishes it resumes the coroutine awaiting it. A detached coroutine frees
+ *  its own frame once it finishes.
+ */
+struct PromiseBase
+{
+    std::coroutine_handle<> continuation; //!< coroutine awaiting the task
+    std::exception_ptr exception;         //!< exception the task exited with
+    bool detached = false;                //!< the task owns its frame
+
+    /** @struct FinalAwaiter
+     *
+     *  Transfers the control to the awaiting coroutine, if any, once the
+     *  coroutine finished.
+     */
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            auto& promise = handle.promise();
+            if (promise.continuation)
+            {
+                return promise.continuation;
+            }
+            if (promise.detached)
+            {
+                promise.logException();
+                handle.destroy();
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception() noexcept
+    {
+        exception = std::current_exception();
+    }
+
+    /** @brief Log the exception a detached task exited with, nobody else
+     *         can observe it
+     */
+    void logException() const noexcept
+    {
+        if (!exception)
+        {
+            return;
+        }
+        try
+        {
+            std::rethrow_exception(exception);
+        }
+        catch (const std::exception& e)
+        {
+            error("Detached PLDM requester task failed. ERROR = {ERR}", "ERR",
+                  e.what());
+        }
+        catch (...)
+        {
+            error("Detached PLDM requester task failed");
+        }
+    }
+};
+
+/** @struct Promise
+ *
+ *  Promise of a Task returning a value.
+ */
+template <typename T>
+struct Promise : PromiseBase
+{
+    std::optional<T> value; //!< value the task returned
+
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& result)
+    {
+        value.emplace(std::forward<U>(result));
+    }
+
+    T result()
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*value);
+    }
+};
+
+/** @struct Promise
+ *
+ *  Promise of a Task returning nothing.
+ */
+template <>
+struct Promise<void> : PromiseBase
+{
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void result() const
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+} // namespace detail
+
+/** @class Task
+ *
+ *  Coroutine of the requester flows, e.g. a multi-step exchange with a PLDM
+ *  terminus written as a sequence of `co_await handler.sendRecvMsg(...)`.
+ *  The coroutine starts when the Task is awaited from another Task, or when
+ *  it is detached from a regular function, and it runs on the thread
+ *  resuming it, i.e. the PLDM daemon's event loop that dispatches the
+ *  responses. The Task must outlive a started coroutine it did not detach.
+ *
+ *  @tparam T - type of the value returned by the coroutine
+ */
+template <typename T>
+class Task
+{
+  public:
+    using promise_type = detail::Promise<T>;
+
+    Task() = delete;
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+            {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+
+    ~Task()
+    {
+        if (handle)
+        {
+            handle.destroy();
+        }
+    }
+
+    /** @brief Check if the coroutine finished
+     *
+     *  @return true if the coroutine returned or threw
+     */
+    bool done() const noexcept
+    {
+        return !handle || handle.done();
+    }
+
+    /** @brief Start the coroutine without awaiting it, the coroutine then
+     *         frees itself once it finished and an exception it exits with
+     *         is logged
+     */
+    void detach()
+    {
+        auto coroutine = std::exchange(handle, {});
+        coroutine.promise().detached = true;
+        coroutine.resume();
+    }
+
+    /** @struct Awaiter
+     *
+     *  Starts the coroutine of the task and resumes the awaiting coroutine
+     *  with the result once it finished.
+     */
+    struct Awaiter
+    {
+        std::coroutine_handle<promise_type> handle; //!< awaited coroutine
+
+        bool await_ready() const noexcept
+        {
+            return !handle || handle.done();
+        }
+
+        std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        T await_resume()
+        {
+            return handle.promise().result();
+        }
+    };
+
+    Awaiter operator co_await() const noexcept
+    {
+        return Awaiter{handle};
+    }
+
+  private:
+    friend promise_type;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept :
+        handle(handle)
+    {}
+
+    std::coroutine_handle<promise_type> handle; //!< coroutine of the task
+};
+
+namespace detail
+{
+
+template <typename T>
+Task<T> Promise<T>::get_return_object() noexcept
+{
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept
+{
+    return Task<void>(
+        std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+/** @brief Result of whenAll, the values of the tasks in their order */
+template <typename T>
+using WhenAllResult =
+    std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+
+/** @struct WhenAllState
+ *
+ *  State shared by the workers of whenAll, it lives in the frame of the
+ *  whenAll coroutine which is suspended until all the workers finished.
+ */
+template <typename T>
+struct WhenAllState
+{
+    using Value = std::conditional_t<std::is_void_v<T>, std::monostate,
+                                     std::optional<T>>;
+
+    explicit WhenAllState(size_t count) : values(count) {}
+
+    std::vector<Value> values;           //!< values of the tasks
+    size_t next = 0;                     //!< next task to start
+    size_t running = 0;                  //!< workers not finished
+    std::coroutine_handle<> waiter;      //!< the whenAll coroutine
+    std::exception_ptr exception;        //!< first exception of the tasks
+
+    /** @brief Awaitable of the workers finishing */
+    struct Done
+    {
+        WhenAllState& state; //!< state of the whenAll
+
+        bool await_ready() const noexcept
+        {
+            return !state.running;
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            state.waiter = awaiting;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    /** @brief Signal a worker finished, resumes the whenAll coroutine after
+     *         the last one
+     */
+    void workerDone()
+    {
+        if (!--running && waiter)
+        {
+            std::exchange(waiter, {}).resume();
+        }
+    }
+};
+
+/** @brief Worker of whenAll, runs the tasks not yet started one after the
+ *         other
+ *
+ *  @param[in] tasks - tasks of the whenAll
+ *  @param[in] state - state of the whenAll
+ */
+template <typename T>
+Task<> whenAllWorker(std::vector<Task<T>>& tasks, WhenAllState<T>& state)
+{
+    while (state.next < tasks.size())
+    {
+        auto index = state.next++;
+        try
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                co_await tasks[index];
+            }
+            else
+            {
+                state.values[index].emplace(co_await tasks[index]);
+            }
+        }
+        catch (...)
+        {
+            if (!state.exception)
+            {
+                state.exception = std::current_exception();
+            }
+        }
+    }
+    state.workerDone();
+}
+
+} // namespace detail
+
+/** @brief Run tasks concurrently, at most maxConcurrent of them at a time,
+ *         and wait for all of them
+ *
+ *  The tasks are started in their order as earlier ones finish, so a flow
+ *  can keep a bounded number of requests outstanding to a terminus. All the
+ *  tasks run to completion even if one of them throws, the first exception
+ *  is then rethrown.
+ *
+ *  @param[in] tasks - tasks to run
+ *  @param[in] maxConcurrent - max number of tasks running at a time, 0 runs
+ *                             all of them at once
+ *  @return values of the tasks in their order, nothing for Task<void>
+ */
+template <typename T>
+Task<detail::WhenAllResult<T>> whenAll(std::vector<Task<T>> tasks,
+                                       size_t maxConcurrent)
+{
+    detail::WhenAllState<T> state(tasks.size());
+    auto workers = maxConcurrent ? std::min(maxConcurrent, tasks.size())
+                                 : tasks.size();
+    state.running = workers;
+    for (size_t i = 0; i < workers; ++i)
+    {
+        detail::whenAllWorker(tasks, state).detach();
+    }
+    co_await typename detail::WhenAllState<T>::Done{state};
+
+    if (state.exception)
+    {
+        std::rethrow_exception(state.exception);
+    }
+    if constexpr (!std::is_void_v<T>)
+    {
+        std::vector<T> values;
+        values.reserve(state.values.size());
+        for (auto& value : state.values)
+        {
+            values.emplace_back(std::move(*value));
+        }
+        co_return values;
+    }
+}
+
+/** @brief Run tasks concurrently and wait for all of them
+ *
+ *  @param[in] tasks - tasks to run
+ *  @return values of the tasks in their order, nothing for Task<void>
+ */
+template <typename T>
+Task<detail::WhenAllResult<T>> whenAll(std::vector<Task<T>> tasks)
+{
+    return whenAll(std::move(tasks), 0);
+}
+
+} // namespace requester
+} // namespace pldm
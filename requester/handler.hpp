@@ -1,8 +1,14 @@
 #pragma once
 
+#include "common/command_stats.hpp"
+#include "common/idempotent.hpp"
+#include "common/tx_queue.hpp"
 #include "common/types.hpp"
+#include "coroutine.hpp"
 #include "pldmd/dbus_impl_requester.hpp"
 #include "request.hpp"
+#include "rtt_estimator.hpp"
+#include "timer_wheel.hpp"
 
 #include <libpldm/base.h>
 #include <libpldm/pldm.h>
@@ -10,15 +16,20 @@
 
 #include <function2/function2.hpp>
 #include <phosphor-logging/lg2.hpp>
-#include <sdbusplus/timer.hpp>
 #include <sdeventplus/event.hpp>
-#include <sdeventplus/source/event.hpp>
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <chrono>
-#include <memory>
+#include <coroutine>
+#include <deque>
+#include <optional>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 PHOSPHOR_LOG2_USING;
 
@@ -26,51 +37,63 @@ namespace pldm
 {
 namespace requester
 {
-/** @struct RequestKey
- *
- *  RequestKey uniquely identifies the PLDM request message to match it with the
- *  response and a combination of MCTP endpoint ID, PLDM instance ID, PLDM type
- *  and PLDM command is the key.
+using ResponseHandler = fu2::unique_function<void(
+    mctp_eid_t eid, const pldm_msg* response, size_t respMsgLen)>;
+
+/** @brief Priority of a scheduled PLDM request, the requests queued for an
+ *         endpoint are sent in priority order, and in order within a
+ *         priority
  */
-struct RequestKey
+enum class RequestPriority : uint8_t
 {
-    mctp_eid_t eid;     //!< MCTP endpoint ID
-    uint8_t instanceId; //!< PLDM instance ID
-    uint8_t type;       //!< PLDM type
-    uint8_t command;    //!< PLDM command
-
-    bool operator==(const RequestKey& e) const
-    {
-        return ((eid == e.eid) && (instanceId == e.instanceId) &&
-                (type == e.type) && (command == e.command));
-    }
+    High,
+    Normal,
+    Low,
 };
 
-/** @struct RequestKeyHasher
+/** @struct WindowStats
  *
- *  This is a simple hash function, since the instance ID generator API
- *  generates unique instance IDs for MCTP endpoint ID.
+ *  Statistics of the request window of an MCTP endpoint.
  */
-struct RequestKeyHasher
+struct WindowStats
 {
-    std::size_t operator()(const RequestKey& key) const
-    {
-        return (key.eid << 24 | key.instanceId << 16 | key.type << 8 |
-                key.command);
-    }
+    uint64_t queued = 0;     //!< requests that waited for the window
+    uint64_t dispatched = 0; //!< queued requests sent since
+    uint64_t coalesced = 0;  //!< requests attached to an identical one
+    size_t inFlight = 0;     //!< requests outstanding now
+    size_t depth = 0;        //!< requests queued now
+    size_t maxDepth = 0;     //!< max requests queued at a time
 };
 
-using ResponseHandler = fu2::unique_function<void(
-    mctp_eid_t eid, const pldm_msg* response, size_t respMsgLen)>;
+/** @brief Result of Handler::sendRecvMsg, the return code, the PLDM response
+ *         message and its length
+ */
+using SendRecvMsgResult = std::tuple<int, const pldm_msg*, size_t>;
 
 /** @class Handler
  *
  *  This class handles the lifecycle of the PLDM request message based on the
  *  instance ID expiration interval, number of request retries and the timeout
- *  waiting for a response. The registered response handlers are invoked with
- *  response once the PLDM responder sends the response. If no response is
- *  received within the instance ID expiration interval or any other failure the
- *  response handler is invoked with the empty response.
+ *  waiting for a response. The timeout adapts to the round-trip time measured
+ *  for each endpoint and PLDM type. The registered response handlers are
+ *  invoked with response once the PLDM responder sends the response. If no
+ *  response is received within the instance ID expiration interval or any
+ *  other failure the response handler is invoked with the empty response.
+ *
+ *  The requests registered with scheduleRequest are sent through a window
+ *  per endpoint: at most windowSize requests are outstanding to an endpoint,
+ *  the next ones are queued by priority and sent as the responses free up
+ *  instance IDs, instead of exhausting the instance IDs of the endpoint.
+ *
+ *  The records of the outstanding requests are preallocated per endpoint,
+ *  one per instance ID, and looked up by instance ID, and the buffers of the
+ *  request messages are recycled through allocRequest, so that the requests
+ *  do not allocate once an endpoint has been talked to.
+ *
+ *  With coalescing enabled, a request for an idempotent command identical to
+ *  one outstanding to the same endpoint, but for the instance ID, is not
+ *  sent: its response handler is attached to the outstanding request and
+ *  invoked with the same response.
  *
  * @tparam RequestInterface - Request class type
  */
@@ -88,28 +111,54 @@ class Handler
     /** @brief Constructor
      *
      *  @param[in] fd - fd of MCTP communications socket
+     *  @param[in] txQueue - transmit queue of the socket, requests are sent
+     *                       directly on the socket if null
      *  @param[in] event - reference to PLDM daemon's main event loop
      *  @param[in] requester - reference to Requester object
      *  @param[in] currentSendbuffSize - current send buffer size
-     *  @param[in] verbose - verbose tracing flag
      *  @param[in] instanceIdExpiryInterval - instance ID expiration interval
      *  @param[in] numRetries - number of request retries
-     *  @param[in] responseTimeOut - time to wait between each retry
+     *  @param[in] responseTimeOut - time to wait between each retry, until
+     *                               a round-trip time is measured
+     *  @param[in] windowSize - max number of scheduled requests outstanding
+     *                          to an endpoint
+     *  @param[in] minResponseTimeOut - lower bound of the time to wait
+     *                                  between each retry
+     *  @param[in] maxResponseTimeOut - upper bound of the time to wait
+     *                                  between each retry, further capped so
+     *                                  that all the retries fit in the
+     *                                  instance ID expiration interval
+     *  @param[in] coalescing - attach the requests for idempotent commands
+     *                          to an identical outstanding request
      */
     explicit Handler(
-        int fd, sdeventplus::Event& event, pldm::dbus_api::Requester& requester,
-        int currentSendbuffSize, bool verbose,
+        int fd, pldm::TxQueue* txQueue, sdeventplus::Event& event,
+        pldm::dbus_api::Requester& requester, int currentSendbuffSize,
         std::chrono::seconds instanceIdExpiryInterval =
             std::chrono::seconds(INSTANCE_ID_EXPIRATION_INTERVAL),
         uint8_t numRetries = static_cast<uint8_t>(NUMBER_OF_REQUEST_RETRIES),
         std::chrono::milliseconds responseTimeOut =
-            std::chrono::milliseconds(RESPONSE_TIME_OUT)) :
+            std::chrono::milliseconds(RESPONSE_TIME_OUT),
+        size_t windowSize = REQUEST_WINDOW_SIZE,
+        std::chrono::milliseconds minResponseTimeOut =
+            std::chrono::milliseconds(RESPONSE_TIME_OUT_MIN),
+        std::chrono::milliseconds maxResponseTimeOut =
+            std::chrono::milliseconds(RESPONSE_TIME_OUT_MAX),
+        bool coalescing = REQUESTER_COALESCING) :
         fd(fd),
-        event(event), requester(requester),
-        currentSendbuffSize(currentSendbuffSize), verbose(verbose),
+        txQueue(txQueue), event(event), requester(requester),
+        currentSendbuffSize(currentSendbuffSize),
         instanceIdExpiryInterval(instanceIdExpiryInterval),
-        numRetries(numRetries), responseTimeOut(responseTimeOut)
-    {}
+        numRetries(numRetries), windowSize(std::max<size_t>(windowSize, 1)),
+        coalescing(coalescing),
+        rttEstimator(responseTimeOut,
+                     std::min(minResponseTimeOut,
+                              retryTimeOutCap(maxResponseTimeOut)),
+                     retryTimeOutCap(maxResponseTimeOut)),
+        timerWheel(event)
+    {
+        spareBuffers.reserve(maxSpareBuffers);
+    }
 
     /** @brief Register a PLDM request message
      *
@@ -120,83 +169,275 @@ class Handler
      *  @param[in] requestMsg - PLDM request message
      *  @param[in] responseHandler - Response handler for this request
      *
-     *  @return return PLDM_SUCCESS on success and PLDM_ERROR otherwise
+     *  @return return PLDM_SUCCESS on success, PLDM_ERROR_NOT_READY if the
+     *          MCTP transmit queue is congested and PLDM_ERROR otherwise. On
+     *          a failure the instance ID is freed and the response handler
+     *          is left to the caller, as is the request message if the
+     *          transmit queue is congested. The instance ID is freed as well
+     *          if the request is coalesced with an outstanding one.
      */
     int registerRequest(mctp_eid_t eid, uint8_t instanceId, uint8_t type,
                         uint8_t command, pldm::Request&& requestMsg,
                         ResponseHandler&& responseHandler)
     {
-        RequestKey key{eid, instanceId, type, command};
+        auto& window = getWindow(eid);
+        if (attachToIdentical(window, type, command, requestMsg,
+                              responseHandler))
+        {
+            requester.markFree(eid, instanceId);
+            return PLDM_SUCCESS;
+        }
 
-        auto instanceIdExpiryCallBack = [key, this](void) {
-            if (this->handlers.contains(key))
-            {
-                error(
-                    "Response not received for the request, instance ID expired. EID = {EID} INSTANCE_ID = {INST_ID} TYPE = {KEY_TYP} COMMAND = {CMD}",
-                    "EID", (unsigned)key.eid, "INST_ID",
-                    (unsigned)key.instanceId, "KEY_TYP", (unsigned)key.type,
-                    "CMD", (unsigned)key.command);
-                auto& [request, responseHandler,
-                       timerInstance] = this->handlers[key];
-                request->stop();
-                auto rc = timerInstance->stop();
-                if (rc)
-                {
-                    error(
-                        "Failed to stop the instance ID expiry timer. RC = {RC}",
-                        "RC", rc);
-                }
-                // Call response handler with an empty response to indicate no
-                // response
-                responseHandler(key.eid, nullptr, 0);
-                this->removeRequestContainer.emplace(
-                    key, std::make_unique<sdeventplus::source::Defer>(
-                             event, std::bind(&Handler::removeRequestEntry,
-                                              this, key)));
-            }
-            else
-            {
-                // This condition is not possible, if a response is received
-                // before the instance ID expiry, then the response handler
-                // is executed and the entry will be removed.
-                assert(false);
-            }
-        };
+        // Hold off new requests while the socket can't keep up, so that the
+        // transmit queue stays bounded
+        if (txQueue && txQueue->congested())
+        {
+            requester.markFree(eid, instanceId);
+            error(
+                "MCTP transmit queue is congested, PLDM request not sent. EID = {EID} TYPE = {TYPE} COMMAND = {CMD} QUEUE_DEPTH = {DEPTH}",
+                "EID", (unsigned)eid, "TYPE", (unsigned)type, "CMD",
+                (unsigned)command, "DEPTH", txQueue->depth());
+            return PLDM_ERROR_NOT_READY;
+        }
 
-        auto request = std::make_unique<RequestInterface>(
-            fd, eid, event, std::move(requestMsg), numRetries, responseTimeOut,
-            currentSendbuffSize, verbose);
-        auto timer = std::make_unique<phosphor::Timer>(
-            event.get(), instanceIdExpiryCallBack);
+        if (instanceId >= maxInstanceIds || window.slots[instanceId].request)
+        {
+            error(
+                "PLDM request already registered. EID = {EID} INSTANCE_ID = {INST_ID} TYPE = {TYPE} COMMAND = {CMD}",
+                "EID", (unsigned)eid, "INST_ID", (unsigned)instanceId, "TYPE",
+                (unsigned)type, "CMD", (unsigned)command);
+            return PLDM_ERROR;
+        }
 
-        auto rc = request->start();
+        auto& slot = window.slots[instanceId];
+        slot.requestMsg = std::move(requestMsg);
+        slot.type = type;
+        slot.command = command;
+        slot.responseHandler = std::move(responseHandler);
+        slot.sentAt = std::chrono::steady_clock::now();
+        slot.request.emplace(fd, txQueue, eid, timerWheel, slot.requestMsg,
+                             numRetries, rttEstimator.timeout(eid, type),
+                             currentSendbuffSize);
+        auto rc = slot.request->start();
         if (rc)
         {
             requester.markFree(eid, instanceId);
+            responseHandler = std::move(slot.responseHandler);
+            freeSlot(slot);
             error("Failure to send the PLDM request message");
             return rc;
         }
 
         try
         {
-            timer->start(duration_cast<std::chrono::microseconds>(
-                instanceIdExpiryInterval));
+            timerWheel.arm(slot.expiry, instanceIdExpiryInterval);
         }
         catch (const std::runtime_error& e)
         {
+            slot.request->stop();
             requester.markFree(eid, instanceId);
+            responseHandler = std::move(slot.responseHandler);
+            freeSlot(slot);
             error(
                 "Failed to start the instance ID expiry timer. RC = {ERR_EXCEP}",
                 "ERR_EXCEP", e.what());
             return PLDM_ERROR;
         }
 
-        handlers.emplace(key, std::make_tuple(std::move(request),
-                                              std::move(responseHandler),
-                                              std::move(timer)));
+        if (isCoalescible(type, command, slot.requestMsg))
+        {
+            window.coalescible |= uint32_t{1} << instanceId;
+        }
+        ++window.stats.inFlight;
         return rc;
     }
 
+    /** @brief Schedule a PLDM request message through the request window of
+     *         the endpoint
+     *
+     *  The request is attached to an identical outstanding one if it can be
+     *  coalesced, else it is sent right away if the window of the endpoint
+     *  has room and an instance ID is free, else it is queued. The instance ID
+     *  of the request header is allocated when the request is sent, the
+     *  PLDM type and command are taken from the header. A queued request
+     *  that fails to be sent later has its response handler invoked with
+     *  an empty response.
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] requestMsg - PLDM request message, header and payload
+     *  @param[in] responseHandler - Response handler for this request
+     *  @param[in] priority - priority of the request in the queue
+     *
+     *  @return PLDM_SUCCESS if the request is sent, coalesced or queued, on
+     *          a failure to send it right away the return code of
+     *          registerRequest
+     */
+    int scheduleRequest(mctp_eid_t eid, pldm::Request&& requestMsg,
+                        ResponseHandler&& responseHandler,
+                        RequestPriority priority = RequestPriority::Normal)
+    {
+        if (requestMsg.size() < sizeof(pldm_msg_hdr))
+        {
+            error("Invalid PLDM request message length. EID = {EID}", "EID",
+                  (unsigned)eid);
+            return PLDM_ERROR_INVALID_LENGTH;
+        }
+
+        auto& window = getWindow(eid);
+        auto hdr = reinterpret_cast<const pldm_msg_hdr*>(requestMsg.data());
+        if (attachToIdentical(window, hdr->type, hdr->command, requestMsg,
+                              responseHandler))
+        {
+            return PLDM_SUCCESS;
+        }
+
+        if (!window.stats.depth && window.stats.inFlight < windowSize)
+        {
+            if (auto instanceId = nextInstanceId(eid, window))
+            {
+                auto rc = sendScheduled(eid, *instanceId, requestMsg,
+                                        responseHandler);
+                if (rc != PLDM_ERROR_NOT_READY)
+                {
+                    return rc;
+                }
+            }
+        }
+
+        window.queues[static_cast<size_t>(priority)].push_back(
+            {std::move(requestMsg), std::move(responseHandler)});
+        ++window.stats.queued;
+        window.stats.maxDepth = std::max(++window.stats.depth,
+                                         window.stats.maxDepth);
+        if (window.stats.inFlight == 0)
+        {
+            // Nothing outstanding frees an instance ID or the transmit
+            // queue for the queued request, so try again later
+            armDispatch(window, dispatchRetryInterval);
+        }
+        return PLDM_SUCCESS;
+    }
+
+    /** @brief Get the statistics of the request window of an endpoint
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *
+     *  @return copy of the statistics
+     */
+    WindowStats getWindowStats(mctp_eid_t eid) const
+    {
+        auto it = windows.find(eid);
+        return it == windows.end() ? WindowStats{} : it->second.stats;
+    }
+
+    /** @brief Get the live round-trip time estimates
+     *
+     *  @return round-trip time estimator of the requests
+     */
+    const RttEstimator& getRttEstimator() const
+    {
+        return rttEstimator;
+    }
+
+    /** @brief Log the statistics of the request windows and the round-trip
+     *         time estimates
+     */
+    void logStats() const
+    {
+        rttEstimator.logStats();
+        for (const auto& [eid, window] : windows)
+        {
+            info(
+                "PLDM request window. EID = {EID} IN_FLIGHT = {IN_FLIGHT} DEPTH = {DEPTH} MAX_DEPTH = {MAX_DEPTH} QUEUED = {QUEUED} DISPATCHED = {DISPATCHED} COALESCED = {COALESCED}",
+                "EID", (unsigned)eid, "IN_FLIGHT", window.stats.inFlight,
+                "DEPTH", window.stats.depth, "MAX_DEPTH",
+                window.stats.maxDepth, "QUEUED", window.stats.queued,
+                "DISPATCHED", window.stats.dispatched, "COALESCED",
+                window.stats.coalesced);
+        }
+    }
+
+    /** @class SendRecvMsgAwaiter
+     *
+     *  Awaitable of sendRecvMsg. Awaiting it schedules the request and
+     *  suspends the coroutine until the response is received or the
+     *  instance ID expires. The coroutine
+     *  is resumed from the response handler, so the response message is
+     *  valid only until the coroutine suspends again.
+     */
+    class SendRecvMsgAwaiter
+    {
+      public:
+        SendRecvMsgAwaiter(Handler& handler, mctp_eid_t eid,
+                           pldm::Request&& request,
+                           RequestPriority priority) :
+            handler(handler),
+            eid(eid), request(std::move(request)), priority(priority)
+        {}
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> awaiting)
+        {
+            rc = handler.scheduleRequest(
+                eid, std::move(request),
+                [this, awaiting](mctp_eid_t /*eid*/, const pldm_msg* response,
+                                 size_t respMsgLen) {
+                    this->response = response;
+                    this->respMsgLen = respMsgLen;
+                    if (!response)
+                    {
+                        rc = PLDM_ERROR;
+                    }
+                    awaiting.resume();
+                },
+                priority);
+            return rc == PLDM_SUCCESS;
+        }
+
+        SendRecvMsgResult await_resume() const noexcept
+        {
+            return {rc, response, respMsgLen};
+        }
+
+      private:
+        Handler& handler;                   //!< handler of the request
+        mctp_eid_t eid;                     //!< endpoint ID of the terminus
+        pldm::Request request;              //!< PLDM request message
+        RequestPriority priority;           //!< priority of the request
+        int rc = PLDM_SUCCESS;              //!< return code of the exchange
+        const pldm_msg* response = nullptr; //!< PLDM response message
+        size_t respMsgLen = 0;              //!< length of the response message
+    };
+
+    /** @brief Send a PLDM request message and await the response, from a
+     *         Task coroutine
+     *
+     *  The request is scheduled with scheduleRequest when the result is
+     *  awaited.
+     *  E.g.
+     *  @code
+     *  auto [rc, response, respMsgLen] =
+     *      co_await handler.sendRecvMsg(eid, std::move(request));
+     *  @endcode
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] request - PLDM request message, header and payload
+     *  @param[in] priority - priority of the request in the queue
+     *
+     *  @return awaitable of the return code, PLDM_SUCCESS if a response is
+     *          received, the response message and its length
+     */
+    SendRecvMsgAwaiter
+        sendRecvMsg(mctp_eid_t eid, pldm::Request&& request,
+                    RequestPriority priority = RequestPriority::Normal)
+    {
+        return SendRecvMsgAwaiter(*this, eid, std::move(request), priority);
+    }
+
     /** @brief Handle PLDM response message
      *
      *  @param[in] eid - endpoint ID of the remote MCTP endpoint
@@ -210,20 +451,30 @@ class Handler
                         uint8_t command, const pldm_msg* response,
                         size_t respMsgLen)
     {
-        RequestKey key{eid, instanceId, type, command};
-        if (handlers.contains(key))
+        auto it = windows.find(eid);
+        if (it != windows.end() && instanceId < maxInstanceIds &&
+            it->second.slots[instanceId].request &&
+            it->second.slots[instanceId].type == type &&
+            it->second.slots[instanceId].command == command)
         {
-            auto& [request, responseHandler, timerInstance] = handlers[key];
-            request->stop();
-            auto rc = timerInstance->stop();
-            if (rc)
+            auto& slot = it->second.slots[instanceId];
+            slot.request->stop();
+            timerWheel.cancel(slot.expiry);
+            uint8_t completionCode = (response && respMsgLen)
+                                         ? response->payload[0]
+                                         : static_cast<uint8_t>(PLDM_ERROR);
+            auto rtt = std::chrono::steady_clock::now() - slot.sentAt;
+            stats::CommandStats::getRequesterStats().record(
+                type, command, eid, completionCode, rtt);
+            // The response to a retried request can't be matched to one of
+            // the transmissions, so it is not sampled and the timeout is kept
+            // as is until a request gets through without a retry (Karn's
+            // algorithm)
+            if (!slot.request->retried())
             {
-                error("Failed to stop the instance ID expiry timer. RC = {RC}",
-                      "RC", rc);
+                rttEstimator.sample(eid, type, rtt);
             }
-            responseHandler(eid, response, respMsgLen);
-            requester.markFree(key.eid, key.instanceId);
-            handlers.erase(key);
+            complete(it->second, eid, instanceId, response, respMsgLen);
         }
         else
         {
@@ -231,53 +482,435 @@ class Handler
             // request handler, so freeing up the instance ID, this can be other
             // OpenBMC applications relying on PLDM D-Bus apis like
             // openpower-occ-control and softoff
-            requester.markFree(key.eid, key.instanceId);
+            requester.markFree(eid, instanceId);
+            if (it != windows.end())
+            {
+                dispatch(eid);
+            }
+        }
+    }
+
+    /** @brief Get a buffer for a PLDM request message, recycled from the
+     *         completed requests when possible
+     *
+     *  @param[in] size - size of the message, header and payload
+     *
+     *  @return zero filled request message
+     */
+    pldm::Request allocRequest(size_t size)
+    {
+        if (spareBuffers.empty())
+        {
+            return pldm::Request(size);
         }
+        auto requestMsg = std::move(spareBuffers.back());
+        spareBuffers.pop_back();
+        requestMsg.assign(size, 0);
+        return requestMsg;
     }
 
   private:
     int fd; //!< file descriptor of MCTP communications socket
+    pldm::TxQueue* txQueue; //!< transmit queue of the socket
     sdeventplus::Event& event; //!< reference to PLDM daemon's main event loop
     pldm::dbus_api::Requester& requester; //!< reference to Requester object
     int currentSendbuffSize;              //!< current Send Buffer size
-    bool verbose;                         //!< verbose tracing flag
     std::chrono::seconds
         instanceIdExpiryInterval;         //!< Instance ID expiration interval
     uint8_t numRetries;                   //!< number of request retries
+    size_t windowSize; //!< max scheduled requests outstanding to an endpoint
+    bool coalescing;   //!< coalesce the identical idempotent requests
+    RttEstimator rttEstimator; //!< round-trip times and retry timeouts
+
+    /** @brief Timer wheel driving the retry and instance ID expiry
+     *         deadlines of all the requests, it outlives the requests
+     */
+    TimerWheel timerWheel;
+
+    /** @brief Number of request message buffers kept for reuse */
+    static constexpr size_t maxSpareBuffers = maxInstanceIds;
+
+    /** @brief Max capacity of a request message buffer kept for reuse */
+    static constexpr size_t maxSpareBufferSize = 256;
+
+    /** @struct RequestSlot
+     *
+     *  Record of a PLDM request message, handler for the corresponding PLDM
+     *  response, the deadline of the Instance ID expiration, the time the
+     *  request was sent and the handlers of the requests coalesced with it.
+     *  The records are preallocated per endpoint and instance ID and reused
+     *  by the next requests.
+     */
+    struct RequestSlot
+    {
+        explicit RequestSlot(TimerWheel::Callback&& expiryCallback) :
+            expiry(std::move(expiryCallback))
+        {}
+
+        pldm::Request requestMsg; //!< PLDM request message
+        std::optional<RequestInterface> request; //!< request and retries, set
+                                                 //!< while outstanding
+        ResponseHandler responseHandler;         //!< response handler
+        std::vector<ResponseHandler> waiters; //!< coalesced requests handlers
+        TimerWheel::Entry expiry; //!< instance ID expiration deadline
+        std::chrono::steady_clock::time_point sentAt; //!< time of the request
+        uint8_t type = 0;    //!< PLDM type
+        uint8_t command = 0; //!< PLDM command
+    };
+
+    /** @brief Time to wait before sending the queued requests again when
+     *         nothing outstanding to the endpoint would trigger it
+     */
+    static constexpr auto dispatchRetryInterval =
+        std::chrono::milliseconds(100);
+
+    /** @struct QueuedRequest
+     *
+     *  PLDM request message waiting for the request window of its endpoint
+     */
+    struct QueuedRequest
+    {
+        pldm::Request requestMsg;        //!< PLDM request message
+        ResponseHandler responseHandler; //!< response handler
+    };
+
+    /** @struct Window
+     *
+     *  Request window of an MCTP endpoint, the records of its outstanding
+     *  requests indexed by instance ID, the queues of the requests per
+     *  priority and the deadline to retry sending them
+     */
+    struct Window
+    {
+        Window(Handler& handler, mctp_eid_t eid) :
+            Window(handler, eid, std::make_index_sequence<maxInstanceIds>())
+        {}
+
+        template <size_t... instanceIds>
+        Window(Handler& handler, mctp_eid_t eid,
+               std::index_sequence<instanceIds...>) :
+            retry([&handler, eid]() { handler.dispatch(eid); }),
+            slots{RequestSlot([&handler, eid]() {
+                handler.instanceIdExpired(eid, instanceIds);
+            })...}
+        {}
+
+        std::array<std::deque<QueuedRequest>, 3> queues; //!< per priority
+        TimerWheel::Entry retry; //!< deadline to retry dispatching
+        WindowStats stats;       //!< window statistics
+        std::array<RequestSlot, maxInstanceIds> slots; //!< per instance ID
+        uint32_t coalescible = 0; //!< mask of the slots that can be coalesced
+    };
+
+    /** @brief Request windows per endpoint, the nodes are stable so the
+     *         requests can refer to their slot
+     */
+    std::unordered_map<mctp_eid_t, Window> windows;
+
+    /** @brief Request message buffers of the completed requests */
+    std::vector<pldm::Request> spareBuffers;
+
+    /** @brief Instance ID expiration callback, the response handlers are
+     *         invoked with an empty response
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] instanceId - instance ID of the request
+     */
+    void instanceIdExpired(mctp_eid_t eid, uint8_t instanceId)
+    {
+        auto& window = getWindow(eid);
+        auto& slot = window.slots[instanceId];
+        if (!slot.request)
+        {
+            // This condition is not possible, if a response is received
+            // before the instance ID expiry, then the response handler
+            // is executed and the deadline is cancelled.
+            assert(false);
+            return;
+        }
+
+        error(
+            "Response not received for the request, instance ID expired. EID = {EID} INSTANCE_ID = {INST_ID} TYPE = {KEY_TYP} COMMAND = {CMD}",
+            "EID", (unsigned)eid, "INST_ID", (unsigned)instanceId, "KEY_TYP",
+            (unsigned)slot.type, "CMD", (unsigned)slot.command);
+        stats::CommandStats::getRequesterStats().recordTimeout(
+            slot.type, slot.command, eid,
+            std::chrono::steady_clock::now() - slot.sentAt);
+        slot.request->stop();
+        rttEstimator.backoff(eid, slot.type);
+        // Call the response handlers with an empty response to indicate no
+        // response
+        complete(window, eid, instanceId, nullptr, 0);
+    }
+
+    /** @brief Cap the time to wait between each retry, so that the request
+     *         is sent numRetries + 1 times and each transmission is waited
+     *         for before the instance ID expires
+     *
+     *  @param[in] timeout - time to wait between each retry
+     *
+     *  @return capped timeout
+     */
     std::chrono::milliseconds
-        responseTimeOut;                  //!< time to wait between each retry
+        retryTimeOutCap(std::chrono::milliseconds timeout) const
+    {
+        return std::min(
+            timeout, std::chrono::duration_cast<std::chrono::milliseconds>(
+                         instanceIdExpiryInterval) /
+                         (numRetries + 1));
+    }
+
+    /** @brief Invoke the response handlers of a request and free its
+     *         instance ID and slot
+     *
+     *  @param[in] window - request window of the endpoint
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] instanceId - instance ID of the request
+     *  @param[in] response - PLDM response message, nullptr if none
+     *  @param[in] respMsgLen - length of the response message
+     */
+    void complete(Window& window, mctp_eid_t eid, uint8_t instanceId,
+                  const pldm_msg* response, size_t respMsgLen)
+    {
+        auto& slot = window.slots[instanceId];
+        // The handlers may register the same request again, it is sent as a
+        // new one
+        window.coalescible &= ~(uint32_t{1} << instanceId);
+        slot.responseHandler(eid, response, respMsgLen);
+        for (auto& waiter : slot.waiters)
+        {
+            waiter(eid, response, respMsgLen);
+        }
+        requester.markFree(eid, instanceId);
+        freeSlot(slot);
+        release(eid);
+    }
+
+    /** @brief Reset the slot of a completed request, its request message
+     *         buffer is kept for allocRequest
+     *
+     *  @param[in] slot - slot of the request
+     */
+    void freeSlot(RequestSlot& slot)
+    {
+        slot.request.reset();
+        slot.responseHandler = nullptr;
+        slot.waiters.clear();
+        if (spareBuffers.size() < maxSpareBuffers &&
+            slot.requestMsg.capacity() <= maxSpareBufferSize)
+        {
+            spareBuffers.push_back(std::move(slot.requestMsg));
+        }
+        slot.requestMsg = pldm::Request{};
+    }
+
+    /** @brief Check if a request can be coalesced with the identical ones
+     *
+     *  @param[in] type - PLDM type
+     *  @param[in] command - PLDM command
+     *  @param[in] requestMsg - PLDM request message
+     *
+     *  @return true if coalescing is enabled and the command is idempotent
+     */
+    bool isCoalescible(uint8_t type, uint8_t command,
+                       const pldm::Request& requestMsg) const
+    {
+        return coalescing && requestMsg.size() >= sizeof(pldm_msg_hdr) &&
+               isIdempotent(type, command);
+    }
+
+    /** @brief Attach the response handler of a request to an identical
+     *         outstanding request, the same message but for the instance ID
+     *
+     *  @param[in] window - request window of the endpoint
+     *  @param[in] type - PLDM type
+     *  @param[in] command - PLDM command
+     *  @param[in] requestMsg - PLDM request message
+     *  @param[in] responseHandler - Response handler for this request, it is
+     *                               moved from if the request is coalesced
+     *
+     *  @return true if the request is coalesced
+     */
+    bool attachToIdentical(Window& window, uint8_t type, uint8_t command,
+                           const pldm::Request& requestMsg,
+                           ResponseHandler& responseHandler)
+    {
+        if (!isCoalescible(type, command, requestMsg))
+        {
+            return false;
+        }
+        for (auto pending = window.coalescible; pending;
+             pending &= pending - 1)
+        {
+            auto& slot = window.slots[std::countr_zero(pending)];
+            // The first header byte holds the instance ID
+            if (slot.type == type && slot.command == command &&
+                slot.requestMsg.size() == requestMsg.size() &&
+                std::equal(requestMsg.begin() + 1, requestMsg.end(),
+                           slot.requestMsg.begin() + 1))
+            {
+                slot.waiters.push_back(std::move(responseHandler));
+                ++window.stats.coalesced;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** @brief Get the request window of an endpoint, creating it if needed
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *
+     *  @return request window
+     */
+    Window& getWindow(mctp_eid_t eid)
+    {
+        auto [it, inserted] = windows.try_emplace(eid, *this, eid);
+        return it->second;
+    }
+
+    /** @brief Get an instance ID for a scheduled request
+     *
+     *  An instance ID in use is only reclaimed, as per getInstanceId, if
+     *  none of the requests of the window is outstanding, else the queued
+     *  requests wait for a response to free one.
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] window - request window of the endpoint
+     *
+     *  @return instance ID, nullopt if none is available
+     */
+    std::optional<uint8_t> nextInstanceId(mctp_eid_t eid, const Window& window)
+    {
+        if (auto instanceId = requester.tryGetInstanceId(eid))
+        {
+            return instanceId;
+        }
+        if (window.stats.inFlight)
+        {
+            return std::nullopt;
+        }
+        try
+        {
+            return requester.getInstanceId(eid);
+        }
+        catch (const std::exception& e)
+        {
+            error(
+                "No instance ID available for the PLDM request. EID = {EID} ERROR = {ERR_EXCEP}",
+                "EID", (unsigned)eid, "ERR_EXCEP", e.what());
+            return std::nullopt;
+        }
+    }
 
-    /** @brief Container for storing the details of the PLDM request
-     *         message, handler for the corresponding PLDM response and the
-     *         timer object for the Instance ID expiration
+    /** @brief Send a scheduled request with an instance ID
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] instanceId - instance ID allocated for the request
+     *  @param[in] requestMsg - PLDM request message
+     *  @param[in] responseHandler - Response handler for this request
+     *
+     *  @return return code of registerRequest, both the message and the
+     *          response handler are left untouched on PLDM_ERROR_NOT_READY
      */
-    using RequestValue =
-        std::tuple<std::unique_ptr<RequestInterface>, ResponseHandler,
-                   std::unique_ptr<phosphor::Timer>>;
+    int sendScheduled(mctp_eid_t eid, uint8_t instanceId,
+                      pldm::Request& requestMsg,
+                      ResponseHandler& responseHandler)
+    {
+        auto hdr = reinterpret_cast<pldm_msg_hdr*>(requestMsg.data());
+        hdr->instance_id = instanceId;
+        uint8_t type = hdr->type;
+        uint8_t command = hdr->command;
+        return registerRequest(eid, instanceId, type, command,
+                               std::move(requestMsg),
+                               std::move(responseHandler));
+    }
 
-    /** @brief Container for storing the PLDM request entries */
-    std::unordered_map<RequestKey, RequestValue, RequestKeyHasher> handlers;
+    /** @brief Arm the deadline to retry dispatching the queued requests
+     *
+     *  @param[in] window - request window of the endpoint
+     *  @param[in] interval - time to wait
+     */
+    void armDispatch(Window& window, std::chrono::milliseconds interval)
+    {
+        if (window.retry.isArmed())
+        {
+            return;
+        }
+        try
+        {
+            timerWheel.arm(window.retry, interval);
+        }
+        catch (const std::runtime_error& e)
+        {
+            error("Failed to arm the request dispatch timer. RC = {ERR_EXCEP}",
+                  "ERR_EXCEP", e.what());
+        }
+    }
 
-    /** @brief Container to store information about the request entries to be
-     *         removed after the instance ID timer expires
+    /** @brief Send the queued requests of an endpoint as long as its window
+     *         has room and instance IDs are free
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
      */
-    std::unordered_map<RequestKey, std::unique_ptr<sdeventplus::source::Defer>,
-                       RequestKeyHasher>
-        removeRequestContainer;
+    void dispatch(mctp_eid_t eid)
+    {
+        auto& window = getWindow(eid);
+        while (window.stats.depth && window.stats.inFlight < windowSize)
+        {
+            auto instanceId = nextInstanceId(eid, window);
+            if (!instanceId)
+            {
+                if (!window.stats.inFlight)
+                {
+                    armDispatch(window, instanceIdExpiryInterval);
+                }
+                return;
+            }
+
+            auto& queue = *std::find_if(
+                window.queues.begin(), window.queues.end(),
+                [](const auto& queue) { return !queue.empty(); });
+            auto rc = sendScheduled(eid, *instanceId, queue.front().requestMsg,
+                                    queue.front().responseHandler);
+            if (rc == PLDM_ERROR_NOT_READY)
+            {
+                // Keep the request at the head of its queue until the
+                // transmit queue drains
+                if (!window.stats.inFlight)
+                {
+                    armDispatch(window, dispatchRetryInterval);
+                }
+                return;
+            }
 
-    /** @brief Remove request entry for which the instance ID expired
+            auto queued = std::move(queue.front());
+            queue.pop_front();
+            --window.stats.depth;
+            ++window.stats.dispatched;
+            if (rc)
+            {
+                error(
+                    "Failed to send the queued PLDM request. EID = {EID} RC = {RC}",
+                    "EID", (unsigned)eid, "RC", rc);
+                queued.responseHandler(eid, nullptr, 0);
+            }
+        }
+    }
+
+    /** @brief Release the slot of a completed request in the window of its
+     *         endpoint and send the next queued requests
      *
-     *  @param[in] key - key for the Request
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
      */
-    void removeRequestEntry(RequestKey key)
+    void release(mctp_eid_t eid)
     {
-        if (removeRequestContainer.contains(key))
+        auto& window = getWindow(eid);
+        if (window.stats.inFlight)
         {
-            removeRequestContainer[key].reset();
-            requester.markFree(key.eid, key.instanceId);
-            handlers.erase(key);
-            removeRequestContainer.erase(key);
+            --window.stats.inFlight;
         }
+        dispatch(eid);
     }
 };
 
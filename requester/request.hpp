@@ -4,14 +4,15 @@
 #include "libpldm/pldm.h"
 
 #include "common/flight_recorder.hpp"
+#include "common/packet_tracer.hpp"
+#include "common/tx_queue.hpp"
 #include "common/types.hpp"
 #include "common/utils.hpp"
+#include "timer_wheel.hpp"
 
 #include <sys/socket.h>
 
 #include <phosphor-logging/lg2.hpp>
-#include <sdbusplus/timer.hpp>
-#include <sdeventplus/event.hpp>
 
 #include <chrono>
 #include <functional>
@@ -35,23 +36,22 @@ class RequestRetryTimer
   public:
     RequestRetryTimer() = delete;
     RequestRetryTimer(const RequestRetryTimer&) = delete;
-    RequestRetryTimer(RequestRetryTimer&&) = default;
+    RequestRetryTimer(RequestRetryTimer&&) = delete;
     RequestRetryTimer& operator=(const RequestRetryTimer&) = delete;
-    RequestRetryTimer& operator=(RequestRetryTimer&&) = default;
+    RequestRetryTimer& operator=(RequestRetryTimer&&) = delete;
     virtual ~RequestRetryTimer() = default;
 
     /** @brief Constructor
      *
-     *  @param[in] event - reference to PLDM daemon's main event loop
+     *  @param[in] timerWheel - timer wheel driving the retries
      *  @param[in] numRetries - number of request retries
      *  @param[in] timeout - time to wait between each retry in milliseconds
      */
-    explicit RequestRetryTimer(sdeventplus::Event& event, uint8_t numRetries,
+    explicit RequestRetryTimer(TimerWheel& timerWheel, uint8_t numRetries,
                                std::chrono::milliseconds timeout) :
-
-        event(event),
+        timerWheel(timerWheel),
         numRetries(numRetries), timeout(timeout),
-        timer(event.get(), std::bind_front(&RequestRetryTimer::callback, this))
+        retryEntry([this]() { callback(); })
     {}
 
     /** @brief Starts the request flow and arms the timer for request retries
@@ -70,8 +70,7 @@ class RequestRetryTimer
         {
             if (numRetries)
             {
-                timer.start(duration_cast<std::chrono::microseconds>(timeout),
-                            true);
+                timerWheel.arm(retryEntry, timeout);
             }
         }
         catch (const std::runtime_error& e)
@@ -87,20 +86,25 @@ class RequestRetryTimer
     /** @brief Stops the timer and no further request retries happen */
     void stop()
     {
-        auto rc = timer.stop();
-        if (rc)
-        {
-            error("Failed to stop the request timer. RC = {RC}", "RC",
-                  static_cast<int>(rc));
-        }
+        timerWheel.cancel(retryEntry);
+    }
+
+    /** @brief Check if the request was sent more than once
+     *
+     *  @return true if the request was retried
+     */
+    bool retried() const
+    {
+        return retransmitted;
     }
 
   protected:
-    sdeventplus::Event& event; //!< reference to PLDM daemon's main event loop
-    uint8_t numRetries;        //!< number of request retries
+    TimerWheel& timerWheel; //!< timer wheel driving the retries
+    uint8_t numRetries;     //!< number of request retries
     std::chrono::milliseconds
-        timeout;           //!< time to wait between each retry in milliseconds
-    phosphor::Timer timer; //!< manages starting timers and handling timeouts
+        timeout; //!< time to wait between each retry in milliseconds
+    TimerWheel::Entry retryEntry; //!< deadline of the next retry
+    bool retransmitted = false;   //!< the request was retried
 
     /** @brief Sends the PLDM request message
      *
@@ -111,13 +115,20 @@ class RequestRetryTimer
     /** @brief Callback function invoked when the timeout happens */
     void callback()
     {
-        if (numRetries--)
-        {
-            send();
-        }
-        else
+        --numRetries;
+        retransmitted = true;
+        send();
+        if (numRetries)
         {
-            stop();
+            try
+            {
+                timerWheel.arm(retryEntry, timeout);
+            }
+            catch (const std::runtime_error& e)
+            {
+                error("Failed to start the request timer. RC = {RC}", "RC",
+                      e.what());
+            }
         }
     }
 };
@@ -136,37 +147,39 @@ class Request final : public RequestRetryTimer
   public:
     Request() = delete;
     Request(const Request&) = delete;
-    Request(Request&&) = default;
+    Request(Request&&) = delete;
     Request& operator=(const Request&) = delete;
-    Request& operator=(Request&&) = default;
+    Request& operator=(Request&&) = delete;
     ~Request() = default;
 
     /** @brief Constructor
      *
      *  @param[in] fd - fd of the MCTP communication socket
+     *  @param[in] txQueue - transmit queue of the socket, the request is
+     *                       sent directly on the socket if null
      *  @param[in] eid - endpoint ID of the remote MCTP endpoint
-     *  @param[in] event - reference to PLDM daemon's main event loop
-     *  @param[in] requestMsg - PLDM request message
+     *  @param[in] timerWheel - timer wheel driving the retries
+     *  @param[in] requestMsg - PLDM request message, it must outlive the
+     *                          request
      *  @param[in] numRetries - number of request retries
      *  @param[in] timeout - time to wait between each retry in milliseconds
      *  @param[in] currrentSendbuffSize - the current send buffer size
-     *  @param[in] verbose - verbose tracing flag
      */
-    explicit Request(int fd, mctp_eid_t eid, sdeventplus::Event& event,
-                     pldm::Request&& requestMsg, uint8_t numRetries,
-                     std::chrono::milliseconds timeout,
-                     size_t currentSendbuffSize, bool verbose) :
-        RequestRetryTimer(event, numRetries, timeout),
-        fd(fd), eid(eid), requestMsg(std::move(requestMsg)),
-        currentSendbuffSize(currentSendbuffSize), verbose(verbose)
+    explicit Request(int fd, pldm::TxQueue* txQueue, mctp_eid_t eid,
+                     TimerWheel& timerWheel, const pldm::Request& requestMsg,
+                     uint8_t numRetries, std::chrono::milliseconds timeout,
+                     size_t currentSendbuffSize) :
+        RequestRetryTimer(timerWheel, numRetries, timeout),
+        fd(fd), txQueue(txQueue), eid(eid), requestMsg(requestMsg),
+        currentSendbuffSize(currentSendbuffSize)
     {}
 
   private:
-    int fd;                   //!< file descriptor of MCTP communications socket
-    mctp_eid_t eid;           //!< endpoint ID of the remote MCTP endpoint
-    pldm::Request requestMsg; //!< PLDM request message
+    int fd;                 //!< file descriptor of MCTP communications socket
+    pldm::TxQueue* txQueue; //!< transmit queue of the socket
+    mctp_eid_t eid;         //!< endpoint ID of the remote MCTP endpoint
+    const pldm::Request& requestMsg; //!< PLDM request message
     mutable int currentSendbuffSize; //!< current Send Buffer size
-    bool verbose;                    //!< verbose tracing flag
 
     /** @brief Sends the PLDM request message on the socket
      *
@@ -174,9 +187,15 @@ class Request final : public RequestRetryTimer
      */
     int send() const
     {
-        if (verbose)
+        pldm::tracer::PacketTracer::getInstance().trace(pldm::utils::Tx, eid,
+                                                        requestMsg);
+
+        // pldmd sends through the non-blocking transmit queue of the socket
+        if (txQueue)
         {
-            pldm::utils::printBuffer(pldm::utils::Tx, requestMsg);
+            pldm::flightrecorder::FlightRecorder::GetInstance().saveRecord(
+                requestMsg, true);
+            return txQueue->send(eid, requestMsg);
         }
 
         if (currentSendbuffSize >= 0 &&
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "libpldm/base.h"
+#include "libpldm/pldm.h"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+namespace requester
+{
+
+/** @class RttEstimator
+ *
+ *  Estimates the round-trip time of the PLDM requests per MCTP endpoint and
+ *  PLDM type, to derive the time to wait for a response before retrying a
+ *  request. The estimator follows the TCP retransmission timer of RFC 6298:
+ *  a smoothed RTT and RTT variance are updated from the samples, the timeout
+ *  is SRTT + 4 * RTTVAR, bounded. The timeout is doubled when a request gets
+ *  no response at all. The round-trip time of a retried request is ambiguous
+ *  so it is not sampled, the backed-off timeout is kept until a request gets
+ *  through without a retry (Karn's algorithm).
+ */
+class RttEstimator
+{
+  public:
+    /** @struct Estimate
+     *
+     *  Live round-trip time estimate of an endpoint and PLDM type.
+     */
+    struct Estimate
+    {
+        std::chrono::microseconds srtt{0};    //!< smoothed round-trip time
+        std::chrono::microseconds rttvar{0};  //!< round-trip time variance
+        std::chrono::microseconds timeout{0}; //!< current retry timeout
+        uint64_t samples = 0;                 //!< round-trip times sampled
+        uint64_t backoffs = 0;                //!< timeouts doubled
+    };
+
+    /** @brief Granularity of the timers the timeout is used with */
+    static constexpr auto clockGranularity = std::chrono::milliseconds(10);
+
+    RttEstimator() = delete;
+    RttEstimator(const RttEstimator&) = delete;
+    RttEstimator& operator=(const RttEstimator&) = delete;
+    RttEstimator(RttEstimator&&) = delete;
+    RttEstimator& operator=(RttEstimator&&) = delete;
+    ~RttEstimator() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] initialTimeOut - timeout until a round-trip time is
+     *                              sampled
+     *  @param[in] minTimeOut - lower bound of the timeout
+     *  @param[in] maxTimeOut - upper bound of the timeout
+     */
+    RttEstimator(std::chrono::milliseconds initialTimeOut,
+                 std::chrono::milliseconds minTimeOut,
+                 std::chrono::milliseconds maxTimeOut) :
+        minTimeOut(minTimeOut),
+        maxTimeOut(std::max(minTimeOut, maxTimeOut)),
+        initialTimeOut(std::clamp<std::chrono::microseconds>(
+            initialTimeOut, this->minTimeOut, this->maxTimeOut))
+    {}
+
+    /** @brief Get the time to wait for a response before retrying
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] type - PLDM type
+     *
+     *  @return timeout, rounded up to milliseconds
+     */
+    std::chrono::milliseconds timeout(mctp_eid_t eid, uint8_t type) const
+    {
+        auto it = estimates.find(key(eid, type));
+        return std::chrono::ceil<std::chrono::milliseconds>(
+            it == estimates.end() ? initialTimeOut : it->second.timeout);
+    }
+
+    /** @brief Update the estimate with the round-trip time of a request
+     *         that was not retried
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] type - PLDM type
+     *  @param[in] rtt - time from sending the request to the response
+     */
+    void sample(mctp_eid_t eid, uint8_t type,
+                std::chrono::steady_clock::duration rtt)
+    {
+        auto r = std::chrono::duration_cast<std::chrono::microseconds>(rtt);
+        auto& estimate = get(eid, type);
+        if (!estimate.samples)
+        {
+            estimate.srtt = r;
+            estimate.rttvar = r / 2;
+        }
+        else
+        {
+            // RTTVAR <- 3/4 * RTTVAR + 1/4 * |SRTT - R'|
+            // SRTT <- 7/8 * SRTT + 1/8 * R'
+            auto delta = estimate.srtt > r ? estimate.srtt - r
+                                           : r - estimate.srtt;
+            estimate.rttvar = (3 * estimate.rttvar + delta) / 4;
+            estimate.srtt = (7 * estimate.srtt + r) / 8;
+        }
+        ++estimate.samples;
+
+        std::chrono::microseconds variance =
+            std::max<std::chrono::microseconds>(clockGranularity,
+                                                4 * estimate.rttvar);
+        estimate.timeout = bound(estimate.srtt + variance);
+    }
+
+    /** @brief Double the timeout, after a request got no response
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] type - PLDM type
+     */
+    void backoff(mctp_eid_t eid, uint8_t type)
+    {
+        auto& estimate = get(eid, type);
+        estimate.timeout = bound(2 * estimate.timeout);
+        ++estimate.backoffs;
+    }
+
+    /** @brief Get the live estimate of an endpoint and PLDM type
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] type - PLDM type
+     *
+     *  @return copy of the estimate, nullopt if there is none yet
+     */
+    std::optional<Estimate> getEstimate(mctp_eid_t eid, uint8_t type) const
+    {
+        auto it = estimates.find(key(eid, type));
+        if (it == estimates.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /** @brief Log the live estimates */
+    void logStats() const
+    {
+        for (const auto& [k, estimate] : estimates)
+        {
+            info(
+                "PLDM round-trip time. EID = {EID} TYPE = {TYPE} SRTT_US = {SRTT} RTTVAR_US = {RTTVAR} TIMEOUT_US = {TIMEOUT} SAMPLES = {SAMPLES} BACKOFFS = {BACKOFFS}",
+                "EID", (unsigned)(k >> 8), "TYPE", (unsigned)(k & 0xFF),
+                "SRTT", estimate.srtt.count(), "RTTVAR",
+                estimate.rttvar.count(), "TIMEOUT", estimate.timeout.count(),
+                "SAMPLES", estimate.samples, "BACKOFFS", estimate.backoffs);
+        }
+    }
+
+  private:
+    std::chrono::microseconds minTimeOut;     //!< lower bound of timeout
+    std::chrono::microseconds maxTimeOut;     //!< upper bound of timeout
+    std::chrono::microseconds initialTimeOut; //!< timeout before a sample
+
+    /** @brief Estimates keyed by endpoint ID and PLDM type */
+    std::unordered_map<uint16_t, Estimate> estimates;
+
+    /** @brief Get the key of an endpoint and PLDM type
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] type - PLDM type
+     *
+     *  @return key of the estimate
+     */
+    static uint16_t key(mctp_eid_t eid, uint8_t type)
+    {
+        return static_cast<uint16_t>(eid << 8 | type);
+    }
+
+    /** @brief Get the estimate of an endpoint and PLDM type, creating it
+     *         with the initial timeout if needed
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] type - PLDM type
+     *
+     *  @return estimate
+     */
+    Estimate& get(mctp_eid_t eid, uint8_t type)
+    {
+        auto [it, inserted] = estimates.try_emplace(key(eid, type));
+        if (inserted)
+        {
+            it->second.timeout = initialTimeOut;
+        }
+        return it->second;
+    }
+
+    /** @brief Bound a timeout
+     *
+     *  @param[in] timeout - timeout
+     *
+     *  @return timeout within the bounds
+     */
+    std::chrono::microseconds bound(std::chrono::microseconds timeout) const
+    {
+        return std::clamp(timeout, minTimeOut, maxTimeOut);
+    }
+};
+
+} // namespace requester
+} // namespace pldm
@@ -0,0 +1,237 @@
+#include "libpldm/base.h"
+
+#include "common/types.hpp"
+#include "common/utils.hpp"
+#include "mock_request.hpp"
+#include "pldmd/dbus_impl_requester.hpp"
+#include "requester/coroutine.hpp"
+#include "requester/handler.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace pldm::requester;
+using namespace std::chrono;
+
+using ::testing::NiceMock;
+
+class CoroutineTest : public testing::Test
+{
+  protected:
+    CoroutineTest() :
+        event(sdeventplus::Event::get_default()),
+        dbusImplReq(pldm::utils::DBusHandler::getBus(),
+                    "/xyz/openbmc_project/pldm"),
+        reqHandler(fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+                   milliseconds(100))
+    {}
+
+    int fd = 0;
+    mctp_eid_t eid = 0;
+    sdeventplus::Event event;
+    pldm::dbus_api::Requester dbusImplReq;
+    Handler<NiceMock<MockRequest>> reqHandler;
+
+    /** @brief This function runs the sd_event_run in a loop till all the events
+     *         in the testcase are dispatched and exits when there are no events
+     *         for the timeout time.
+     *
+     *  @param[in] timeout - maximum time to wait for an event
+     */
+    void waitEventExpiry(milliseconds timeout)
+    {
+        while (1)
+        {
+            auto sleepTime = duration_cast<microseconds>(timeout);
+            // Returns 0 on timeout
+            if (!sd_event_run(event.get(), sleepTime.count()))
+            {
+                break;
+            }
+        }
+    }
+
+    /** @brief Build a request message of the PLDM base type
+     *
+     *  @param[in] command - PLDM command
+     *  @return request message with an empty payload
+     */
+    static pldm::Request makeRequest(uint8_t command)
+    {
+        pldm::Request request(sizeof(pldm_msg_hdr));
+        auto hdr = reinterpret_cast<pldm_msg_hdr*>(request.data());
+        hdr->request = PLDM_REQUEST;
+        hdr->type = PLDM_BASE;
+        hdr->command = command;
+        return request;
+    }
+
+    /** @brief Respond to an outstanding request
+     *
+     *  @param[in] instanceId - instance ID of the request
+     *  @param[in] command - PLDM command of the request
+     *  @param[in] completionCode - completion code of the response
+     */
+    void respond(uint8_t instanceId, uint8_t command, uint8_t completionCode)
+    {
+        pldm::Response response(sizeof(pldm_msg_hdr) + sizeof(uint8_t));
+        auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+        responsePtr->payload[0] = completionCode;
+        reqHandler.handleResponse(eid, instanceId, PLDM_BASE, command,
+                                  responsePtr, response.size());
+    }
+
+    /** @brief Send a request and return the completion code of the response
+     *
+     *  @param[in] command - PLDM command of the request
+     *  @return completion code, -1 if no response is received
+     */
+    Task<int> exchange(uint8_t command)
+    {
+        auto [rc, response, respMsgLen] =
+            co_await reqHandler.sendRecvMsg(eid, makeRequest(command));
+        if (rc || !response || !respMsgLen)
+        {
+            co_return -1;
+        }
+        co_return response->payload[0];
+    }
+};
+
+TEST_F(CoroutineTest, sendRecvMsg)
+{
+    int result = 0;
+    auto flow = [&]() -> Task<> { result = co_await exchange(2); };
+    flow().detach();
+    EXPECT_EQ(result, 0);
+
+    // The first instance ID is allocated to the request
+    respond(0, 2, 0x20);
+    EXPECT_EQ(result, 0x20);
+
+    // The instance ID is freed once the response is handled
+    EXPECT_EQ(dbusImplReq.tryGetInstanceId(eid), 1);
+    dbusImplReq.markFree(eid, 1);
+    for (size_t i = 1; i < pldm::maxInstanceIds; ++i)
+    {
+        EXPECT_NE(dbusImplReq.tryGetInstanceId(eid), std::nullopt);
+    }
+}
+
+TEST_F(CoroutineTest, sendRecvMsgChained)
+{
+    std::vector<int> results;
+    auto flow = [&]() -> Task<> {
+        results.push_back(co_await exchange(2));
+        results.push_back(co_await exchange(3));
+    };
+    flow().detach();
+
+    respond(0, 2, 1);
+    ASSERT_EQ(results.size(), 1);
+    // The second request is registered from the response handler of the
+    // first one and gets the next instance ID
+    respond(1, 3, 2);
+    EXPECT_EQ(results, (std::vector<int>{1, 2}));
+}
+
+TEST_F(CoroutineTest, sendRecvMsgNoResponse)
+{
+    bool done = false;
+    int result = 0;
+    auto flow = [&]() -> Task<> {
+        result = co_await exchange(2);
+        done = true;
+    };
+    flow().detach();
+
+    // Waiting for the instance ID expiry
+    waitEventExpiry(milliseconds(1500));
+    EXPECT_TRUE(done);
+    EXPECT_EQ(result, -1);
+}
+
+TEST_F(CoroutineTest, sendRecvMsgInvalidRequest)
+{
+    int rc = PLDM_SUCCESS;
+    auto flow = [&]() -> Task<> {
+        auto [result, response, respMsgLen] =
+            co_await reqHandler.sendRecvMsg(eid, pldm::Request{});
+        rc = result;
+    };
+    flow().detach();
+    EXPECT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+}
+
+TEST_F(CoroutineTest, whenAllConcurrent)
+{
+    std::vector<int> results;
+    auto flow = [&]() -> Task<> {
+        std::vector<Task<int>> tasks;
+        for (uint8_t command = 2; command < 5; ++command)
+        {
+            tasks.emplace_back(exchange(command));
+        }
+        results = co_await whenAll(std::move(tasks));
+    };
+    flow().detach();
+
+    // All the requests are outstanding, respond in the reverse order
+    respond(2, 4, 3);
+    respond(1, 3, 2);
+    EXPECT_TRUE(results.empty());
+    respond(0, 2, 1);
+    EXPECT_EQ(results, (std::vector<int>{1, 2, 3}));
+}
+
+TEST_F(CoroutineTest, whenAllBounded)
+{
+    bool done = false;
+    auto flow = [&]() -> Task<> {
+        std::vector<Task<int>> tasks;
+        for (uint8_t command = 2; command < 5; ++command)
+        {
+            tasks.emplace_back(exchange(command));
+        }
+        auto results = co_await whenAll(std::move(tasks), 1);
+        EXPECT_EQ(results, (std::vector<int>{1, 2, 3}));
+        done = true;
+    };
+    flow().detach();
+
+    // One request at a time, each one is registered from the response
+    // handler of the previous one
+    respond(0, 2, 1);
+    EXPECT_FALSE(done);
+    respond(1, 3, 2);
+    EXPECT_FALSE(done);
+    respond(2, 4, 3);
+    EXPECT_TRUE(done);
+}
+
+TEST_F(CoroutineTest, whenAllException)
+{
+    bool caught = false;
+    auto fail = []() -> Task<> {
+        throw std::runtime_error("failed");
+        co_return;
+    };
+    auto flow = [&]() -> Task<> {
+        std::vector<Task<>> tasks;
+        tasks.emplace_back(fail());
+        tasks.emplace_back(fail());
+        try
+        {
+            co_await whenAll(std::move(tasks));
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+    };
+    flow().detach();
+    EXPECT_TRUE(caught);
+}
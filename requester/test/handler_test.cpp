@@ -6,6 +6,8 @@
 #include "pldmd/dbus_impl_requester.hpp"
 #include "requester/handler.hpp"
 
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -51,6 +53,24 @@ class HandlerTest : public testing::Test
         }
     }
 
+    /** @brief Count the free instance IDs of the endpoint
+     *
+     *  @return number of instance IDs that can be allocated
+     */
+    size_t countFreeInstanceIds()
+    {
+        std::vector<uint8_t> instanceIds;
+        while (auto instanceId = dbusImplReq.tryGetInstanceId(eid))
+        {
+            instanceIds.push_back(*instanceId);
+        }
+        for (auto instanceId : instanceIds)
+        {
+            dbusImplReq.markFree(eid, instanceId);
+        }
+        return instanceIds.size();
+    }
+
   public:
     bool nullResponse = false;
     bool validResponse = false;
@@ -75,7 +95,8 @@ class HandlerTest : public testing::Test
 TEST_F(HandlerTest, singleRequestResponseScenario)
 {
     Handler<NiceMock<MockRequest>> reqHandler(
-        fd, event, dbusImplReq, false, 90000, seconds(1), 2, milliseconds(100));
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(100));
     pldm::Request request{};
     auto instanceId = dbusImplReq.getInstanceId(eid);
     auto rc = reqHandler.registerRequest(
@@ -89,15 +110,21 @@ TEST_F(HandlerTest, singleRequestResponseScenario)
                               sizeof(response));
 
     // handleResponse() will free the instance ID after calling the response
-    // handler, so the same instance ID is granted next as well
+    // handler
     EXPECT_EQ(validResponse, true);
-    EXPECT_EQ(instanceId, dbusImplReq.getInstanceId(eid));
+    EXPECT_EQ(countFreeInstanceIds(), pldm::maxInstanceIds);
+
+    // The round-trip time of the request is sampled
+    auto estimate = reqHandler.getRttEstimator().getEstimate(eid, 0);
+    ASSERT_NE(estimate, std::nullopt);
+    EXPECT_EQ(estimate->samples, 1);
 }
 
 TEST_F(HandlerTest, singleRequestInstanceIdTimerExpired)
 {
     Handler<NiceMock<MockRequest>> reqHandler(
-        fd, event, dbusImplReq, false, 90000, seconds(1), 2, milliseconds(100));
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(100));
     pldm::Request request{};
     auto instanceId = dbusImplReq.getInstanceId(eid);
     auto rc = reqHandler.registerRequest(
@@ -109,15 +136,69 @@ TEST_F(HandlerTest, singleRequestInstanceIdTimerExpired)
     waitEventExpiry(milliseconds(500));
 
     // cleanup() will free the instance ID after calling the response
-    // handler will no response, so the same instance ID is granted next
-    EXPECT_EQ(instanceId, dbusImplReq.getInstanceId(eid));
+    // handler will no response
+    EXPECT_EQ(countFreeInstanceIds(), pldm::maxInstanceIds);
+    EXPECT_EQ(nullResponse, true);
+
+    // The timeout is backed off for the next requests
+    EXPECT_EQ(reqHandler.getRttEstimator().timeout(eid, 0), milliseconds(200));
+}
+
+TEST_F(HandlerTest, retriedResponseNotSampled)
+{
+    Handler<NiceMock<MockRequest>> reqHandler(
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(100));
+    pldm::Request request{};
+    auto instanceId = dbusImplReq.getInstanceId(eid);
+    auto rc = reqHandler.registerRequest(
+        eid, instanceId, 0, 0, std::move(request),
+        std::move(std::bind_front(&HandlerTest::pldmResponseCallBack, this)));
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+
+    // Let the request be retried once before the response is received
+    sd_event_run(event.get(), duration_cast<microseconds>(
+                                  milliseconds(150)).count());
+
+    pldm::Response response(sizeof(pldm_msg_hdr) + sizeof(uint8_t));
+    auto responsePtr = reinterpret_cast<const pldm_msg*>(response.data());
+    reqHandler.handleResponse(eid, instanceId, 0, 0, responsePtr,
+                              sizeof(response));
+    EXPECT_EQ(validResponse, true);
+
+    // The round-trip time is ambiguous, it is neither sampled nor is the
+    // timeout doubled again
+    auto estimate = reqHandler.getRttEstimator().getEstimate(eid, 0);
+    EXPECT_TRUE(!estimate || !estimate->samples);
+    EXPECT_EQ(reqHandler.getRttEstimator().timeout(eid, 0), milliseconds(100));
+}
+
+TEST_F(HandlerTest, retryTimeoutCappedByInstanceIdExpiry)
+{
+    // 3 transmissions of the request have to fit in 1s
+    Handler<NiceMock<MockRequest>> reqHandler(
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(2000), 1, milliseconds(100), milliseconds(4800));
+    EXPECT_EQ(reqHandler.getRttEstimator().timeout(eid, 0), milliseconds(333));
+
+    pldm::Request request{};
+    auto instanceId = dbusImplReq.getInstanceId(eid);
+    auto rc = reqHandler.registerRequest(
+        eid, instanceId, 0, 0, std::move(request),
+        std::move(std::bind_front(&HandlerTest::pldmResponseCallBack, this)));
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+    waitEventExpiry(milliseconds(1500));
     EXPECT_EQ(nullResponse, true);
+
+    // Backing off does not go past the cap either
+    EXPECT_EQ(reqHandler.getRttEstimator().timeout(eid, 0), milliseconds(333));
 }
 
 TEST_F(HandlerTest, multipleRequestResponseScenario)
 {
     Handler<NiceMock<MockRequest>> reqHandler(
-        fd, event, dbusImplReq, false, 90000, seconds(2), 2, milliseconds(100));
+        fd, nullptr, event, dbusImplReq, 90000, seconds(2), 2,
+        milliseconds(100));
     pldm::Request request{};
     auto instanceId = dbusImplReq.getInstanceId(eid);
     auto rc = reqHandler.registerRequest(
@@ -149,5 +230,261 @@ TEST_F(HandlerTest, multipleRequestResponseScenario)
 
     EXPECT_EQ(validResponse, true);
     EXPECT_EQ(callbackCount, 2);
-    EXPECT_EQ(instanceId, dbusImplReq.getInstanceId(eid));
+    EXPECT_EQ(countFreeInstanceIds(), pldm::maxInstanceIds);
+}
+
+namespace
+{
+
+/** @brief Build a request message of the PLDM base type
+ *
+ *  @param[in] command - PLDM command
+ *  @return request message with an empty payload
+ */
+pldm::Request makeRequest(uint8_t command)
+{
+    pldm::Request request(sizeof(pldm_msg_hdr));
+    auto hdr = reinterpret_cast<pldm_msg_hdr*>(request.data());
+    hdr->request = PLDM_REQUEST;
+    hdr->type = PLDM_BASE;
+    hdr->command = command;
+    return request;
+}
+
+} // namespace
+
+TEST_F(HandlerTest, scheduledRequestsQueuedBeyondWindow)
+{
+    Handler<NiceMock<MockRequest>> reqHandler(
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(100), 2);
+    std::vector<uint8_t> completed;
+    for (uint8_t command = 1; command <= 4; ++command)
+    {
+        auto rc = reqHandler.scheduleRequest(
+            eid, makeRequest(command),
+            [&completed, command](mctp_eid_t, const pldm_msg*, size_t) {
+            completed.push_back(command);
+        });
+        EXPECT_EQ(rc, PLDM_SUCCESS);
+    }
+
+    auto stats = reqHandler.getWindowStats(eid);
+    EXPECT_EQ(stats.inFlight, 2);
+    EXPECT_EQ(stats.depth, 2);
+    EXPECT_EQ(stats.queued, 2);
+
+    pldm::Response response(sizeof(pldm_msg_hdr) + sizeof(uint8_t));
+    auto responsePtr = reinterpret_cast<const pldm_msg*>(response.data());
+
+    // The response to the first request lets the next queued one go, the
+    // instance IDs are handed out in the order the requests are sent
+    reqHandler.handleResponse(eid, 0, PLDM_BASE, 1, responsePtr,
+                              response.size());
+    stats = reqHandler.getWindowStats(eid);
+    EXPECT_EQ(stats.inFlight, 2);
+    EXPECT_EQ(stats.depth, 1);
+    EXPECT_EQ(stats.dispatched, 1);
+
+    reqHandler.handleResponse(eid, 2, PLDM_BASE, 3, responsePtr,
+                              response.size());
+    reqHandler.handleResponse(eid, 1, PLDM_BASE, 2, responsePtr,
+                              response.size());
+    reqHandler.handleResponse(eid, 3, PLDM_BASE, 4, responsePtr,
+                              response.size());
+
+    EXPECT_EQ(completed, (std::vector<uint8_t>{1, 3, 2, 4}));
+    stats = reqHandler.getWindowStats(eid);
+    EXPECT_EQ(stats.inFlight, 0);
+    EXPECT_EQ(stats.depth, 0);
+    EXPECT_EQ(stats.maxDepth, 2);
+    EXPECT_EQ(stats.dispatched, 2);
+}
+
+TEST_F(HandlerTest, scheduledRequestsDispatchedByPriority)
+{
+    Handler<NiceMock<MockRequest>> reqHandler(
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(100), 1);
+    std::vector<uint8_t> completed;
+    auto schedule = [&](uint8_t command, RequestPriority priority) {
+        return reqHandler.scheduleRequest(
+            eid, makeRequest(command),
+            [&completed, command](mctp_eid_t, const pldm_msg*, size_t) {
+            completed.push_back(command);
+        },
+            priority);
+    };
+    EXPECT_EQ(schedule(1, RequestPriority::Normal), PLDM_SUCCESS);
+    EXPECT_EQ(schedule(2, RequestPriority::Low), PLDM_SUCCESS);
+    EXPECT_EQ(schedule(3, RequestPriority::High), PLDM_SUCCESS);
+    EXPECT_EQ(schedule(4, RequestPriority::Normal), PLDM_SUCCESS);
+    EXPECT_EQ(reqHandler.getWindowStats(eid).depth, 3);
+
+    pldm::Response response(sizeof(pldm_msg_hdr) + sizeof(uint8_t));
+    auto responsePtr = reinterpret_cast<const pldm_msg*>(response.data());
+    uint8_t instanceId = 0;
+    for (uint8_t command : {1, 3, 4, 2})
+    {
+        reqHandler.handleResponse(eid, instanceId++, PLDM_BASE, command,
+                                  responsePtr, response.size());
+    }
+    EXPECT_EQ(completed, (std::vector<uint8_t>{1, 3, 4, 2}));
+}
+
+TEST_F(HandlerTest, scheduledRequestInstanceIdExpired)
+{
+    Handler<NiceMock<MockRequest>> reqHandler(
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(100), 1);
+    int nullResponses = 0;
+    for (uint8_t command = 1; command <= 2; ++command)
+    {
+        reqHandler.scheduleRequest(
+            eid, makeRequest(command),
+            [&nullResponses](mctp_eid_t, const pldm_msg* response, size_t) {
+            if (!response)
+            {
+                ++nullResponses;
+            }
+        });
+    }
+
+    // The expiry of the first request lets the queued one go, which
+    // expires in turn
+    waitEventExpiry(milliseconds(1500));
+    EXPECT_EQ(nullResponses, 2);
+    EXPECT_EQ(reqHandler.getWindowStats(eid).inFlight, 0);
+    EXPECT_EQ(reqHandler.getWindowStats(eid).dispatched, 1);
+}
+
+TEST_F(HandlerTest, identicalRequestsCoalesced)
+{
+    Handler<NiceMock<MockRequest>> reqHandler(
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(100), REQUEST_WINDOW_SIZE, milliseconds(100),
+        milliseconds(4800), true);
+    std::vector<uint8_t> completionCodes;
+    auto handler = [&completionCodes](mctp_eid_t, const pldm_msg* response,
+                                      size_t) {
+        completionCodes.push_back(response->payload[0]);
+    };
+
+    auto instanceId = dbusImplReq.getInstanceId(eid);
+    auto request = makeRequest(PLDM_GET_PLDM_TYPES);
+    reinterpret_cast<pldm_msg_hdr*>(request.data())->instance_id = instanceId;
+    auto rc = reqHandler.registerRequest(eid, instanceId, PLDM_BASE,
+                                         PLDM_GET_PLDM_TYPES,
+                                         std::move(request), handler);
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+
+    // The same request registered with another instance ID and scheduled
+    // is attached to the outstanding one, the instance ID is freed
+    auto instanceIdNxt = dbusImplReq.getInstanceId(eid);
+    rc = reqHandler.registerRequest(eid, instanceIdNxt, PLDM_BASE,
+                                    PLDM_GET_PLDM_TYPES,
+                                    makeRequest(PLDM_GET_PLDM_TYPES), handler);
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+    rc = reqHandler.scheduleRequest(eid, makeRequest(PLDM_GET_PLDM_TYPES),
+                                    handler);
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+    auto stats = reqHandler.getWindowStats(eid);
+    EXPECT_EQ(stats.coalesced, 2);
+    EXPECT_EQ(stats.inFlight, 1);
+    EXPECT_EQ(countFreeInstanceIds(), pldm::maxInstanceIds - 1);
+
+    pldm::Response response(sizeof(pldm_msg_hdr) + sizeof(uint8_t));
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    responsePtr->payload[0] = PLDM_SUCCESS;
+    reqHandler.handleResponse(eid, instanceId, PLDM_BASE, PLDM_GET_PLDM_TYPES,
+                              responsePtr, response.size());
+    EXPECT_EQ(completionCodes, (std::vector<uint8_t>(3, PLDM_SUCCESS)));
+    EXPECT_EQ(reqHandler.getWindowStats(eid).inFlight, 0);
+    EXPECT_EQ(countFreeInstanceIds(), pldm::maxInstanceIds);
+}
+
+TEST_F(HandlerTest, coalescedRequestsInstanceIdExpired)
+{
+    Handler<NiceMock<MockRequest>> reqHandler(
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(100), REQUEST_WINDOW_SIZE, milliseconds(100),
+        milliseconds(4800), true);
+    int nullResponses = 0;
+    for (int i = 0; i < 2; ++i)
+    {
+        reqHandler.scheduleRequest(
+            eid, makeRequest(PLDM_GET_TID),
+            [&nullResponses](mctp_eid_t, const pldm_msg* response, size_t) {
+            if (!response)
+            {
+                ++nullResponses;
+            }
+        });
+    }
+    EXPECT_EQ(reqHandler.getWindowStats(eid).coalesced, 1);
+
+    waitEventExpiry(milliseconds(1500));
+    EXPECT_EQ(nullResponses, 2);
+    EXPECT_EQ(countFreeInstanceIds(), pldm::maxInstanceIds);
+}
+
+TEST_F(HandlerTest, requestsNotCoalesced)
+{
+    Handler<NiceMock<MockRequest>> reqHandler(
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(100), REQUEST_WINDOW_SIZE, milliseconds(100),
+        milliseconds(4800), false);
+    Handler<NiceMock<MockRequest>> coalescingHandler(
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(100), REQUEST_WINDOW_SIZE, milliseconds(100),
+        milliseconds(4800), true);
+    auto handler = [](mctp_eid_t, const pldm_msg*, size_t) {};
+
+    // Coalescing is disabled
+    reqHandler.scheduleRequest(eid, makeRequest(PLDM_GET_TID), handler);
+    reqHandler.scheduleRequest(eid, makeRequest(PLDM_GET_TID), handler);
+    EXPECT_EQ(reqHandler.getWindowStats(eid).inFlight, 2);
+
+    // SetTID is not idempotent, nor are requests with another payload
+    coalescingHandler.scheduleRequest(eid, makeRequest(PLDM_SET_TID), handler);
+    coalescingHandler.scheduleRequest(eid, makeRequest(PLDM_SET_TID), handler);
+    auto request = makeRequest(PLDM_GET_TID);
+    request.push_back(1);
+    coalescingHandler.scheduleRequest(eid, makeRequest(PLDM_GET_TID),
+                                      handler);
+    coalescingHandler.scheduleRequest(eid, std::move(request), handler);
+    auto stats = coalescingHandler.getWindowStats(eid);
+    EXPECT_EQ(stats.coalesced, 0);
+    EXPECT_EQ(stats.inFlight, 4);
+}
+
+TEST_F(HandlerTest, requestBuffersRecycled)
+{
+    Handler<NiceMock<MockRequest>> reqHandler(
+        fd, nullptr, event, dbusImplReq, 90000, seconds(1), 2,
+        milliseconds(100));
+    auto request = reqHandler.allocRequest(sizeof(pldm_msg_hdr));
+    auto buffer = request.data();
+    reinterpret_cast<pldm_msg_hdr*>(buffer)->command = PLDM_SET_TID;
+    auto instanceId = dbusImplReq.getInstanceId(eid);
+    auto rc = reqHandler.registerRequest(
+        eid, instanceId, PLDM_BASE, PLDM_SET_TID, std::move(request),
+        [](mctp_eid_t, const pldm_msg*, size_t) {});
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+
+    // The instance ID is in use until the response
+    rc = reqHandler.registerRequest(eid, instanceId, PLDM_BASE, PLDM_SET_TID,
+                                    makeRequest(PLDM_SET_TID),
+                                    [](mctp_eid_t, const pldm_msg*, size_t) {});
+    EXPECT_EQ(rc, PLDM_ERROR);
+
+    pldm::Response response(sizeof(pldm_msg_hdr) + sizeof(uint8_t));
+    auto responsePtr = reinterpret_cast<const pldm_msg*>(response.data());
+    reqHandler.handleResponse(eid, instanceId, PLDM_BASE, PLDM_SET_TID,
+                              responsePtr, response.size());
+
+    // The buffer of the completed request is handed out again, zero filled
+    request = reqHandler.allocRequest(sizeof(pldm_msg_hdr));
+    EXPECT_EQ(request.data(), buffer);
+    EXPECT_EQ(request, pldm::Request(sizeof(pldm_msg_hdr)));
 }
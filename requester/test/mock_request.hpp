@@ -14,11 +14,11 @@ namespace requester
 class MockRequest : public RequestRetryTimer
 {
   public:
-    MockRequest(int /*fd*/, mctp_eid_t /*eid*/, sdeventplus::Event& event,
-                pldm::Request&& /*requestMsg*/, uint8_t numRetries,
-                std::chrono::milliseconds responseTimeOut,
-                size_t /*currentSendbuffSize*/, bool /*verbose*/) :
-        RequestRetryTimer(event, numRetries, responseTimeOut)
+    MockRequest(int /*fd*/, pldm::TxQueue* /*txQueue*/, mctp_eid_t /*eid*/,
+                TimerWheel& timerWheel, const pldm::Request& /*requestMsg*/,
+                uint8_t numRetries, std::chrono::milliseconds responseTimeOut,
+                size_t /*currentSendbuffSize*/) :
+        RequestRetryTimer(timerWheel, numRetries, responseTimeOut)
     {}
 
     MOCK_METHOD(int, send, (), (const, override));
@@ -18,7 +18,9 @@ using ::testing::Return;
 class RequestIntfTest : public testing::Test
 {
   protected:
-    RequestIntfTest() : event(sdeventplus::Event::get_default()) {}
+    RequestIntfTest() :
+        event(sdeventplus::Event::get_default()), timerWheel(event)
+    {}
 
     /** @brief This function runs the sd_event_run in a loop till all the events
      *         in the testcase are dispatched and exits when there are no events
@@ -42,13 +44,14 @@ class RequestIntfTest : public testing::Test
     int fd = 0;
     mctp_eid_t eid = 0;
     sdeventplus::Event event;
+    TimerWheel timerWheel;
     std::vector<uint8_t> requestMsg;
 };
 
 TEST_F(RequestIntfTest, 0Retries100msTimeout)
 {
-    MockRequest request(fd, eid, event, std::move(requestMsg), 0,
-                        milliseconds(100), 90000, false);
+    MockRequest request(fd, nullptr, eid, timerWheel, requestMsg, 0,
+                        milliseconds(100), 90000);
     EXPECT_CALL(request, send())
         .Times(Exactly(1))
         .WillOnce(Return(PLDM_SUCCESS));
@@ -58,8 +61,8 @@ TEST_F(RequestIntfTest, 0Retries100msTimeout)
 
 TEST_F(RequestIntfTest, 2Retries100msTimeout)
 {
-    MockRequest request(fd, eid, event, std::move(requestMsg), 2,
-                        milliseconds(100), 90000, false);
+    MockRequest request(fd, nullptr, eid, timerWheel, requestMsg, 2,
+                        milliseconds(100), 90000);
     // send() is called a total of 3 times, the original plus two retries
     EXPECT_CALL(request, send()).Times(3).WillRepeatedly(Return(PLDM_SUCCESS));
     auto rc = request.start();
@@ -69,8 +72,8 @@ TEST_F(RequestIntfTest, 2Retries100msTimeout)
 
 TEST_F(RequestIntfTest, 9Retries100msTimeoutRequestStoppedAfter1sec)
 {
-    MockRequest request(fd, eid, event, std::move(requestMsg), 9,
-                        milliseconds(100), 90000, false);
+    MockRequest request(fd, nullptr, eid, timerWheel, requestMsg, 9,
+                        milliseconds(100), 90000);
     // send() will be called a total of 10 times, the original plus 9 retries.
     // In a ideal scenario send() would have been called 10 times in 1 sec (when
     // the timer is stopped) with a timeout of 100ms. Because there are delays
@@ -92,8 +95,8 @@ TEST_F(RequestIntfTest, 9Retries100msTimeoutRequestStoppedAfter1sec)
 
 TEST_F(RequestIntfTest, 2Retries100msTimeoutsendReturnsError)
 {
-    MockRequest request(fd, eid, event, std::move(requestMsg), 2,
-                        milliseconds(100), 90000, false);
+    MockRequest request(fd, nullptr, eid, timerWheel, requestMsg, 2,
+                        milliseconds(100), 90000);
     EXPECT_CALL(request, send()).Times(Exactly(1)).WillOnce(Return(PLDM_ERROR));
     auto rc = request.start();
     EXPECT_EQ(rc, PLDM_ERROR);
@@ -0,0 +1,80 @@
+#include "requester/rtt_estimator.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace pldm::requester;
+using namespace std::chrono;
+
+class RttEstimatorTest : public testing::Test
+{
+  protected:
+    RttEstimator estimator{milliseconds(2000), milliseconds(100),
+                           milliseconds(4800)};
+    mctp_eid_t eid = 9;
+    uint8_t type = 2;
+};
+
+TEST_F(RttEstimatorTest, initialTimeout)
+{
+    EXPECT_EQ(estimator.timeout(eid, type), milliseconds(2000));
+    EXPECT_EQ(estimator.getEstimate(eid, type), std::nullopt);
+
+    RttEstimator bounded(milliseconds(10000), milliseconds(100),
+                         milliseconds(4800));
+    EXPECT_EQ(bounded.timeout(eid, type), milliseconds(4800));
+}
+
+TEST_F(RttEstimatorTest, firstSample)
+{
+    estimator.sample(eid, type, milliseconds(200));
+    auto estimate = estimator.getEstimate(eid, type);
+    ASSERT_NE(estimate, std::nullopt);
+    EXPECT_EQ(estimate->srtt, milliseconds(200));
+    EXPECT_EQ(estimate->rttvar, milliseconds(100));
+    EXPECT_EQ(estimate->samples, 1);
+    // SRTT + 4 * RTTVAR
+    EXPECT_EQ(estimator.timeout(eid, type), milliseconds(600));
+
+    // Other endpoints and types keep their own estimate
+    EXPECT_EQ(estimator.timeout(eid, type + 1), milliseconds(2000));
+    EXPECT_EQ(estimator.timeout(eid + 1, type), milliseconds(2000));
+}
+
+TEST_F(RttEstimatorTest, convergesToSteadyRtt)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        estimator.sample(eid, type, milliseconds(300));
+    }
+    auto estimate = estimator.getEstimate(eid, type);
+    ASSERT_NE(estimate, std::nullopt);
+    EXPECT_EQ(estimate->srtt, milliseconds(300));
+    // The variance vanishes, the timeout is kept above the granularity of
+    // the timers
+    EXPECT_EQ(estimator.timeout(eid, type),
+              milliseconds(300) + RttEstimator::clockGranularity);
+}
+
+TEST_F(RttEstimatorTest, fastEndpointBoundedBelow)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        estimator.sample(eid, type, microseconds(500));
+    }
+    EXPECT_EQ(estimator.timeout(eid, type), milliseconds(100));
+}
+
+TEST_F(RttEstimatorTest, backoff)
+{
+    estimator.sample(eid, type, milliseconds(200));
+    estimator.backoff(eid, type);
+    EXPECT_EQ(estimator.timeout(eid, type), milliseconds(1200));
+    estimator.backoff(eid, type);
+    estimator.backoff(eid, type);
+    EXPECT_EQ(estimator.timeout(eid, type), milliseconds(4800));
+    EXPECT_EQ(estimator.getEstimate(eid, type)->backoffs, 3);
+
+    // Without a sample the initial timeout is doubled
+    estimator.backoff(eid, type + 1);
+    EXPECT_EQ(estimator.timeout(eid, type + 1), milliseconds(4000));
+}
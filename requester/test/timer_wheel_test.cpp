@@ -0,0 +1,160 @@
+#include "requester/timer_wheel.hpp"
+
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::requester;
+using namespace std::chrono;
+
+class TimerWheelTest : public testing::Test
+{
+  protected:
+    TimerWheelTest() : event(sdeventplus::Event::get_default()) {}
+
+    /** @brief This function runs the sd_event_run in a loop till all the events
+     *         in the testcase are dispatched and exits when there are no events
+     *         for the timeout time.
+     *
+     *  @param[in] timeout - maximum time to wait for an event
+     */
+    void waitEventExpiry(milliseconds timeout)
+    {
+        while (1)
+        {
+            auto sleepTime = duration_cast<microseconds>(timeout);
+            // Returns 0 on timeout
+            if (!sd_event_run(event.get(), sleepTime.count()))
+            {
+                break;
+            }
+        }
+    }
+
+    sdeventplus::Event event;
+};
+
+TEST_F(TimerWheelTest, testExpiryOrder)
+{
+    TimerWheel wheel(event, milliseconds(1));
+    std::vector<int> fired;
+    TimerWheel::Entry first([&fired]() { fired.push_back(1); });
+    TimerWheel::Entry second([&fired]() { fired.push_back(2); });
+    TimerWheel::Entry third([&fired]() { fired.push_back(3); });
+
+    auto start = steady_clock::now();
+    wheel.arm(third, milliseconds(150));
+    wheel.arm(first, milliseconds(20));
+    wheel.arm(second, milliseconds(90));
+    EXPECT_EQ(wheel.pending(), 3);
+
+    waitEventExpiry(milliseconds(200));
+    EXPECT_EQ(fired, (std::vector<int>{1, 2, 3}));
+    EXPECT_GE(steady_clock::now() - start, milliseconds(150));
+    EXPECT_EQ(wheel.pending(), 0);
+    EXPECT_FALSE(first.isArmed());
+}
+
+TEST_F(TimerWheelTest, testCancel)
+{
+    TimerWheel wheel(event, milliseconds(1));
+    int fired = 0;
+    TimerWheel::Entry entry([&fired]() { ++fired; });
+    {
+        TimerWheel::Entry destroyed([&fired]() { ++fired; });
+        wheel.arm(destroyed, milliseconds(10));
+    }
+    wheel.arm(entry, milliseconds(10));
+    EXPECT_TRUE(entry.isArmed());
+    wheel.cancel(entry);
+    EXPECT_FALSE(entry.isArmed());
+    EXPECT_EQ(wheel.pending(), 0);
+
+    waitEventExpiry(milliseconds(50));
+    EXPECT_EQ(fired, 0);
+}
+
+TEST_F(TimerWheelTest, testRearmFromCallback)
+{
+    TimerWheel wheel(event, milliseconds(1));
+    int fired = 0;
+    TimerWheel::Entry* self = nullptr;
+    TimerWheel::Entry entry([&]() {
+        if (++fired < 3)
+        {
+            wheel.arm(*self, milliseconds(10));
+        }
+    });
+    self = &entry;
+    auto start = steady_clock::now();
+    wheel.arm(entry, milliseconds(10));
+
+    waitEventExpiry(milliseconds(100));
+    EXPECT_EQ(fired, 3);
+    EXPECT_GE(steady_clock::now() - start, milliseconds(3 * 10));
+    EXPECT_EQ(wheel.pending(), 0);
+}
+
+TEST_F(TimerWheelTest, testArmFromLastCallback)
+{
+    // The callback of the last pending entry arms another entry, as the
+    // requester does when an expired request lets the next one be sent
+    TimerWheel wheel(event, milliseconds(1));
+    auto start = steady_clock::now();
+    steady_clock::time_point armed;
+    steady_clock::time_point nextFired;
+    TimerWheel::Entry next([&nextFired]() { nextFired = steady_clock::now(); });
+    TimerWheel::Entry last([&]() {
+        armed = steady_clock::now();
+        wheel.arm(next, milliseconds(30));
+    });
+    wheel.arm(last, milliseconds(100));
+
+    // The event loop gets to the expiry late, several ticks are processed
+    // at once
+    std::this_thread::sleep_for(milliseconds(150));
+    waitEventExpiry(milliseconds(400));
+    EXPECT_GE(armed - start, milliseconds(150));
+    EXPECT_GE(nextFired - armed, milliseconds(30));
+    EXPECT_LT(nextFired - armed, milliseconds(80));
+    EXPECT_EQ(wheel.pending(), 0);
+}
+
+TEST_F(TimerWheelTest, testCascade)
+{
+    // 64 ticks of 1ms fit in level 0, the longer deadline is cascaded down
+    TimerWheel wheel(event, milliseconds(1));
+    std::vector<int> fired;
+    TimerWheel::Entry shortEntry([&fired]() { fired.push_back(1); });
+    TimerWheel::Entry longEntry([&fired]() { fired.push_back(2); });
+
+    auto start = steady_clock::now();
+    steady_clock::time_point longFired;
+    TimerWheel::Entry timed([&]() { longFired = steady_clock::now(); });
+    wheel.arm(longEntry, milliseconds(200));
+    wheel.arm(timed, milliseconds(200));
+    wheel.arm(shortEntry, milliseconds(30));
+
+    waitEventExpiry(milliseconds(300));
+    EXPECT_EQ(fired, (std::vector<int>{1, 2}));
+    EXPECT_GE(longFired - start, milliseconds(200));
+    EXPECT_LT(longFired - start, milliseconds(280));
+}
+
+TEST_F(TimerWheelTest, testHigherLevels)
+{
+    // With 1us ticks a 20ms deadline is placed on level 2
+    TimerWheel wheel(event, microseconds(1));
+    steady_clock::time_point fired;
+    TimerWheel::Entry entry([&fired]() { fired = steady_clock::now(); });
+
+    auto start = steady_clock::now();
+    wheel.arm(entry, milliseconds(20));
+    waitEventExpiry(milliseconds(100));
+    EXPECT_GE(fired - start, milliseconds(20));
+    EXPECT_LT(fired - start, milliseconds(80));
+}
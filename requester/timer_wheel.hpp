@@ -0,0 +1,420 @@
+#pragma once
+
+#include <sdbusplus/timer.hpp>
+#include <sdeventplus/event.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace pldm
+{
+namespace requester
+{
+
+/** @class TimerWheel
+ *
+ *  Hierarchical timing wheel driving the retry and instance ID expiry
+ *  deadlines of the PLDM requests from a single timer source. The wheel has
+ *  4 levels of 64 slots, level 0 holds the deadlines within 64 ticks and each
+ *  next level covers 64 times the range of the previous one, the entries of a
+ *  level are cascaded down when the lower level wraps around. Arming and
+ *  cancelling a deadline is O(1), the entries are intrusive and owned by the
+ *  caller so the wheel does not allocate.
+ *
+ *  The timer source is only armed while deadlines are pending, and then for
+ *  the next occupied slot of level 0 or the next cascade, so an idle wheel or
+ *  a wheel holding long deadlines does not wake up every tick.
+ */
+class TimerWheel
+{
+  private:
+    /** @struct Link
+     *
+     *  Links of the circular intrusive lists of the slots, the list head of
+     *  a slot is a bare Link.
+     */
+    struct Link
+    {
+        Link* prev = this; //!< previous link in the list
+        Link* next = this; //!< next link in the list
+    };
+
+  public:
+    using Callback = std::function<void()>;
+
+    /** @class Entry
+     *
+     *  A deadline on the wheel. The entry is linked into the slot of its
+     *  deadline while it is armed, it is cancelled when it is destroyed.
+     */
+    class Entry : private Link
+    {
+      public:
+        Entry(const Entry&) = delete;
+        Entry(Entry&&) = delete;
+        Entry& operator=(const Entry&) = delete;
+        Entry& operator=(Entry&&) = delete;
+
+        /** @brief Constructor
+         *
+         *  @param[in] callback - invoked on the event loop once the deadline
+         *                        expires
+         */
+        explicit Entry(Callback&& callback) : callback(std::move(callback)) {}
+
+        ~Entry()
+        {
+            if (wheel)
+            {
+                wheel->cancel(*this);
+            }
+        }
+
+        /** @brief Check if the entry is armed
+         *
+         *  @return true if the deadline is pending
+         */
+        bool isArmed() const
+        {
+            return wheel != nullptr;
+        }
+
+      private:
+        friend class TimerWheel;
+
+        TimerWheel* wheel = nullptr; //!< wheel the entry is armed on
+        uint64_t expiry = 0;         //!< tick the deadline expires at
+        Callback callback;           //!< invoked on expiry
+    };
+
+    /** @brief Number of levels of the wheel */
+    static constexpr size_t numLevels = 4;
+
+    /** @brief Number of slots per level, log2 */
+    static constexpr size_t slotBits = 6;
+
+    /** @brief Number of slots per level */
+    static constexpr size_t numSlots = 1 << slotBits;
+
+    TimerWheel() = delete;
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel(TimerWheel&&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    TimerWheel& operator=(TimerWheel&&) = delete;
+    ~TimerWheel() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] event - reference to PLDM daemon's main event loop
+     *  @param[in] resolution - duration of a tick, deadlines are rounded up
+     *                          to it
+     */
+    explicit TimerWheel(
+        sdeventplus::Event& event,
+        std::chrono::microseconds resolution = std::chrono::milliseconds(10)) :
+        resolution(resolution),
+        timer(event.get(), std::bind_front(&TimerWheel::expire, this))
+    {}
+
+    /** @brief Arm a deadline, re-arming an armed entry moves its deadline
+     *
+     *  @param[in] entry - entry of the deadline
+     *  @param[in] timeout - time from now the deadline expires at
+     *
+     *  @throw std::runtime_error if the timer source cannot be armed
+     */
+    void arm(Entry& entry, std::chrono::microseconds timeout)
+    {
+        cancel(entry);
+
+        auto now = std::chrono::steady_clock::now();
+        if (!count && !expiring)
+        {
+            // Restart the tick count from an idle wheel, not from a callback
+            // of expire() which still processes ticks of the current origin
+            origin = now;
+            currentTick = 0;
+        }
+
+        // Round the deadline up to the next tick boundary, so that it never
+        // expires early
+        auto due = std::chrono::duration_cast<std::chrono::microseconds>(
+                       now - origin) +
+                   timeout;
+        auto tick = tickAt(now);
+        auto expiry = static_cast<uint64_t>(std::max<int64_t>(
+            (due.count() + resolution.count() - 1) / resolution.count(), 0));
+        entry.expiry = std::clamp(expiry, tick + 1, tick + maxTicks);
+        entry.wheel = this;
+        ++count;
+        place(entry);
+        schedule(now);
+    }
+
+    /** @brief Cancel a deadline, a no-op if the entry is not armed
+     *
+     *  @param[in] entry - entry of the deadline
+     */
+    void cancel(Entry& entry)
+    {
+        if (entry.wheel != this)
+        {
+            return;
+        }
+        unlink(entry);
+        entry.wheel = nullptr;
+        if (!--count)
+        {
+            timer.stop();
+            scheduledTick = 0;
+        }
+    }
+
+    /** @brief Get the number of armed deadlines
+     *
+     *  @return number of deadlines pending
+     */
+    size_t pending() const
+    {
+        return count;
+    }
+
+  private:
+    using Slot = Link; //!< list head of a slot
+
+    /** @brief Max deadline in ticks the wheel can hold */
+    static constexpr uint64_t maxTicks =
+        (uint64_t{1} << (slotBits * numLevels)) - 1;
+
+    std::chrono::microseconds resolution; //!< duration of a tick
+    phosphor::Timer timer;                //!< timer source of the wheel
+    std::array<std::array<Slot, numSlots>, numLevels> slots; //!< the wheel
+    std::array<uint64_t, numLevels> occupied{}; //!< non-empty slots bitmaps
+    std::chrono::steady_clock::time_point origin; //!< time of tick 0
+    uint64_t currentTick = 0;   //!< last tick processed
+    uint64_t scheduledTick = 0; //!< tick the timer source is armed for
+    size_t count = 0;           //!< number of armed entries
+    bool expiring = false;      //!< set while expire() processes ticks
+
+    /** @brief Get the tick of a time
+     *
+     *  @param[in] time - time point
+     *  @return tick, counted from origin
+     */
+    uint64_t tickAt(std::chrono::steady_clock::time_point time) const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time -
+                                                                     origin)
+                   .count() /
+               resolution.count();
+    }
+
+    /** @brief Link an entry into the slot of its deadline
+     *
+     *  @param[in] entry - armed entry
+     */
+    void place(Entry& entry)
+    {
+        auto delta = entry.expiry > currentTick ? entry.expiry - currentTick
+                                                : 0;
+        size_t level = 0;
+        while (level < numLevels - 1 &&
+               delta >= (uint64_t{1} << (slotBits * (level + 1))))
+        {
+            ++level;
+        }
+        auto index = level == 0 && !delta
+                         ? currentTick & (numSlots - 1)
+                         : (entry.expiry >> (slotBits * level)) &
+                               (numSlots - 1);
+
+        auto& head = slots[level][index];
+        entry.prev = head.prev;
+        entry.next = &head;
+        head.prev->next = &entry;
+        head.prev = &entry;
+        occupied[level] |= uint64_t{1} << index;
+    }
+
+    /** @brief Unlink an entry from its slot
+     *
+     *  @param[in] entry - armed entry
+     */
+    void unlink(Entry& entry)
+    {
+        auto next = entry.next;
+        entry.prev->next = next;
+        next->prev = entry.prev;
+        entry.prev = entry.next = &entry;
+
+        // Every list has a head, so a link left alone is the head of a slot
+        // that is now empty
+        if (next == next->next)
+        {
+            clearOccupied(*next);
+        }
+    }
+
+    /** @brief Clear the occupied bit of an empty slot
+     *
+     *  @param[in] head - list head of the slot
+     */
+    void clearOccupied(const Slot& head)
+    {
+        for (size_t level = 0; level < numLevels; ++level)
+        {
+            if (&head >= slots[level].data() &&
+                &head < slots[level].data() + numSlots)
+            {
+                occupied[level] &= ~(uint64_t{1}
+                                     << (&head - slots[level].data()));
+                return;
+            }
+        }
+    }
+
+    /** @brief Get the next tick the wheel has work at, either an occupied
+     *         slot of level 0 or the next cascade of the higher levels
+     *
+     *  @return tick to process next
+     */
+    uint64_t nextTick() const
+    {
+        auto index = currentTick & (numSlots - 1);
+        auto later = index == numSlots - 1
+                         ? 0
+                         : occupied[0] & (~uint64_t{0} << (index + 1));
+        if (later)
+        {
+            return (currentTick & ~uint64_t{numSlots - 1}) +
+                   std::countr_zero(later);
+        }
+        return (currentTick | (numSlots - 1)) + 1;
+    }
+
+    /** @brief Arm the timer source for the next tick with work, if it isn't
+     *         already armed for an earlier tick
+     *
+     *  @param[in] now - current time
+     */
+    void schedule(std::chrono::steady_clock::time_point now)
+    {
+        if (!count)
+        {
+            return;
+        }
+        auto tick = nextTick();
+        if (scheduledTick && scheduledTick <= tick && timer.isRunning())
+        {
+            return;
+        }
+        auto due = origin + static_cast<int64_t>(tick) * resolution;
+        auto delay = std::max<std::chrono::microseconds>(
+            std::chrono::duration_cast<std::chrono::microseconds>(due - now),
+            std::chrono::microseconds(1));
+        scheduledTick = tick;
+        timer.start(delay);
+    }
+
+    /** @brief Move the entries of a slot of a higher level down the wheel
+     *
+     *  @param[in] level - level of the slot
+     *  @param[in] index - index of the slot
+     */
+    void cascade(size_t level, size_t index)
+    {
+        Slot list;
+        splice(slots[level][index], list);
+        occupied[level] &= ~(uint64_t{1} << index);
+        while (list.next != &list)
+        {
+            auto& entry = static_cast<Entry&>(*list.next);
+            list.next = entry.next;
+            entry.next->prev = &list;
+            place(entry);
+        }
+    }
+
+    /** @brief Move all the entries of a slot to a list
+     *
+     *  @param[in] from - list head of the slot
+     *  @param[out] to - empty list head
+     */
+    static void splice(Slot& from, Slot& to)
+    {
+        if (from.next == &from)
+        {
+            return;
+        }
+        to.next = from.next;
+        to.prev = from.prev;
+        to.next->prev = &to;
+        to.prev->next = &to;
+        from.next = from.prev = &from;
+    }
+
+    /** @brief Timer source callback, processes the ticks up to now */
+    void expire()
+    {
+        scheduledTick = 0;
+        expiring = true;
+        auto now = std::chrono::steady_clock::now();
+        auto target = tickAt(now);
+        while (count && currentTick < target)
+        {
+            auto tick = nextTick();
+            if (tick > target)
+            {
+                currentTick = target;
+                break;
+            }
+            currentTick = tick;
+
+            // Cascade the higher levels whose lower level wrapped around
+            for (size_t level = 1; level < numLevels; ++level)
+            {
+                if (currentTick & ((uint64_t{1} << (slotBits * level)) - 1))
+                {
+                    break;
+                }
+                cascade(level,
+                        (currentTick >> (slotBits * level)) & (numSlots - 1));
+            }
+            run(currentTick & (numSlots - 1));
+        }
+        expiring = false;
+        schedule(std::chrono::steady_clock::now());
+    }
+
+    /** @brief Invoke the callbacks of the expired entries of a level 0 slot
+     *
+     *  @param[in] index - index of the slot
+     */
+    void run(size_t index)
+    {
+        Slot list;
+        splice(slots[0][index], list);
+        occupied[0] &= ~(uint64_t{1} << index);
+        while (list.next != &list)
+        {
+            // A callback may cancel or re-arm any entry, including the ones
+            // still on the list, so take them off one at a time
+            auto& entry = static_cast<Entry&>(*list.next);
+            unlink(entry);
+            entry.wheel = nullptr;
+            --count;
+            entry.callback();
+        }
+        if (!count)
+        {
+            timer.stop();
+        }
+    }
+};
+
+} // namespace requester
+} // namespace pldm
@@ -0,0 +1,388 @@
+#pragma once
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace pldm
+{
+namespace test
+{
+
+/** @struct MctpLink
+ *
+ *  Behaviour of one direction of the MCTP link of MctpMuxStub.
+ */
+struct MctpLink
+{
+    std::chrono::microseconds latency{0}; //!< delay of every message
+    std::chrono::microseconds jitter{0};  //!< max random extra delay
+    double loss = 0.0; //!< probability a message is dropped, 0 to 1
+};
+
+/** @class MctpMuxStub
+ *
+ *  Test-only, in-process stand-in for the mctp-demux-daemon. It listens on an
+ *  abstract unix SOCK_SEQPACKET socket, by default \0mctp-mux, so that pldmd
+ *  or any code using the MCTP socket connects to it unmodified. The host side
+ *  of the MCTP link is one end of a socket pair returned by hostFd(); the
+ *  messages on both sides are framed like on mctp-demux, [EID][MCTP message
+ *  type][PLDM message].
+ *
+ *  The messages are relayed by a thread, each direction applies its own
+ *  latency, jitter and loss. The order of the messages is kept within a
+ *  direction. Messages sent by the host before the client connected are held
+ *  until it connects.
+ */
+class MctpMuxStub
+{
+  public:
+    using Link = MctpLink;
+
+    /** @struct Stats
+     *
+     *  Relayed and dropped messages, per direction.
+     */
+    struct Stats
+    {
+        uint64_t toClient = 0;      //!< messages relayed host to client
+        uint64_t toHost = 0;        //!< messages relayed client to host
+        uint64_t droppedClient = 0; //!< messages lost host to client
+        uint64_t droppedHost = 0;   //!< messages lost client to host
+    };
+
+    MctpMuxStub(const MctpMuxStub&) = delete;
+    MctpMuxStub(MctpMuxStub&&) = delete;
+    MctpMuxStub& operator=(const MctpMuxStub&) = delete;
+    MctpMuxStub& operator=(MctpMuxStub&&) = delete;
+
+    /** @brief Constructor, starts listening and relaying
+     *
+     *  @param[in] name - abstract socket name, without the leading NUL
+     *  @param[in] toClient - link from the host to the client, i.e. pldmd
+     *  @param[in] toHost - link from the client to the host
+     *  @param[in] seed - seed of the loss and jitter random generator
+     *
+     *  @throw std::system_error if the socket cannot be set up
+     */
+    explicit MctpMuxStub(const std::string& name = "mctp-mux",
+                         Link toClient = {}, Link toHost = {},
+                         uint32_t seed = 1) :
+        links{toClient, toHost},
+        random(seed)
+    {
+        listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (listenFd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(),
+                                    "Failed to create the mux socket");
+        }
+
+        struct sockaddr_un addr
+        {};
+        addr.sun_family = AF_UNIX;
+        if (name.size() + 1 > sizeof(addr.sun_path))
+        {
+            cleanup();
+            throw std::invalid_argument("Mux socket name too long");
+        }
+        memcpy(addr.sun_path + 1, name.data(), name.size());
+        auto addrLen = static_cast<socklen_t>(sizeof(addr.sun_family) + 1 +
+                                              name.size());
+        if (bind(listenFd, reinterpret_cast<struct sockaddr*>(&addr),
+                 addrLen) < 0 ||
+            listen(listenFd, 1) < 0)
+        {
+            auto err = errno;
+            cleanup();
+            throw std::system_error(err, std::generic_category(),
+                                    "Failed to listen on the mux socket");
+        }
+
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, pair) < 0)
+        {
+            auto err = errno;
+            cleanup();
+            throw std::system_error(err, std::generic_category(),
+                                    "Failed to create the host socket pair");
+        }
+        hostEnd = pair[0];
+        muxEnd = pair[1];
+        // The relay must not block on a host that doesn't read
+        fcntl(muxEnd, F_SETFL, fcntl(muxEnd, F_GETFL) | O_NONBLOCK);
+
+        stopFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (stopFd < 0)
+        {
+            auto err = errno;
+            cleanup();
+            throw std::system_error(err, std::generic_category(),
+                                    "Failed to create the stop eventfd");
+        }
+
+        relay = std::thread(&MctpMuxStub::run, this);
+    }
+
+    ~MctpMuxStub()
+    {
+        uint64_t one = 1;
+        if (::write(stopFd, &one, sizeof(one)) < 0)
+        {
+            // The relay thread still exits on the next message or timeout
+        }
+        relay.join();
+        cleanup();
+    }
+
+    /** @brief Get the host end of the MCTP link
+     *
+     *  @return fd of the host socket, owned by the stub
+     */
+    int hostFd() const
+    {
+        return hostEnd;
+    }
+
+    /** @brief Wait for a client to connect and to register its MCTP message
+     *         type
+     *
+     *  @param[in] timeout - maximum time to wait
+     *  @return true if a client is connected
+     */
+    bool waitForClient(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(clientLock);
+        return clientCv.wait_for(lock, timeout,
+                                 [this]() { return clientReady; });
+    }
+
+    /** @brief Get the relay statistics
+     *
+     *  @return copy of the statistics
+     */
+    Stats getStats() const
+    {
+        std::lock_guard<std::mutex> guard(statsLock);
+        return stats;
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    /** @struct Pending
+     *
+     *  A message waiting for its delivery time.
+     */
+    struct Pending
+    {
+        Clock::time_point due;    //!< time to deliver the message
+        std::vector<uint8_t> msg; //!< framed MCTP message
+    };
+
+    /** @brief Directions of the link */
+    enum Direction
+    {
+        ToClient = 0,
+        ToHost = 1,
+    };
+
+    Link links[2];                    //!< behaviour of each direction
+    std::deque<Pending> pending[2];   //!< messages in flight per direction
+    std::mt19937 random;              //!< loss and jitter generator
+    int listenFd = -1;                //!< listening mux socket
+    int clientFd = -1;                //!< connected client, i.e. pldmd
+    int hostEnd = -1;                 //!< host end of the socket pair
+    int muxEnd = -1;                  //!< stub end of the socket pair
+    int stopFd = -1;                  //!< signals the relay thread to exit
+    std::thread relay;                //!< relay thread
+    std::mutex clientLock;            //!< protects clientReady
+    std::condition_variable clientCv; //!< signals clientReady
+    bool clientReady = false;         //!< client sent its message type
+    mutable std::mutex statsLock;     //!< protects stats
+    Stats stats;                      //!< relay statistics
+
+    /** @brief Close all the fds */
+    void cleanup()
+    {
+        for (auto fd : {listenFd, clientFd, hostEnd, muxEnd, stopFd})
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+        listenFd = clientFd = hostEnd = muxEnd = stopFd = -1;
+    }
+
+    /** @brief Queue a message for delivery, or drop it as per the link loss
+     *
+     *  @param[in] dir - direction of the message
+     *  @param[in] msg - framed MCTP message
+     */
+    void enqueue(Direction dir, std::vector<uint8_t>&& msg)
+    {
+        const auto& link = links[dir];
+        if (link.loss > 0 &&
+            std::uniform_real_distribution<double>(0, 1)(random) < link.loss)
+        {
+            std::lock_guard<std::mutex> guard(statsLock);
+            ++(dir == ToClient ? stats.droppedClient : stats.droppedHost);
+            return;
+        }
+
+        auto delay = link.latency;
+        if (link.jitter.count() > 0)
+        {
+            delay += std::chrono::microseconds(
+                std::uniform_int_distribution<int64_t>(
+                    0, link.jitter.count())(random));
+        }
+        // Keep the order of the messages within the direction
+        auto due = Clock::now() + delay;
+        if (!pending[dir].empty() && pending[dir].back().due > due)
+        {
+            due = pending[dir].back().due;
+        }
+        pending[dir].push_back({due, std::move(msg)});
+    }
+
+    /** @brief Deliver the messages that are due
+     *
+     *  @return time to wait for the next message, -1 if none is pending
+     */
+    int deliver()
+    {
+        int timeoutMs = -1;
+        auto now = Clock::now();
+        for (auto dir : {ToClient, ToHost})
+        {
+            // Like mctp-demux, nothing is routed to the client before it
+            // registered its message type
+            auto fd = dir == ToHost ? muxEnd : (clientReady ? clientFd : -1);
+            auto& queue = pending[dir];
+            while (!queue.empty() && fd >= 0)
+            {
+                if (queue.front().due > now)
+                {
+                    auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+                                    queue.front().due - now)
+                                    .count();
+                    if (timeoutMs < 0 || wait < timeoutMs)
+                    {
+                        timeoutMs = static_cast<int>(wait);
+                    }
+                    break;
+                }
+                const auto& msg = queue.front().msg;
+                if (send(fd, msg.data(), msg.size(), MSG_NOSIGNAL) < 0 &&
+                    (errno == EAGAIN || errno == EWOULDBLOCK))
+                {
+                    timeoutMs = 1;
+                    break;
+                }
+                {
+                    std::lock_guard<std::mutex> guard(statsLock);
+                    ++(dir == ToClient ? stats.toClient : stats.toHost);
+                }
+                queue.pop_front();
+            }
+        }
+        return timeoutMs;
+    }
+
+    /** @brief Receive a message
+     *
+     *  @param[in] fd - socket to receive from
+     *  @param[out] msg - received message
+     *  @return false if the peer closed the socket or on an error
+     */
+    static bool receive(int fd, std::vector<uint8_t>& msg)
+    {
+        auto peeked = recv(fd, nullptr, 0, MSG_PEEK | MSG_TRUNC);
+        if (peeked <= 0)
+        {
+            return false;
+        }
+        msg.resize(peeked);
+        return recv(fd, msg.data(), msg.size(), 0) == peeked;
+    }
+
+    /** @brief Relay thread */
+    void run()
+    {
+        std::vector<uint8_t> msg;
+        while (true)
+        {
+            auto timeoutMs = deliver();
+
+            struct pollfd fds[3] = {
+                {stopFd, POLLIN, 0},
+                {muxEnd, POLLIN, 0},
+                {clientFd >= 0 ? clientFd : listenFd, POLLIN, 0}};
+            if (poll(fds, 3, timeoutMs) < 0 && errno != EINTR)
+            {
+                return;
+            }
+            if (fds[0].revents)
+            {
+                return;
+            }
+
+            if (fds[1].revents & POLLIN)
+            {
+                if (receive(muxEnd, msg))
+                {
+                    enqueue(ToClient, std::move(msg));
+                }
+            }
+
+            if (clientFd < 0 && (fds[2].revents & POLLIN))
+            {
+                clientFd = accept4(listenFd, nullptr, nullptr,
+                                   SOCK_CLOEXEC | SOCK_NONBLOCK);
+            }
+            else if (fds[2].revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                if (!receive(clientFd, msg))
+                {
+                    // Client went away, accept the next one
+                    close(clientFd);
+                    clientFd = -1;
+                    std::lock_guard<std::mutex> guard(clientLock);
+                    clientReady = false;
+                }
+                else if (!clientReady && msg.size() == 1)
+                {
+                    // The first message registers the MCTP message type
+                    std::lock_guard<std::mutex> guard(clientLock);
+                    clientReady = true;
+                    clientCv.notify_all();
+                }
+                else
+                {
+                    enqueue(ToHost, std::move(msg));
+                }
+            }
+        }
+    }
+};
+
+} // namespace test
+} // namespace pldm
@@ -37,3 +37,37 @@ TEST(InstanceId, testMarkfree)
     EXPECT_THROW(id.next(), std::runtime_error);
     EXPECT_THROW(id.markFree(32), std::out_of_range);
 }
+
+TEST(InstanceId, testRoundRobin)
+{
+    InstanceId id;
+    ASSERT_EQ(id.next(), 0);
+    ASSERT_EQ(id.next(), 1);
+    id.markFree(0);
+    // A freed id is not handed out again before the others
+    ASSERT_EQ(id.next(), 2);
+    for (size_t i = 3; i < maxInstanceIds; ++i)
+    {
+        ASSERT_EQ(id.next(), i);
+    }
+    // Wraps around to the free ones
+    ASSERT_EQ(id.next(), 0);
+    id.markFree(30);
+    id.markFree(1);
+    ASSERT_EQ(id.next(), 1);
+    ASSERT_EQ(id.next(), 30);
+}
+
+TEST(InstanceId, testTryNext)
+{
+    InstanceId id;
+    for (size_t i = 0; i < maxInstanceIds; ++i)
+    {
+        ASSERT_EQ(id.tryNext(), i);
+    }
+    EXPECT_EQ(id.tryNext(), std::nullopt);
+    // None of the ids is older than the expiration interval
+    EXPECT_EQ(id.returnOldestId(), std::nullopt);
+    id.markFree(7);
+    EXPECT_EQ(id.tryNext(), 7);
+}
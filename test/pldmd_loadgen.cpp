@@ -0,0 +1,491 @@
+#include "libpldm/base.h"
+#include "libpldm/platform.h"
+
+#include "test/mctp_mux_stub.hpp"
+
+#ifdef OEM_IBM
+#include "libpldm/file_io.h"
+#endif
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <CLI/CLI.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+using namespace pldm::test;
+
+namespace
+{
+
+constexpr uint8_t mctpMsgTypePldm = 1;
+
+/** @brief Number of PLDM instance IDs */
+constexpr size_t numInstanceIds = 32;
+
+/** @struct Scenario
+ *
+ *  A kind of scripted host traffic and its results.
+ */
+struct Scenario
+{
+    std::string name; //!< name of the scenario in the report
+    std::function<std::vector<uint8_t>(uint8_t)> request; //!< encodes one
+    std::function<void(const pldm_msg*, size_t)> response; //!< parses it
+    uint64_t sent = 0;               //!< requests sent
+    uint64_t errors = 0;             //!< responses with a non success cc
+    uint64_t timeouts = 0;           //!< requests without a response
+    std::vector<uint32_t> latencies; //!< response latencies in us
+};
+
+/** @struct Outstanding
+ *
+ *  A request waiting for its response, per instance ID.
+ */
+struct Outstanding
+{
+    bool busy = false;               //!< instance ID in use
+    size_t scenario = 0;             //!< index of the scenario
+    steady_clock::time_point sentAt; //!< time the request was sent
+};
+
+/** @brief Get a percentile of sorted latencies
+ *
+ *  @param[in] sorted - latencies in ascending order
+ *  @param[in] pct - percentile, 0 to 100
+ *  @return latency at the percentile, 0 if there is none
+ */
+uint32_t percentile(const std::vector<uint32_t>& sorted, size_t pct)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    return sorted[std::min(sorted.size() - 1, sorted.size() * pct / 100)];
+}
+
+/** @brief Build the GetPDR scenario, it walks the PDR repository from the
+ *         first record to the last one and starts over
+ */
+Scenario pdrWalk()
+{
+    auto nextHandle = std::make_shared<uint32_t>(0);
+    Scenario scenario;
+    scenario.name = "pdr";
+    scenario.request = [nextHandle](uint8_t instanceId) {
+        std::vector<uint8_t> msg(sizeof(pldm_msg_hdr) +
+                                 PLDM_GET_PDR_REQ_BYTES);
+        encode_get_pdr_req(instanceId, *nextHandle, 0, PLDM_GET_FIRSTPART,
+                           UINT16_MAX, 0,
+                           reinterpret_cast<pldm_msg*>(msg.data()),
+                           PLDM_GET_PDR_REQ_BYTES);
+        return msg;
+    };
+    scenario.response = [nextHandle](const pldm_msg* response,
+                                     size_t payloadLength) {
+        uint8_t completionCode{};
+        uint32_t nextRecordHandle{};
+        uint32_t nextDataTransferHandle{};
+        uint8_t transferFlag{};
+        uint16_t respCount{};
+        uint8_t transferCRC{};
+        if (decode_get_pdr_resp(response, payloadLength, &completionCode,
+                                &nextRecordHandle, &nextDataTransferHandle,
+                                &transferFlag, &respCount, nullptr, 0,
+                                &transferCRC) != PLDM_SUCCESS ||
+            completionCode != PLDM_SUCCESS)
+        {
+            nextRecordHandle = 0;
+        }
+        *nextHandle = nextRecordHandle;
+    };
+    return scenario;
+}
+
+/** @brief Build the GetStateSensorReadings scenario
+ *
+ *  @param[in] sensorId - sensor polled
+ */
+Scenario sensorPoll(uint16_t sensorId)
+{
+    Scenario scenario;
+    scenario.name = "sensor";
+    scenario.request = [sensorId](uint8_t instanceId) {
+        std::vector<uint8_t> msg(sizeof(pldm_msg_hdr) +
+                                 PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES);
+        bitfield8_t rearm{};
+        encode_get_state_sensor_readings_req(
+            instanceId, sensorId, rearm, 0,
+            reinterpret_cast<pldm_msg*>(msg.data()));
+        return msg;
+    };
+    return scenario;
+}
+
+/** @brief Build the PlatformEventMessage scenario, the host reports a state
+ *         sensor event
+ *
+ *  @param[in] sensorId - sensor of the events
+ */
+Scenario sensorEvent(uint16_t sensorId)
+{
+    Scenario scenario;
+    scenario.name = "event";
+    scenario.request = [sensorId](uint8_t instanceId) {
+        // sensorID, sensorEventClassType, sensorOffset, eventState,
+        // previousEventState
+        std::array<uint8_t, 6> eventData{
+            static_cast<uint8_t>(sensorId & 0xFF),
+            static_cast<uint8_t>(sensorId >> 8),
+            PLDM_STATE_SENSOR_STATE,
+            0,
+            1,
+            0};
+        std::vector<uint8_t> msg(sizeof(pldm_msg_hdr) +
+                                 PLDM_PLATFORM_EVENT_MESSAGE_MIN_REQ_BYTES +
+                                 eventData.size());
+        encode_platform_event_message_req(
+            instanceId, 1, 0, PLDM_SENSOR_EVENT, eventData.data(),
+            eventData.size(), reinterpret_cast<pldm_msg*>(msg.data()),
+            msg.size() - sizeof(pldm_msg_hdr));
+        return msg;
+    };
+    return scenario;
+}
+
+#ifdef OEM_IBM
+/** @brief Build the GetFileTable scenario */
+Scenario fileTable()
+{
+    Scenario scenario;
+    scenario.name = "file";
+    scenario.request = [](uint8_t instanceId) {
+        std::vector<uint8_t> msg(sizeof(pldm_msg_hdr) +
+                                 PLDM_GET_FILE_TABLE_REQ_BYTES);
+        encode_get_file_table_req(instanceId, 0, PLDM_GET_FIRSTPART, 0,
+                                  reinterpret_cast<pldm_msg*>(msg.data()));
+        return msg;
+    };
+    return scenario;
+}
+#endif
+
+/** @class LoadGenerator
+ *
+ *  Drives pldmd over the MCTP mux stand-in with scripted host traffic, keeping
+ *  a number of requests outstanding, and accounts the response latencies.
+ *  Requests pldmd sends to the host are answered with
+ *  PLDM_ERROR_UNSUPPORTED_PLDM_CMD so that it does not keep retrying them.
+ */
+class LoadGenerator
+{
+  public:
+    LoadGenerator(int fd, uint8_t eid, size_t concurrency,
+                  milliseconds timeout, std::vector<Scenario>&& scenarios) :
+        fd(fd),
+        eid(eid), concurrency(std::clamp<size_t>(concurrency, 1,
+                                                 numInstanceIds)),
+        timeout(timeout), scenarios(std::move(scenarios))
+    {}
+
+    /** @brief Run the traffic
+     *
+     *  @param[in] duration - time to send requests for
+     */
+    void run(seconds duration)
+    {
+        auto start = steady_clock::now();
+        auto deadline = start + duration;
+        while (true)
+        {
+            auto now = steady_clock::now();
+            expire(now);
+            while (now < deadline && inFlight < concurrency)
+            {
+                sendNext(now);
+            }
+            if (now >= deadline && !inFlight)
+            {
+                break;
+            }
+
+            struct pollfd pfd = {fd, POLLIN, 0};
+            if (poll(&pfd, 1, 10) > 0)
+            {
+                receive();
+            }
+        }
+        elapsed = steady_clock::now() - start;
+    }
+
+    /** @brief Print the throughput and the latency percentiles */
+    void report()
+    {
+        uint64_t responses = 0;
+        std::vector<uint32_t> all;
+        std::cout << std::left << std::setw(10) << "scenario" << std::right
+                  << std::setw(10) << "sent" << std::setw(10) << "errors"
+                  << std::setw(10) << "timeouts" << std::setw(10) << "p50_us"
+                  << std::setw(10) << "p99_us" << std::setw(10) << "max_us"
+                  << "\n";
+        for (auto& scenario : scenarios)
+        {
+            auto& latencies = scenario.latencies;
+            std::sort(latencies.begin(), latencies.end());
+            responses += latencies.size();
+            all.insert(all.end(), latencies.begin(), latencies.end());
+            std::cout << std::left << std::setw(10) << scenario.name
+                      << std::right << std::setw(10) << scenario.sent
+                      << std::setw(10) << scenario.errors << std::setw(10)
+                      << scenario.timeouts << std::setw(10)
+                      << percentile(latencies, 50) << std::setw(10)
+                      << percentile(latencies, 99) << std::setw(10)
+                      << (latencies.empty() ? 0 : latencies.back()) << "\n";
+        }
+        std::sort(all.begin(), all.end());
+
+        auto secs = duration<double>(elapsed).count();
+        std::cout << "responses: " << responses << " in " << secs << "s, "
+                  << (secs > 0 ? responses / secs : 0) << " responses/s\n"
+                  << "latency p50: " << percentile(all, 50)
+                  << "us p99: " << percentile(all, 99) << "us\n"
+                  << "requests from pldmd answered: " << pldmdRequests
+                  << "\n";
+    }
+
+  private:
+    int fd;                          //!< host end of the MCTP link
+    uint8_t eid;                     //!< EID of the host
+    size_t concurrency;              //!< max number of outstanding requests
+    milliseconds timeout;            //!< time to wait for a response
+    std::vector<Scenario> scenarios; //!< traffic mix
+    std::array<Outstanding, numInstanceIds> requests; //!< by instance ID
+    size_t inFlight = 0;              //!< outstanding requests
+    uint8_t nextInstanceId = 0;       //!< next instance ID to try
+    size_t nextScenario = 0;          //!< next scenario to send
+    uint64_t pldmdRequests = 0;       //!< requests from pldmd answered
+    steady_clock::duration elapsed{}; //!< duration of the run
+
+    /** @brief Send a framed PLDM message to pldmd
+     *
+     *  @param[in] msg - PLDM message
+     */
+    void sendMsg(const std::vector<uint8_t>& msg)
+    {
+        std::vector<uint8_t> framed{eid, mctpMsgTypePldm};
+        framed.insert(framed.end(), msg.begin(), msg.end());
+        if (send(fd, framed.data(), framed.size(), 0) < 0)
+        {
+            std::cerr << "Failed to send the request, errno = " << errno
+                      << "\n";
+        }
+    }
+
+    /** @brief Send the request of the next scenario */
+    void sendNext(steady_clock::time_point now)
+    {
+        while (requests[nextInstanceId].busy)
+        {
+            nextInstanceId = (nextInstanceId + 1) % numInstanceIds;
+        }
+        auto instanceId = nextInstanceId;
+        nextInstanceId = (nextInstanceId + 1) % numInstanceIds;
+
+        auto& scenario = scenarios[nextScenario];
+        requests[instanceId] = {true, nextScenario, now};
+        nextScenario = (nextScenario + 1) % scenarios.size();
+        ++inFlight;
+        ++scenario.sent;
+        sendMsg(scenario.request(instanceId));
+    }
+
+    /** @brief Give up on the requests without a response in time */
+    void expire(steady_clock::time_point now)
+    {
+        for (auto& request : requests)
+        {
+            if (request.busy && now - request.sentAt > timeout)
+            {
+                request.busy = false;
+                --inFlight;
+                ++scenarios[request.scenario].timeouts;
+            }
+        }
+    }
+
+    /** @brief Receive a message from pldmd */
+    void receive()
+    {
+        std::array<uint8_t, 4096> buffer;
+        auto rc = recv(fd, buffer.data(), buffer.size(), 0);
+        auto now = steady_clock::now();
+        if (rc < static_cast<ssize_t>(2 + sizeof(pldm_msg_hdr)) ||
+            buffer[1] != mctpMsgTypePldm)
+        {
+            return;
+        }
+        auto msg = reinterpret_cast<const pldm_msg*>(buffer.data() + 2);
+        size_t payloadLength = rc - 2 - sizeof(pldm_msg_hdr);
+
+        if (msg->hdr.request)
+        {
+            std::vector<uint8_t> response(sizeof(pldm_msg_hdr) + 1);
+            encode_cc_only_resp(msg->hdr.instance_id, msg->hdr.type,
+                                msg->hdr.command,
+                                PLDM_ERROR_UNSUPPORTED_PLDM_CMD,
+                                reinterpret_cast<pldm_msg*>(response.data()));
+            sendMsg(response);
+            ++pldmdRequests;
+            return;
+        }
+
+        auto& request = requests[msg->hdr.instance_id];
+        if (!request.busy)
+        {
+            // Late response to a timed out request
+            return;
+        }
+        request.busy = false;
+        --inFlight;
+
+        auto& scenario = scenarios[request.scenario];
+        scenario.latencies.push_back(static_cast<uint32_t>(
+            duration_cast<microseconds>(now - request.sentAt).count()));
+        if (!payloadLength || msg->payload[0] != PLDM_SUCCESS)
+        {
+            ++scenario.errors;
+        }
+        if (scenario.response)
+        {
+            scenario.response(msg, payloadLength);
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    CLI::App app{"Drive pldmd with scripted host traffic over an in-process "
+                 "MCTP mux and report throughput and latency"};
+    std::string pldmd;
+    app.add_option("--pldmd", pldmd,
+                   "pldmd executable to start once the mux listens, otherwise "
+                   "wait for a pldmd started by hand");
+    std::string muxName = "mctp-mux";
+    app.add_option("--mux-name", muxName, "Abstract socket name of the mux");
+    uint8_t eid = 9;
+    app.add_option("-m,--mctp_eid", eid, "MCTP EID of the host");
+    unsigned durationSecs = 10;
+    app.add_option("-d,--duration", durationSecs, "Seconds of traffic");
+    size_t concurrency = 1;
+    app.add_option("-c,--concurrency", concurrency,
+                   "Outstanding requests, at most 32");
+    unsigned timeoutMs = 1000;
+    app.add_option("--timeout", timeoutMs, "Response timeout in milliseconds");
+    std::vector<std::string> mix{"pdr", "sensor"};
+    app.add_option("-s,--scenario", mix,
+                   "Traffic mix: pdr, sensor, event"
+#ifdef OEM_IBM
+                   ", file"
+#endif
+    );
+    uint16_t sensorId = 1;
+    app.add_option("--sensor-id", sensorId, "Sensor of the sensor scenarios");
+    unsigned latencyUs = 0;
+    app.add_option("--latency", latencyUs, "Link latency in microseconds");
+    unsigned jitterUs = 0;
+    app.add_option("--jitter", jitterUs, "Link jitter in microseconds");
+    double loss = 0.0;
+    app.add_option("--loss", loss, "Probability a message is lost, 0 to 1");
+    CLI11_PARSE(app, argc, argv);
+
+    std::vector<Scenario> scenarios;
+    for (const auto& name : mix)
+    {
+        if (name == "pdr")
+        {
+            scenarios.push_back(pdrWalk());
+        }
+        else if (name == "sensor")
+        {
+            scenarios.push_back(sensorPoll(sensorId));
+        }
+        else if (name == "event")
+        {
+            scenarios.push_back(sensorEvent(sensorId));
+        }
+#ifdef OEM_IBM
+        else if (name == "file")
+        {
+            scenarios.push_back(fileTable());
+        }
+#endif
+        else
+        {
+            std::cerr << "Unknown scenario " << name << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+    if (scenarios.empty())
+    {
+        std::cerr << "No scenario to run\n";
+        return EXIT_FAILURE;
+    }
+
+    MctpLink link{microseconds(latencyUs), microseconds(jitterUs), loss};
+    MctpMuxStub mux(muxName, link, link);
+
+    pid_t child = -1;
+    if (!pldmd.empty())
+    {
+        child = fork();
+        if (child == 0)
+        {
+            execl(pldmd.c_str(), pldmd.c_str(), nullptr);
+            _exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!mux.waitForClient(seconds(30)))
+    {
+        std::cerr << "pldmd did not connect to the mux\n";
+        if (child > 0)
+        {
+            kill(child, SIGTERM);
+            waitpid(child, nullptr, 0);
+        }
+        return EXIT_FAILURE;
+    }
+
+    LoadGenerator generator(mux.hostFd(), eid, concurrency,
+                            milliseconds(timeoutMs), std::move(scenarios));
+    generator.run(seconds(durationSecs));
+    generator.report();
+
+    auto stats = mux.getStats();
+    std::cout << "mux: relayed " << stats.toClient << "/" << stats.toHost
+              << " dropped " << stats.droppedClient << "/"
+              << stats.droppedHost << " (to pldmd/to host)\n";
+
+    if (child > 0)
+    {
+        kill(child, SIGTERM);
+        waitpid(child, nullptr, 0);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+#include "test/mctp_mux_stub.hpp"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::test;
+using namespace std::chrono;
+
+class MctpMuxStubTest : public testing::Test
+{
+  protected:
+    ~MctpMuxStubTest()
+    {
+        if (clientFd >= 0)
+        {
+            close(clientFd);
+        }
+    }
+
+    /** @brief Mux socket name unique to the test process */
+    const std::string name = "pldm-test-mux-" + std::to_string(getpid());
+
+    int clientFd = -1;
+
+    /** @brief Connect to the stub and register PLDM like pldmd does */
+    void connectClient()
+    {
+        clientFd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        ASSERT_GE(clientFd, 0);
+        struct sockaddr_un addr
+        {};
+        addr.sun_family = AF_UNIX;
+        memcpy(addr.sun_path + 1, name.data(), name.size());
+        ASSERT_EQ(connect(clientFd, reinterpret_cast<struct sockaddr*>(&addr),
+                          sizeof(addr.sun_family) + 1 + name.size()),
+                  0);
+        uint8_t type = 1;
+        ASSERT_EQ(write(clientFd, &type, sizeof(type)), 1);
+    }
+
+    /** @brief Receive a message
+     *
+     *  @param[in] fd - socket to receive from
+     *  @param[in] timeout - maximum time to wait for the message
+     *  @return received message, empty on a timeout
+     */
+    static std::vector<uint8_t> receive(int fd, milliseconds timeout)
+    {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, timeout.count()) <= 0)
+        {
+            return {};
+        }
+        std::vector<uint8_t> msg(1024);
+        auto rc = recv(fd, msg.data(), msg.size(), 0);
+        msg.resize(rc < 0 ? 0 : rc);
+        return msg;
+    }
+};
+
+TEST_F(MctpMuxStubTest, testRelay)
+{
+    MctpMuxStub mux(name);
+    connectClient();
+    ASSERT_TRUE(mux.waitForClient(milliseconds(1000)));
+
+    std::vector<uint8_t> request{9, 1, 0x80, 0x00, 0x02};
+    ASSERT_EQ(send(mux.hostFd(), request.data(), request.size(), 0),
+              static_cast<ssize_t>(request.size()));
+    EXPECT_EQ(receive(clientFd, milliseconds(1000)), request);
+
+    std::vector<uint8_t> response{9, 1, 0x00, 0x00, 0x02, 0x00, 0x01};
+    ASSERT_EQ(send(clientFd, response.data(), response.size(), 0),
+              static_cast<ssize_t>(response.size()));
+    EXPECT_EQ(receive(mux.hostFd(), milliseconds(1000)), response);
+
+    auto stats = mux.getStats();
+    EXPECT_EQ(stats.toClient, 1);
+    EXPECT_EQ(stats.toHost, 1);
+}
+
+TEST_F(MctpMuxStubTest, testLatencyKeepsOrder)
+{
+    MctpMuxStub mux(name, {milliseconds(30), milliseconds(10), 0.0});
+    connectClient();
+    ASSERT_TRUE(mux.waitForClient(milliseconds(1000)));
+
+    auto start = steady_clock::now();
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        std::vector<uint8_t> request{9, 1, 0x80, 0x00, 0x02, i};
+        ASSERT_EQ(send(mux.hostFd(), request.data(), request.size(), 0),
+                  static_cast<ssize_t>(request.size()));
+    }
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        auto msg = receive(clientFd, milliseconds(1000));
+        ASSERT_EQ(msg.size(), 6);
+        EXPECT_EQ(msg[5], i);
+    }
+    EXPECT_GE(steady_clock::now() - start, milliseconds(30));
+}
+
+TEST_F(MctpMuxStubTest, testLoss)
+{
+    MctpMuxStub mux(name, {microseconds(0), microseconds(0), 1.0});
+    connectClient();
+    ASSERT_TRUE(mux.waitForClient(milliseconds(1000)));
+
+    std::vector<uint8_t> request{9, 1, 0x80, 0x00, 0x02};
+    ASSERT_EQ(send(mux.hostFd(), request.data(), request.size(), 0),
+              static_cast<ssize_t>(request.size()));
+    EXPECT_TRUE(receive(clientFd, milliseconds(50)).empty());
+    EXPECT_EQ(mux.getStats().droppedClient, 1);
+    EXPECT_EQ(mux.getStats().toClient, 0);
+}
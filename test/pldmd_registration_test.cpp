@@ -9,7 +9,7 @@
 using namespace pldm;
 using namespace pldm::responder;
 constexpr Command testCmd = 0xFF;
-constexpr Type testType = 0xFF;
+constexpr Type testType = PLDM_OEM;
 
 class TestHandler : public CmdHandler
 {
@@ -28,6 +28,22 @@ class TestHandler : public CmdHandler
     }
 };
 
+class TestDeferredHandler : public CmdHandler
+{
+  public:
+    TestDeferredHandler()
+    {
+        deferredHandlers.emplace(
+            testCmd, [this](const pldm_msg* /*request*/,
+                            size_t /*payloadLength*/,
+                            ResponseCompletion&& complete) {
+            pending = std::move(complete);
+        });
+    }
+
+    ResponseCompletion pending;
+};
+
 TEST(CcOnlyResponse, testEncode)
 {
     std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
@@ -50,11 +66,92 @@ TEST(Registration, testSuccess)
 
 TEST(Registration, testFailure)
 {
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    encode_get_types_req(0, request);
+    std::vector<uint8_t> expectMsg = {0, 0, 4, PLDM_ERROR_UNSUPPORTED_PLDM_CMD};
+
     Invoker invoker{};
-    ASSERT_THROW(invoker.handle(testType, testCmd, nullptr, 0),
-                 std::out_of_range);
+    EXPECT_EQ(invoker.handle(testType, testCmd, request, 0), expectMsg);
     invoker.registerHandler(testType, std::make_unique<TestHandler>());
     uint8_t badCmd = 0xFE;
-    ASSERT_THROW(invoker.handle(testType, badCmd, nullptr, 0),
-                 std::out_of_range);
+    EXPECT_EQ(invoker.handle(testType, badCmd, request, 0), expectMsg);
+    Type badType = 0xFE;
+    EXPECT_EQ(invoker.handle(badType, testCmd, request, 0), expectMsg);
+    EXPECT_THROW(
+        invoker.registerHandler(badType, std::make_unique<TestHandler>()),
+        std::out_of_range);
+}
+
+TEST(ResponsePool, testAcquireZeroFilled)
+{
+    auto& pool = ResponsePool::getInstance();
+    Response response = pool.acquire(8);
+    std::fill(response.begin(), response.end(), 0xFF);
+    pool.release(std::move(response));
+
+    auto reused = pool.acquire(4);
+    std::vector<uint8_t> expectMsg(4, 0);
+    EXPECT_EQ(reused, expectMsg);
+    EXPECT_GE(reused.capacity(), ResponsePool::defaultCapacity);
+}
+
+TEST(ResponsePool, testCapacityReused)
+{
+    auto& pool = ResponsePool::getInstance();
+    auto response = CmdHandler::allocResponse(sizeof(pldm_msg_hdr));
+    response.resize(8192);
+    auto data = response.data();
+    pool.release(std::move(response));
+
+    auto reused = CmdHandler::allocResponse(sizeof(pldm_msg_hdr));
+    reused.resize(8192);
+    EXPECT_EQ(reused.data(), data);
+}
+
+TEST(ResponsePool, testDroppedBuffers)
+{
+    auto& pool = ResponsePool::getInstance();
+    for (size_t i = 0; i < 2 * ResponsePool::maxBuffers; ++i)
+    {
+        // Dropped without being released, as for an error response
+        auto response = pool.acquire(sizeof(pldm_msg_hdr));
+    }
+
+    std::vector<Response> responses;
+    for (size_t i = 0; i < 2 * ResponsePool::maxBuffers; ++i)
+    {
+        responses.emplace_back(pool.acquire(sizeof(pldm_msg_hdr)));
+        EXPECT_GE(responses.back().capacity(), ResponsePool::defaultCapacity);
+    }
+    for (auto& response : responses)
+    {
+        pool.release(std::move(response));
+    }
+}
+
+TEST(Registration, testDeferred)
+{
+    Invoker invoker{};
+    auto handler = std::make_unique<TestDeferredHandler>();
+    auto deferred = handler.get();
+    invoker.registerHandler(testType, std::move(handler));
+
+    Response sent{};
+    auto complete = [&sent](Response&& response) { sent = response; };
+    ASSERT_TRUE(
+        invoker.handleDeferred(testType, testCmd, nullptr, 0, complete));
+    EXPECT_TRUE(sent.empty());
+
+    ASSERT_TRUE(deferred->pending);
+    deferred->pending({100, 200});
+    Response expectMsg = {100, 200};
+    EXPECT_EQ(sent, expectMsg);
+
+    uint8_t syncCmd = 0xFE;
+    EXPECT_FALSE(
+        invoker.handleDeferred(testType, syncCmd, nullptr, 0, complete));
+    Type badType = 0xFE;
+    EXPECT_FALSE(
+        invoker.handleDeferred(badType, testCmd, nullptr, 0, complete));
 }
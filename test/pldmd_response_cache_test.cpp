@@ -0,0 +1,123 @@
+#include "libpldm/base.h"
+#include "libpldm/platform.h"
+
+#include "pldmd/response_cache.hpp"
+
+#include <chrono>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::responder;
+using namespace std::chrono;
+
+class ResponseCacheTest : public testing::Test
+{
+  protected:
+    /** @brief Build a GetPDR-like request with the given instance ID */
+    static std::vector<uint8_t> makeRequest(uint8_t instanceId,
+                                            uint8_t payload = 0)
+    {
+        std::vector<uint8_t> request(sizeof(pldm_msg_hdr) + 1);
+        pldm_header_info header{};
+        header.msg_type = PLDM_REQUEST;
+        header.instance = instanceId;
+        header.pldm_type = PLDM_PLATFORM;
+        header.command = PLDM_GET_PDR;
+        pack_pldm_header(&header, reinterpret_cast<pldm_msg_hdr*>(
+                                      request.data()));
+        request.back() = payload;
+        return request;
+    }
+
+    const std::vector<uint8_t> response{0x01, PLDM_PLATFORM, PLDM_GET_PDR,
+                                        PLDM_SUCCESS, 0xAA, 0xBB};
+};
+
+TEST_F(ResponseCacheTest, testCacheable)
+{
+    EXPECT_TRUE(ResponseCache::isCacheable(PLDM_PLATFORM, PLDM_GET_PDR));
+    EXPECT_FALSE(ResponseCache::isCacheable(PLDM_PLATFORM,
+                                            PLDM_SET_STATE_EFFECTER_STATES));
+    EXPECT_FALSE(ResponseCache::isCacheable(PLDM_OEM, PLDM_GET_PDR));
+
+    // Live readings, a poller may reuse the instance ID right away
+    EXPECT_FALSE(ResponseCache::isCacheable(PLDM_PLATFORM,
+                                            PLDM_GET_STATE_SENSOR_READINGS));
+    EXPECT_FALSE(ResponseCache::isCacheable(PLDM_PLATFORM,
+                                            PLDM_GET_NUMERIC_EFFECTER_VALUE));
+    EXPECT_FALSE(ResponseCache::isCacheable(
+        PLDM_BIOS, PLDM_GET_BIOS_ATTRIBUTE_CURRENT_VALUE_BY_HANDLE));
+}
+
+TEST_F(ResponseCacheTest, testReplay)
+{
+    ResponseCache cache(4, seconds(5));
+    auto request = makeRequest(1);
+    EXPECT_FALSE(cache.lookup(9, request));
+    cache.store(9, request, response);
+
+    auto cached = cache.lookup(9, request);
+    ASSERT_TRUE(cached);
+    EXPECT_EQ(*cached, response);
+
+    // Different EID, instance ID or payload is a new request
+    EXPECT_FALSE(cache.lookup(8, request));
+    EXPECT_FALSE(cache.lookup(9, makeRequest(2)));
+    EXPECT_FALSE(cache.lookup(9, makeRequest(1, 0x55)));
+
+    EXPECT_EQ(cache.getStats().hits, 1);
+    EXPECT_EQ(cache.getStats().misses, 4);
+}
+
+TEST_F(ResponseCacheTest, testErrorNotCached)
+{
+    ResponseCache cache(4, seconds(5));
+    auto request = makeRequest(1);
+    std::vector<uint8_t> errorResponse{0x01, PLDM_PLATFORM, PLDM_GET_PDR,
+                                       PLDM_ERROR_NOT_READY};
+    cache.store(9, request, errorResponse);
+    EXPECT_FALSE(cache.lookup(9, request));
+}
+
+TEST_F(ResponseCacheTest, testExpiry)
+{
+    ResponseCache cache(4, milliseconds(0));
+    auto request = makeRequest(1);
+    cache.store(9, request, response);
+    EXPECT_FALSE(cache.lookup(9, request));
+}
+
+TEST_F(ResponseCacheTest, testEviction)
+{
+    ResponseCache cache(2, seconds(5));
+    for (uint8_t id = 0; id < 3; ++id)
+    {
+        cache.store(9, makeRequest(id), response);
+    }
+    EXPECT_FALSE(cache.lookup(9, makeRequest(0)));
+    EXPECT_TRUE(cache.lookup(9, makeRequest(1)));
+    EXPECT_TRUE(cache.lookup(9, makeRequest(2)));
+}
+
+TEST_F(ResponseCacheTest, testDisabled)
+{
+    ResponseCache cache(0, seconds(5));
+    auto request = makeRequest(1);
+    cache.store(9, request, response);
+    EXPECT_FALSE(cache.lookup(9, request));
+}
+
+TEST_F(ResponseCacheTest, testFlush)
+{
+    ResponseCache cache(4, seconds(5));
+    auto request = makeRequest(1);
+    cache.store(9, request, response);
+
+    cache.flush(PLDM_BIOS);
+    EXPECT_TRUE(cache.lookup(9, request));
+
+    // The PDRs changed
+    cache.flush(PLDM_PLATFORM);
+    EXPECT_FALSE(cache.lookup(9, request));
+}
@@ -0,0 +1,104 @@
+#include "pldmd/rx_batch.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+
+class RxBatchTest : public testing::Test
+{
+  protected:
+    RxBatchTest()
+    {
+        socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds);
+    }
+
+    ~RxBatchTest()
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    void sendMsg(const std::vector<uint8_t>& msg)
+    {
+        ASSERT_EQ(send(fds[1], msg.data(), msg.size(), 0),
+                  static_cast<ssize_t>(msg.size()));
+    }
+
+    int fds[2] = {-1, -1};
+};
+
+TEST_F(RxBatchTest, testNothingPending)
+{
+    RxBatch rxBatch(4, 4096);
+    size_t count = 0;
+    auto rc = rxBatch.drain(fds[0],
+                            [&count](std::span<const uint8_t>) { ++count; });
+    EXPECT_EQ(rc, 0);
+    EXPECT_EQ(count, 0);
+    EXPECT_EQ(rxBatch.getStats().wakes, 0);
+}
+
+TEST_F(RxBatchTest, testDrainMoreThanBatch)
+{
+    RxBatch rxBatch(4, 4096);
+    for (uint8_t i = 0; i < 10; ++i)
+    {
+        sendMsg({8, 1, i, 0x02, 0x04});
+    }
+
+    std::vector<std::vector<uint8_t>> received;
+    auto rc = rxBatch.drain(fds[0], [&received](std::span<const uint8_t> msg) {
+        received.emplace_back(msg.begin(), msg.end());
+    });
+    ASSERT_EQ(rc, 10);
+    ASSERT_EQ(received.size(), 10);
+    for (uint8_t i = 0; i < 10; ++i)
+    {
+        std::vector<uint8_t> expected{8, 1, i, 0x02, 0x04};
+        EXPECT_EQ(received[i], expected);
+    }
+
+    const auto& stats = rxBatch.getStats();
+    EXPECT_EQ(stats.wakes, 1);
+    EXPECT_EQ(stats.messages, 10);
+    EXPECT_EQ(stats.maxPerWake, 10);
+    // 10 messages fall in the [8, 16) bucket
+    EXPECT_EQ(stats.perWake[3], 1);
+}
+
+TEST_F(RxBatchTest, testTruncatedMessageDropped)
+{
+    RxBatch rxBatch(2, 4096);
+    sendMsg(std::vector<uint8_t>(5000, 0xAA));
+    sendMsg({8, 1, 0x80, 0x00, 0x01});
+
+    std::vector<size_t> sizes;
+    auto rc = rxBatch.drain(fds[0], [&sizes](std::span<const uint8_t> msg) {
+        sizes.push_back(msg.size());
+    });
+    EXPECT_EQ(rc, 1);
+    ASSERT_EQ(sizes.size(), 1);
+    EXPECT_EQ(sizes[0], 5);
+    EXPECT_EQ(rxBatch.getStats().truncated, 1);
+}
+
+TEST_F(RxBatchTest, testPeerClosed)
+{
+    RxBatch rxBatch(4, 4096);
+    sendMsg({8, 1, 0x80, 0x00, 0x01});
+    close(fds[1]);
+    fds[1] = -1;
+
+    std::vector<size_t> sizes;
+    rxBatch.drain(fds[0], [&sizes](std::span<const uint8_t> msg) {
+        sizes.push_back(msg.size());
+    });
+    ASSERT_EQ(sizes.size(), 2);
+    EXPECT_EQ(sizes[0], 5);
+    EXPECT_EQ(sizes[1], 0);
+}